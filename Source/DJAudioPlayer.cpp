@@ -9,51 +9,250 @@
 */
 
 #include "DJAudioPlayer.h"
+#include <algorithm>
 
-DJAudioPlayer::DJAudioPlayer(juce::AudioFormatManager& _formatManager)
-    : formatManager(_formatManager)
+//==============================================================================
+class DJAudioPlayer::LoadJob : public JobScheduler::Job
 {
+public:
+    /** inputs: reference to the player being loaded (DJAudioPlayer&); URL to audio file to be loaded (juce::URL); length of the read-ahead buffer - in seconds (double); load generation this job belongs to (int); function to call once loaded (std::function<void(bool)>); seek index of the file, may be nullptr (std::shared_ptr<const SeekIndex>); hot cues, beat grid, loudness and cue in of the track (TrackSettings)
+     constructor - must be called on the message thread */
+    LoadJob(DJAudioPlayer& _player,
+            juce::URL _audioURL,
+            double _readAheadSeconds,
+            int _generation,
+            std::function<void(bool)> _onLoaded,
+            std::shared_ptr<const SeekIndex> _seekIndex,
+            TrackSettings _settings)
+        : JobScheduler::Job("Deck load"),
+        player(_player),
+        weakPlayer(&_player),
+        trackCache(_player.trackCache),
+        formatManager(_player.formatManager),
+        audioURL(_audioURL),
+        readAheadSeconds(_readAheadSeconds),
+        generation(_generation),
+        onLoaded(_onLoaded),
+        seekIndex(_seekIndex),
+        settings(_settings)
+    {
+    }
+
+    /** outputs: whether the job is done (JobScheduler::Job::JobStatus)
+     opens the file, then posts the prepared sources back to the message thread */
+    JobStatus runJob() override
+    {
+        // do the slow part - opening the stream and parsing headers - here
+        auto prepared = std::make_shared<PreparedSource>(player.prepareSource(audioURL, readAheadSeconds, seekIndex));
+        if (shouldExit())
+        {
+            // a newer load was issued while we were working, drop this one
+            return jobHasFinished;
+        }
+        bool needsDecoding = prepared->readAheadSource != nullptr && audioURL.isLocalFile();
+        {
+            // the deck keeps hold of the track until it is swapped in, in case the deck goes first
+            const juce::ScopedLock sl(player.pendingSwapsLock);
+            player.pendingSwaps.push_back(prepared);
+        }
+        // swap into the deck on the message thread, unless superseded or deleted by then
+        juce::WeakReference<DJAudioPlayer> playerRef = weakPlayer;
+        int gen = generation;
+        auto callback = onLoaded;
+        auto trackSettings = settings;
+        juce::MessageManager::callAsync([playerRef, gen, prepared, callback, trackSettings]
+        {
+            auto* target = playerRef.get();
+            if (target == nullptr)
+            {
+                return;
+            }
+            {
+                const juce::ScopedLock sl(target->pendingSwapsLock);
+                auto& pending = target->pendingSwaps;
+                pending.erase(std::remove(pending.begin(), pending.end(), prepared), pending.end());
+            }
+            if (gen != target->loadGeneration.load())
+            {
+                return;
+            }
+            bool loaded = prepared->getPlaybackSource() != nullptr;
+            if (loaded)
+            {
+                target->swapInSource(std::move(*prepared), trackSettings);
+            }
+            if (callback)
+            {
+                callback(loaded);
+            }
+        });
+        if (needsDecoding)
+        {
+            // deck is streaming this one from disk - decode it into the cache so the next load is instant.
+            // the deck is already playing, so this no longer needs to hold everything else back.
+            // only the cache and the format manager are used from here on, never the deck
+            setPriority(JobScheduler::Priority::visible);
+            trackCache.decodeAndStore(audioURL.getLocalFile(),
+                                      formatManager,
+                                      [this] { return shouldExit(); });
+        }
+        return jobHasFinished;
+    }
+
+private:
+    DJAudioPlayer& player;
+    juce::WeakReference<DJAudioPlayer> weakPlayer;
+    DecodedTrackCache& trackCache;
+    juce::AudioFormatManager& formatManager;
+    juce::URL audioURL;
+    double readAheadSeconds;
+    int generation;
+    std::function<void(bool)> onLoaded;
+    std::shared_ptr<const SeekIndex> seekIndex;
+    TrackSettings settings;
+};
+
+//==============================================================================
+
+DJAudioPlayer::DJAudioPlayer(juce::AudioFormatManager& _formatManager,
+                             DecodedTrackCache& _trackCache,
+                             JobScheduler& _scheduler,
+                             const MasterClock* _clock)
+    : formatManager(_formatManager),
+    trackCache(_trackCache),
+    scheduler(_scheduler),
+    clock(_clock)
+{
+    // start the deck's own disk reading thread so the audio thread never waits on i/o
+    readAheadThread.startThread(3);
 }
 
 DJAudioPlayer::~DJAudioPlayer()
 {
+    // cancel any pending load and wait for a running one to finish with us, however long it takes - it is told to stop, so it won't be long
+    auto stopped = scheduler.removeJobs(this, true, -1);
+    jassert (stopped);
+    juce::ignoreUnused (stopped);
+    // detach sources from transport before they are destroyed
+    transportSource.setSource(nullptr);
+    currentSource = PreparedSource();
+    // loads still waiting for the message thread free their sources now, while the read-ahead thread they are registered with is still here
+    {
+        const juce::ScopedLock sl(pendingSwapsLock);
+        for (auto& pending : pendingSwaps)
+        {
+            *pending = PreparedSource();
+        }
+        pendingSwaps.clear();
+    }
+    readAheadThread.stopThread(2000);
 }
 
 void DJAudioPlayer::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
 {
     // prepare transport source and resample source for playback
+    deviceSampleRate = sampleRate;
+    // half a second covers the longest tail in the chain - the stretcher's grains and the key shifter's delay line
+    idleTailSamples = static_cast<juce::int64>(sampleRate * 0.5);
     transportSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
     resampleSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    // create holder for high-pass filter specifications
+    keyLockStretcher.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    // create holder for key shifter, isolator and filter specifications
     juce::dsp::ProcessSpec spec;
-    // setup high-pass filter specifications
+    // setup key shifter, isolator and filter specifications
     spec.maximumBlockSize = samplesPerBlockExpected;
     spec.sampleRate = sampleRate;
     spec.numChannels = 2;
-    // assign high-pass filter specifications
+    // assign key shifter, isolator and filter specifications
+    keyShifter.prepare(spec);
+    isolator.prepare(spec);
     filter.prepare(spec);
-    // set type of filter to 'high-pass'
-    filter.setType(juce::dsp::StateVariableTPTFilterType::highpass);
     // reset filter to remove any junk in preperation for playback
     reset();
 }
 
 void DJAudioPlayer::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
 {
-    // pass incoming audio buffer to resample source
-    resampleSource.getNextAudioBlock(bufferToFill);
+    if (!renderNextBlock(bufferToFill))
+    {
+        // deck is idle, output silence
+        bufferToFill.clearActiveBufferRegion();
+        return;
+    }
+    // played on its own rather than through the deck engine's mixer - apply the channel fader here
+    auto gain = getChannelGain();
+    bufferToFill.buffer->applyGainRamp(bufferToFill.startSample, bufferToFill.numSamples, lastChannelGain, gain);
+    lastChannelGain = gain;
+}
+
+bool DJAudioPlayer::renderNextBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    // apply every control change made since the last block before rendering this one
+    applyPendingCommands();
+    auto blockStart = clock != nullptr ? blockClock.sampleTime : 0;
+    updateSync(blockStart);
+    // the key shifter's delay moves from grain to grain, so take it afresh each block
+    latencySamples = static_cast<juce::int64>(std::llround(getLatencySamples()));
+    // break the block where a scheduled start, stop or jump falls, so it happens on exactly that sample
+    bool rendered = false;
+    for (int done = 0; done < bufferToFill.numSamples; )
+    {
+        auto now = blockStart + done;
+        applyScheduledChanges(now);
+        auto numSamples = bufferToFill.numSamples - done;
+        auto next = getNextScheduledTime(now);
+        if (next > now)
+        {
+            numSamples = static_cast<int>(juce::jmin(static_cast<juce::int64>(numSamples), next - now));
+        }
+        juce::AudioSourceChannelInfo segment(bufferToFill.buffer, bufferToFill.startSample + done, numSamples);
+        if (renderSegment(segment))
+        {
+            rendered = true;
+        }
+        else if (numSamples < bufferToFill.numSamples) {
+            // idle for only part of the block - the rest has been rendered, so silence this part
+            segment.clearActiveBufferRegion();
+        }
+        done += numSamples;
+    }
+    return rendered;
+}
+
+bool DJAudioPlayer::renderSegment(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    if (playGate.isOpen())
+    {
+        samplesSinceStopped = 0;
+    }
+    else if (samplesSinceStopped >= idleTailSamples) {
+        // stopped long enough for every stage's tail to have died away - nothing to render,
+        // but loop and cue actions still land at the stopped playhead now rather than wherever playback next starts
+        playGate.readEmptyBlock(*bufferToFill.buffer);
+        return false;
+    }
+    else {
+        samplesSinceStopped += bufferToFill.numSamples;
+    }
+    // pass incoming audio buffer through the resampler and key-lock stretcher
+    keyLockStretcher.getNextAudioBlock(bufferToFill);
     // Adapted from code provided by Xenakios on 'The Audio Programmer' Discord channel on 2021-02-02 23:59 GMT
     // https://discord.com/channels/382895736356077570/382895736863457281/806305801768665109
-    // convert juce AudioSourceChannelInfo buffer to juce AudioBlock buffer for funneling to high-pass filter
+    // convert juce AudioSourceChannelInfo buffer to juce AudioBlock buffer for funneling to the key shifter, isolator and filter
     juce::dsp::AudioBlock<float> audioBlock(bufferToFill.buffer->getArrayOfWritePointers(),
                                        bufferToFill.buffer->getNumChannels(),
                                        bufferToFill.startSample,
                                        bufferToFill.numSamples);
     // End adapted code
-    // replace the audio buffer with the filtered version
+    // replace the audio buffer with the shifted, equalised and filtered version
     auto context = juce::dsp::ProcessContextReplacing<float> (audioBlock);
-    // process audio buffer with high-pass filter
+    // move the key, if it has been shifted
+    keyShifter.process(context);
+    // apply the isolator EQ
+    isolator.process(context);
+    // process audio buffer with the low/high-pass filter
     filter.process(context);
+    return true;
 }
 
 void DJAudioPlayer::releaseResources()
@@ -61,18 +260,178 @@ void DJAudioPlayer::releaseResources()
     // release resources from sources
     transportSource.releaseResources();
     resampleSource.releaseResources();
+    keyLockStretcher.releaseResources();
 }
 
-void DJAudioPlayer::loadURL(juce::URL audioURL)
+void DJAudioPlayer::loadURL(juce::URL audioURL, TrackSettings settings)
 {
+    // supersede any asynchronous load still in flight
+    ++loadGeneration;
+    scheduler.removeJobs(this, true, 0);
     // load file into sources for playback
-    auto* reader = formatManager.createReaderFor(audioURL.createInputStream(false));
+    auto prepared = prepareSource(audioURL, readAheadTime, nullptr);
+    if (prepared.getPlaybackSource() != nullptr) // good file!
+    {
+        swapInSource(std::move(prepared), settings);
+    }
+}
+
+void DJAudioPlayer::loadURLAsync(juce::URL audioURL, std::function<void(bool)> onLoaded, std::shared_ptr<const SeekIndex> seekIndex, TrackSettings settings)
+{
+    // cancel whatever this deck was loading and queue the new file
+    int generation = ++loadGeneration;
+    scheduler.removeJobs(this, true, 0);
+    scheduler.addJob(new LoadJob(*this, audioURL, readAheadTime, generation, onLoaded, seekIndex, settings),
+                     JobScheduler::Priority::deckCritical,
+                     this);
+}
+
+juce::URL DJAudioPlayer::getLoadedURL() const
+{
+    return currentSource.url;
+}
+
+DJAudioPlayer::PreparedSource DJAudioPlayer::prepareSource(juce::URL audioURL, double readAheadSeconds, std::shared_ptr<const SeekIndex> seekIndex)
+{
+    PreparedSource prepared;
+    prepared.url = audioURL;
+    if (audioURL.isLocalFile())
+    {
+        // already decoded by this or another deck - play straight from RAM
+        if (auto decoded = trackCache.lookup(audioURL.getLocalFile()))
+        {
+            prepared.sampleRate = decoded->sampleRate;
+            prepared.decodedSource.reset(new DecodedTrackAudioSource(decoded));
+            // loops copy out of the same decoded audio
+            addLoopSource(prepared, std::make_unique<DecodedTrackAudioSource>(decoded));
+            return prepared;
+        }
+    }
+    // uncompressed - map the file and play from the mapping, nothing to read up front or decode
+    if (auto mappedReader = MappedAudioSource::createMappedReader(audioURL, formatManager))
+    {
+        prepared.sampleRate = mappedReader->sampleRate;
+        prepared.mappedSource.reset(new MappedAudioSource(std::move(mappedReader),
+                                                          readAheadThread,
+                                                          static_cast<int>(readAheadSeconds * prepared.sampleRate)));
+        // loops copy out of a second mapping of the file - the pages are shared, so it costs next to nothing
+        std::unique_ptr<juce::PositionableAudioSource> preloadSource;
+        if (auto preloadReader = MappedAudioSource::createMappedReader(audioURL, formatManager))
+        {
+            preloadSource = std::make_unique<juce::AudioFormatReaderSource>(preloadReader.release(), true);
+        }
+        addLoopSource(prepared, std::move(preloadSource));
+        return prepared;
+    }
+    auto* reader = createReader(audioURL, seekIndex);
     if (reader != nullptr) // good file!
     {
-        std::unique_ptr<juce::AudioFormatReaderSource> newSource(new juce::AudioFormatReaderSource(reader, true));
-        transportSource.setSource(newSource.get(), 0, nullptr, reader->sampleRate);
-        readerSource.reset(newSource.release());
+        prepared.sampleRate = reader->sampleRate;
+        // stream the file through the deck's read-ahead buffer, filled on the background thread
+        int samplesToBuffer = static_cast<int>(readAheadSeconds * reader->sampleRate);
+        prepared.readAheadSource.reset(new ReadAheadAudioSource(new juce::AudioFormatReaderSource(reader, true),
+                                                                true,
+                                                                readAheadThread,
+                                                                samplesToBuffer));
+        // loops are decoded by a reader of their own, so filling the loop buffer never moves the read-ahead buffer
+        std::unique_ptr<juce::PositionableAudioSource> preloadSource;
+        if (auto* preloadReader = createReader(audioURL, seekIndex))
+        {
+            preloadSource = std::make_unique<juce::AudioFormatReaderSource>(preloadReader, true);
+        }
+        addLoopSource(prepared, std::move(preloadSource));
     }
+    return prepared;
+}
+
+void DJAudioPlayer::addLoopSource(PreparedSource& prepared, std::unique_ptr<juce::PositionableAudioSource> preloadSource)
+{
+    // the loop engine sits between the track's source and the transport, and copies loops into RAM on the deck's background thread
+    prepared.loopSource.reset(new LoopingAudioSource(prepared.getTrackSource(),
+                                                     std::move(preloadSource),
+                                                     readAheadThread,
+                                                     prepared.sampleRate));
+}
+
+juce::AudioFormatReader* DJAudioPlayer::createReader(juce::URL audioURL, std::shared_ptr<const SeekIndex> seekIndex)
+{
+    if (seekIndex != nullptr && audioURL.isLocalFile())
+    {
+        // indexed - seeks go straight to a frame near the target instead of making the decoder scan for it
+        auto file = audioURL.getLocalFile();
+        if (auto* format = formatManager.findFormatForFileExtension(file.getFileExtension()))
+        {
+            if (auto indexedReader = SeekIndexedReader::create(file, *format, seekIndex))
+            {
+                return indexedReader.release();
+            }
+        }
+    }
+    return formatManager.createReaderFor(audioURL.createInputStream(false));
+}
+
+void DJAudioPlayer::swapInSource(PreparedSource&& prepared, const TrackSettings& settings)
+{
+    // the new track's cues go in before the audio thread can see it, so they are copied into RAM while it is still cued up
+    hotCues.clearQuick();
+    juce::Array<juce::int64> cuePositions;
+    for (int cue = 0; cue < numHotCues; ++cue)
+    {
+        auto seconds = cue < settings.hotCues.size() ? settings.hotCues[cue] : -1.0;
+        hotCues.add(seconds);
+        cuePositions.add(seconds >= 0.0 ? std::llround(seconds * prepared.sampleRate) : -1);
+    }
+    if (prepared.loopSource != nullptr)
+    {
+        prepared.loopSource->loadHotCues(cuePositions);
+    }
+    // start on the first sound rather than the silence before it - set before the transport prepares the source, so the read-ahead buffer starts filling there
+    if (settings.cueIn > 0.0)
+    {
+        auto cueInPosition = std::llround(settings.cueIn * prepared.sampleRate);
+        prepared.getTrackSource()->setNextReadPosition(cueInPosition);
+        prepared.getPlaybackSource()->setNextReadPosition(cueInPosition);
+    }
+    // a new track starts stopped - queued first, so no block plays the new track before the stop is seen
+    commandQueue.push({DeckCommandQueue::CommandType::stop});
+    // transport swaps sources under its callback lock, so the audio thread sees old or new, never half of each.
+    // no rate to correct for is passed, the deck's resampler does the sample rate conversion along with the speed change
+    transportSource.setSource(prepared.getPlaybackSource(), 0, nullptr, 0.0);
+    sourceSampleRate = prepared.sampleRate;
+    // old sources are detached now and safe to free - the loop engine first, as it reads from the others
+    currentSource.loopSource.reset();
+    currentSource = std::move(prepared);
+    keepTransportRunning();
+    // loops and sync follow the new track's beat grid from its first block
+    trackBPM = settings.bpm > 0.0 ? settings.bpm : 120.0;
+    firstBeatSeconds = settings.bpm > 0.0 ? settings.firstBeat : 0.0;
+    commandQueue.push({DeckCommandQueue::CommandType::beatGrid, trackBPM, firstBeatSeconds});
+    // and at its own level, matched to every other track
+    setLoudness(settings.loudness, settings.truePeak);
+    // the new track carries on in the direction the deck was going
+    updateDirection();
+}
+
+juce::PositionableAudioSource* DJAudioPlayer::PreparedSource::getPlaybackSource() const
+{
+    if (loopSource != nullptr)
+    {
+        return loopSource.get();
+    }
+    return getTrackSource();
+}
+
+juce::PositionableAudioSource* DJAudioPlayer::PreparedSource::getTrackSource() const
+{
+    if (decodedSource != nullptr)
+    {
+        return decodedSource.get();
+    }
+    if (mappedSource != nullptr)
+    {
+        return mappedSource.get();
+    }
+    return readAheadSource.get();
 }
 
 void DJAudioPlayer::setGain(double gain)
@@ -83,26 +442,78 @@ void DJAudioPlayer::setGain(double gain)
         DBG("DJAudioPlayer::setGain gain should be between 0 and 1");
     }
     else {
-        transportSource.setGain(gain);
+        commandQueue.push({DeckCommandQueue::CommandType::gain, gain});
     }
 }
 
 void DJAudioPlayer::setSpeed(double ratio)
 {
     // setter for playback speed
-    if (ratio < 0.0 || ratio > 100.0)
+    if (ratio < -100.0 || ratio > 100.0)
     {
-        DBG("DJAudioPlayer::setSpeed ratio should be between 0 and 100");
+        DBG("DJAudioPlayer::setSpeed ratio should be between -100 and 100");
     }
     else {
-        resampleSource.setResamplingRatio(ratio);
+        requestedSpeed = ratio;
+        updateDirection();
+        commandQueue.push({DeckCommandQueue::CommandType::speed, ratio});
+    }
+}
+
+void DJAudioPlayer::setScratching(bool shouldScratch)
+{
+    // setter for scratch mode
+    requestedScratching = shouldScratch;
+    updateDirection();
+    commandQueue.push({DeckCommandQueue::CommandType::scratch, shouldScratch ? 1.0 : 0.0});
+}
+
+void DJAudioPlayer::setScratchRate(double rate)
+{
+    // setter for scratch rate
+    requestedScratchRate = juce::jlimit(-maxScratchRate, maxScratchRate, rate);
+    updateDirection();
+    commandQueue.push({DeckCommandQueue::CommandType::scratchRate, requestedScratchRate});
+}
+
+void DJAudioPlayer::updateDirection()
+{
+    if (currentSource.loopSource == nullptr)
+    {
+        return;
     }
+    auto rate = requestedScratching ? requestedScratchRate : requestedSpeed;
+    currentSource.loopSource->setScratching(requestedScratching);
+    currentSource.loopSource->setReverse(rate < 0.0);
+}
+
+void DJAudioPlayer::keepTransportRunning()
+{
+    // the transport is only ever started here, on the message thread - stopping it would wait on the audio thread, so the gate does that instead
+    if (currentSource.getPlaybackSource() != nullptr && !transportSource.isPlaying())
+    {
+        transportSource.start();
+    }
+}
+
+void DJAudioPlayer::setKeyLock(bool shouldBeLocked)
+{
+    // setter for key-lock
+    commandQueue.push({DeckCommandQueue::CommandType::keyLock, shouldBeLocked ? 1.0 : 0.0});
+}
+
+void DJAudioPlayer::setKeyShift(int semitones, double cents)
+{
+    // setter for key shift - cents ride along as the fractional part of the semitones
+    auto shift = juce::jlimit(-12.0, 12.0, semitones + cents / 100.0);
+    commandQueue.push({DeckCommandQueue::CommandType::keyShift, shift});
 }
 
 void DJAudioPlayer::setPosition(double posInSecs)
 {
-    // setter for play head position
-    transportSource.setPosition(posInSecs);
+    // setter for play head position - a track that has played to its end can be cued again
+    keepTransportRunning();
+    commandQueue.push({DeckCommandQueue::CommandType::position, posInSecs});
 }
 
 void DJAudioPlayer::setPositionRelative(double pos)
@@ -113,7 +524,7 @@ void DJAudioPlayer::setPositionRelative(double pos)
         DBG("DJAudioPlayer::setPositionRelative pos should be between 0 and 1");
     }
     else {
-        double posInSecs = transportSource.getLengthInSeconds() * pos;
+        double posInSecs = getLengthInSeconds() * pos;
         setPosition(posInSecs);
     }
 }
@@ -121,30 +532,560 @@ void DJAudioPlayer::setPositionRelative(double pos)
 void DJAudioPlayer::start()
 {
     // start audio playback
-    transportSource.start();
+    keepTransportRunning();
+    commandQueue.push({DeckCommandQueue::CommandType::start, 0.0, 0.0, -1, quantize});
 }
 
 void DJAudioPlayer::stop()
 {
     // stop audio playback
-    transportSource.stop();
+    commandQueue.push({DeckCommandQueue::CommandType::stop, 0.0, 0.0, -1, quantize});
+}
+
+void DJAudioPlayer::startAt(juce::int64 sampleTime)
+{
+    // start audio playback on a given sample
+    keepTransportRunning();
+    commandQueue.push({DeckCommandQueue::CommandType::start, 0.0, 0.0, juce::jmax(static_cast<juce::int64>(0), sampleTime)});
+}
+
+void DJAudioPlayer::stopAt(juce::int64 sampleTime)
+{
+    // stop audio playback on a given sample
+    commandQueue.push({DeckCommandQueue::CommandType::stop, 0.0, 0.0, juce::jmax(static_cast<juce::int64>(0), sampleTime)});
+}
+
+void DJAudioPlayer::setPositionAt(double posInSecs, juce::int64 sampleTime)
+{
+    // move the play head on a given sample
+    keepTransportRunning();
+    commandQueue.push({DeckCommandQueue::CommandType::position, posInSecs, 0.0, juce::jmax(static_cast<juce::int64>(0), sampleTime)});
+}
+
+void DJAudioPlayer::setQuantize(MasterClock::Quantize newQuantize)
+{
+    // setter for quantising
+    quantize = newQuantize;
+}
+
+float DJAudioPlayer::getChannelGain() const
+{
+    return channelGain * trimGain;
+}
+
+void DJAudioPlayer::setClockPosition(const MasterClock::Position& position)
+{
+    blockClock = position;
 }
 
 double DJAudioPlayer::getPositionRelative() const
 {
     // return the relative position of the current moment in playback
-    return transportSource.getCurrentPosition() / transportSource.getLengthInSeconds();
+    auto length = transportSource.getTotalLength();
+    if (length <= 0)
+    {
+        return 0.0;
+    }
+    return static_cast<double>(transportSource.getNextReadPosition()) / length;
+}
+
+void DJAudioPlayer::updateFilter(float position, float res)
+{
+    // update low/high-pass filter on user input
+    commandQueue.push({DeckCommandQueue::CommandType::filter, position, res});
+}
+
+void DJAudioPlayer::setEQGain(IsolatorEQ::Band band, float decibels)
+{
+    // setter for isolator band - anything at or below the kill level is silenced completely
+    auto gain = juce::Decibels::decibelsToGain(decibels, eqKillDecibels);
+    commandQueue.push({DeckCommandQueue::CommandType::eqGain, static_cast<double>(band), gain});
+}
+
+void DJAudioPlayer::setReadAheadTime(double seconds)
+{
+    // setter for read-ahead buffer length
+    if (seconds < 0.1 || seconds > 60.0)
+    {
+        DBG("DJAudioPlayer::setReadAheadTime seconds should be between 0.1 and 60");
+    }
+    else {
+        readAheadTime = seconds;
+    }
+}
+
+int DJAudioPlayer::getReadAheadUnderruns() const
+{
+    // return the number of dropouts since the current track was loaded
+    return currentSource.readAheadSource != nullptr ? currentSource.readAheadSource->getNumUnderruns() : 0;
+}
+
+float DJAudioPlayer::getReadAheadFillLevel() const
+{
+    // return how much audio is currently buffered ahead of the playhead
+    // tracks playing from the decoded track cache or mapped into memory are always fully buffered
+    if (currentSource.decodedSource != nullptr || currentSource.mappedSource != nullptr)
+    {
+        return 1.0f;
+    }
+    return currentSource.readAheadSource != nullptr ? currentSource.readAheadSource->getFillLevel() : 0.0f;
+}
+
+void DJAudioPlayer::setResamplingQuality(PolyphaseResampler::Quality quality)
+{
+    // setter for resampling quality
+    resampleSource.setQuality(quality);
+}
+
+double DJAudioPlayer::getResamplerNanosPerSample() const
+{
+    // return the measured cost of resampling on this machine
+    return resampleSource.getMeasuredNanosPerSample();
+}
+
+void DJAudioPlayer::setBPM(double bpm)
+{
+    // setter for the track's tempo
+    if (bpm < 20.0 || bpm > 400.0)
+    {
+        DBG("DJAudioPlayer::setBPM bpm should be between 20 and 400");
+    }
+    else {
+        trackBPM = bpm;
+        commandQueue.push({DeckCommandQueue::CommandType::beatGrid, trackBPM, firstBeatSeconds});
+    }
+}
+
+void DJAudioPlayer::setFirstBeat(double seconds)
+{
+    // setter for the start of the beat grid
+    firstBeatSeconds = juce::jmax(0.0, seconds);
+    commandQueue.push({DeckCommandQueue::CommandType::beatGrid, trackBPM, firstBeatSeconds});
+}
+
+void DJAudioPlayer::setLoudness(double loudness, double truePeak)
+{
+    // setter for the loudness trim
+    if (loudness >= 0.0)
+    {
+        // not analysed - play the track as it is
+        trimDecibels = 0.0;
+    }
+    else {
+        auto trim = targetLoudness - loudness;
+        if (trim > 0.0)
+        {
+            // quiet tracks are only turned up as far as their peaks allow, as nothing after the deck would stop them clipping
+            trim = juce::jmin(trim, juce::jmax(0.0, truePeakCeiling - truePeak));
+        }
+        trimDecibels = juce::jlimit(-maxTrimDecibels, maxTrimDecibels, trim);
+    }
+    commandQueue.push({DeckCommandQueue::CommandType::trim, juce::Decibels::decibelsToGain(trimDecibels)});
+}
+
+double DJAudioPlayer::getTrimDecibels() const
+{
+    return trimDecibels;
+}
+
+void DJAudioPlayer::setSync(bool shouldSync)
+{
+    // setter for sync
+    requestedSync = shouldSync;
+    commandQueue.push({DeckCommandQueue::CommandType::sync, shouldSync ? 1.0 : 0.0});
+}
+
+bool DJAudioPlayer::isSynced() const
+{
+    return requestedSync;
+}
+
+double DJAudioPlayer::getPhaseErrorMs() const
+{
+    return phaseErrorMs.load();
+}
+
+void DJAudioPlayer::loopIn()
+{
+    if (currentSource.loopSource != nullptr)
+    {
+        currentSource.loopSource->setLoopIn();
+    }
+}
+
+void DJAudioPlayer::loopOut()
+{
+    if (currentSource.loopSource != nullptr)
+    {
+        currentSource.loopSource->setLoopOut();
+    }
+}
+
+void DJAudioPlayer::setAutoLoop(double beats)
+{
+    if (currentSource.loopSource != nullptr)
+    {
+        currentSource.loopSource->setAutoLoop(beatsToSamples(beats));
+    }
+}
+
+void DJAudioPlayer::halveLoop()
+{
+    if (currentSource.loopSource != nullptr)
+    {
+        currentSource.loopSource->halveLoop();
+    }
+}
+
+void DJAudioPlayer::doubleLoop()
+{
+    if (currentSource.loopSource != nullptr)
+    {
+        currentSource.loopSource->doubleLoop();
+    }
+}
+
+void DJAudioPlayer::exitLoop()
+{
+    if (currentSource.loopSource != nullptr)
+    {
+        currentSource.loopSource->exitLoop();
+    }
+}
+
+void DJAudioPlayer::startLoopRoll(double beats)
+{
+    if (currentSource.loopSource != nullptr)
+    {
+        currentSource.loopSource->startLoopRoll(beatsToSamples(beats));
+    }
+}
+
+void DJAudioPlayer::stopLoopRoll()
+{
+    if (currentSource.loopSource != nullptr)
+    {
+        currentSource.loopSource->stopLoopRoll();
+    }
+}
+
+bool DJAudioPlayer::isLoopActive() const
+{
+    return currentSource.loopSource != nullptr && currentSource.loopSource->isLoopActive();
+}
+
+double DJAudioPlayer::setHotCue(int index)
+{
+    auto rate = sourceSampleRate.load();
+    if (currentSource.loopSource == nullptr || rate <= 0.0 || index < 0 || index >= numHotCues)
+    {
+        return -1.0;
+    }
+    // the playhead as of the last block - close enough to the press, and it is what was heard
+    auto position = currentSource.loopSource->getNextReadPosition();
+    currentSource.loopSource->setHotCue(index, position);
+    hotCues.set(index, position / rate);
+    return position / rate;
+}
+
+void DJAudioPlayer::clearHotCue(int index)
+{
+    if (currentSource.loopSource == nullptr || index < 0 || index >= numHotCues)
+    {
+        return;
+    }
+    currentSource.loopSource->setHotCue(index, -1);
+    hotCues.set(index, -1.0);
+}
+
+void DJAudioPlayer::jumpToHotCue(int index)
+{
+    auto seconds = getHotCue(index);
+    if (currentSource.loopSource == nullptr || seconds < 0.0)
+    {
+        return;
+    }
+    if (quantize != MasterClock::Quantize::none && playGate.isOpen())
+    {
+        // wait for the beat - a jump that lands on a cue plays from the cue's RAM all the same
+        commandQueue.push({DeckCommandQueue::CommandType::position, seconds, 0.0, -1, quantize});
+        return;
+    }
+    // a stopped deck takes the jump on its next block too - so it is never left queued to override a later seek.
+    // a track that has played to its end needs its transport running again for that
+    keepTransportRunning();
+    currentSource.loopSource->jumpToHotCue(index);
+}
+
+double DJAudioPlayer::getHotCue(int index) const
+{
+    if (index < 0 || index >= hotCues.size())
+    {
+        return -1.0;
+    }
+    return hotCues[index];
+}
+
+void DJAudioPlayer::applyPendingCommands()
+{
+    // only the latest value of each control is applied, however many changes queued up
+    auto changes = commandQueue.drain();
+    if (changes.hasGain)
+    {
+        // the channel fader is applied by whoever mixes the deck, smoothed there
+        channelGain = static_cast<float>(changes.gain);
+    }
+    if (changes.hasSpeed)
+    {
+        speed = changes.speed;
+    }
+    if (changes.hasScratch)
+    {
+        scratching = changes.scratching;
+    }
+    if (changes.hasScratchRate)
+    {
+        scratchRate = changes.scratchRate;
+    }
+    if (changes.hasKeyLock)
+    {
+        keyLock = changes.keyLock;
+    }
+    if (changes.hasKeyLock || changes.hasScratch)
+    {
+        // scratching changes the pitch like a record does, whatever the key-lock setting
+        keyLockStretcher.setEnabled(keyLock && !scratching);
+    }
+    if (changes.hasKeyShift)
+    {
+        keyShifter.setShift(changes.keyShift);
+    }
+    // one ratio covers both the file to device rate conversion and the speed change
+    updateResamplingRatio();
+    if (changes.hasPosition)
+    {
+        // transport runs at the file's own rate, so positions are in file samples
+        seekTransport(std::llround(changes.position * sourceSampleRate.load()));
+    }
+    // timed and quantised changes wait for their sample, an immediate one cancels whatever was waiting
+    if (changes.cancelScheduledTransport)
+    {
+        scheduledTransport = {};
+    }
+    if (changes.scheduledTransport.pending)
+    {
+        scheduledTransport = resolveTime(changes.scheduledTransport);
+    }
+    if (changes.cancelScheduledPosition)
+    {
+        scheduledPosition = {};
+    }
+    if (changes.scheduledPosition.pending)
+    {
+        scheduledPosition = resolveTime(changes.scheduledPosition);
+    }
+    for (int band = 0; band < 3; ++band)
+    {
+        if (changes.hasEQGain[band])
+        {
+            isolator.setBandGain(static_cast<IsolatorEQ::Band>(band), changes.eqGain[band]);
+        }
+    }
+    if (changes.hasFilter)
+    {
+        filter.setPosition(changes.filterPosition);
+        filter.setResonance(changes.resonance);
+    }
+    if (changes.hasSync)
+    {
+        syncEnabled = changes.sync;
+    }
+    if (changes.hasTrim)
+    {
+        // applied alongside the channel fader, and smoothed with it
+        trimGain = changes.trim;
+    }
+    if (changes.hasBeatGrid)
+    {
+        syncBPM = changes.bpm;
+        syncFirstBeat = changes.firstBeat;
+        // the same position is a different phase on the new grid
+        needsPhaseSnap = true;
+    }
+    if (changes.hasTransportChange)
+    {
+        // the gate starts and stops the deck here on the audio thread, the transport's own start and stop would wait on it
+        playGate.setOpen(changes.shouldPlay);
+    }
+}
+
+DeckCommandQueue::ScheduledChange DJAudioPlayer::resolveTime(const DeckCommandQueue::ScheduledChange& change) const
+{
+    auto resolved = change;
+    if (clock == nullptr)
+    {
+        // nothing to time against - act straight away
+        resolved.time = 0;
+    }
+    else if (change.quantize != MasterClock::Quantize::none) {
+        resolved.time = blockClock.getNextQuantizedTime(change.quantize);
+    }
+    resolved.quantize = MasterClock::Quantize::none;
+    return resolved;
+}
+
+void DJAudioPlayer::applyScheduledChanges(juce::int64 now)
+{
+    // each change is made a latency early, so it is heard on its sample.
+    // jump first, so a start due on the same sample plays from the new position
+    if (scheduledPosition.pending && scheduledPosition.time - latencySamples <= now)
+    {
+        seekTransport(std::llround(scheduledPosition.value * sourceSampleRate.load()));
+        scheduledPosition = {};
+    }
+    if (scheduledTransport.pending && scheduledTransport.time - latencySamples <= now)
+    {
+        playGate.setOpen(scheduledTransport.value != 0.0);
+        scheduledTransport = {};
+    }
+}
+
+juce::int64 DJAudioPlayer::getNextScheduledTime(juce::int64 now) const
+{
+    juce::int64 next = -1;
+    for (const auto* change : {&scheduledTransport, &scheduledPosition})
+    {
+        auto due = change->time - latencySamples;
+        if (change->pending && due > now && (next < 0 || due < next))
+        {
+            next = due;
+        }
+    }
+    return next;
+}
+
+double DJAudioPlayer::getLatencySamples() const
+{
+    // each stage reports its delay in its own output samples - the resampler's go through the stretcher at its tempo on the way out
+    return resampleSource.getLatencySamples() / keyLockStretcher.getTempoRatio()
+           + keyLockStretcher.getLatencySamples()
+           + keyShifter.getLatencySamples();
+}
+
+void DJAudioPlayer::updateSync(juce::int64 now)
+{
+    auto fileRate = sourceSampleRate.load();
+    auto outputSamplesPerBeat = clock != nullptr ? blockClock.samplesPerBeat : 0.0;
+    // sync only holds a deck playing forwards under its own steam
+    auto locked = syncEnabled && outputSamplesPerBeat > 0.0 && playGate.isOpen() && !scratching && speed > 0.0
+                  && fileRate > 0.0 && deviceSampleRate > 0.0;
+    if (!locked)
+    {
+        if (syncRate != 0.0)
+        {
+            // back to the speed control
+            syncRate = 0.0;
+            updateResamplingRatio();
+        }
+        phaseErrorMs.store(0.0);
+        needsPhaseSnap = true;
+        return;
+    }
+
+    // the track position of the next sample heard - what has been read, less the whole chain's delay back in track samples.
+    // an output sample stands for the stretcher's tempo in its samples, each of which is the resampling ratio in track samples
+    auto trackSamplesPerOutputSample = resampleSource.getResamplingRatio() * keyLockStretcher.getTempoRatio();
+    auto heard = static_cast<double>(transportSource.getNextReadPosition()) - getLatencySamples() * trackSamplesPerOutputSample;
+    auto fileSamplesPerBeat = fileRate * 60.0 / syncBPM;
+    auto deckBeat = (heard - syncFirstBeat * fileRate) / fileSamplesPerBeat;
+    // beats ahead of the clock, measured to the nearest beat either way
+    auto error = deckBeat - blockClock.getBeatPosition(now);
+    error -= std::round(error);
+    auto change = error - lastPhaseError;
+    change -= std::round(change);
+    lastPhaseError = error;
+    if (std::abs(change) > phaseJumpBeats)
+    {
+        // the playhead has jumped - a hot cue, a loop exit, a seek
+        needsPhaseSnap = true;
+    }
+    if (needsPhaseSnap)
+    {
+        needsPhaseSnap = false;
+        if (std::abs(error * outputSamplesPerBeat) > phaseSnapSeconds * deviceSampleRate)
+        {
+            // too far out to nudge in unheard - seek by whole samples and leave the fraction for the nudge
+            auto jump = std::llround(error * fileSamplesPerBeat);
+            seekTransport(transportSource.getNextReadPosition() - jump);
+            error -= jump / fileSamplesPerBeat;
+            lastPhaseError = error;
+        }
+        smoothedPhaseError = error;
+    }
+    else {
+        smoothedPhaseError += phaseErrorSmoothing * (error - smoothedPhaseError);
+    }
+    auto errorSamples = smoothedPhaseError * outputSamplesPerBeat;
+    phaseErrorMs.store(errorSamples * 1000.0 / deviceSampleRate);
+
+    // play at the tempo the clock is laid out at, sped up or slowed down a touch to pull the error in over the correction time
+    auto clockTempo = 60.0 * deviceSampleRate / outputSamplesPerBeat;
+    auto nudge = juce::jlimit(-maxSyncNudge, maxSyncNudge, -errorSamples / (syncCorrectionSeconds * deviceSampleRate));
+    syncRate = juce::jmin(TimeStretcher::maxTempoRatio, clockTempo / syncBPM * (1.0 + nudge));
+    updateResamplingRatio();
+}
+
+void DJAudioPlayer::updateResamplingRatio()
+{
+    // file samples consumed per device sample, e.g. 44.1kHz on a 48kHz device at 1x speed is 0.91875
+    auto fileRate = sourceSampleRate.load();
+    auto rateConversion = (fileRate > 0.0 && deviceSampleRate > 0.0) ? fileRate / deviceSampleRate : 1.0;
+    // the playhead itself plays backwards when the rate is negative, so the resampler only ever sees how fast
+    auto rate = std::abs(scratching ? scratchRate : speed);
+    if (syncRate > 0.0)
+    {
+        // locked to the master clock
+        rate = syncRate;
+    }
+    if (keyLock && !scratching)
+    {
+        // the stretcher changes the tempo without touching the pitch as far as it can, the resampler converts the rate and takes up whatever speed is left -
+        // so a deck slowed to a stop still stops, rather than crawling at the stretcher's slowest
+        auto tempo = juce::jlimit(TimeStretcher::minTempoRatio, TimeStretcher::maxTempoRatio, rate);
+        resampleSource.setResamplingRatio(rateConversion * rate / tempo);
+        keyLockStretcher.setTempoRatio(tempo);
+    }
+    else {
+        resampleSource.setResamplingRatio(rateConversion * rate);
+    }
+}
+
+void DJAudioPlayer::seekTransport(juce::int64 position)
+{
+    transportSource.setNextReadPosition(position);
+    // audio already pulled through from before the jump would otherwise play out first, and the stretcher would search it for a grain to follow on from
+    resampleSource.flushBuffers();
+    keyLockStretcher.flushBuffers();
+}
+
+double DJAudioPlayer::getLengthInSeconds() const
+{
+    // transport runs at the file's own rate, so its length is in file samples
+    auto fileRate = sourceSampleRate.load();
+    return fileRate > 0.0 ? transportSource.getTotalLength() / fileRate : 0.0;
 }
 
-void DJAudioPlayer::updateFilter(float freq, float res)
+juce::int64 DJAudioPlayer::beatsToSamples(double beats) const
 {
-    // update high-pass filter on user input
-    filter.setCutoffFrequency(freq);
-    filter.setResonance(res);
+    // loop points are in the track's own samples, so the length is too - speed changes stretch the loop along with the track
+    auto clampedBeats = juce::jlimit(minLoopBeats, maxLoopBeats, beats);
+    return static_cast<juce::int64>(std::round(clampedBeats * 60.0 / trackBPM * sourceSampleRate.load()));
 }
 
 void DJAudioPlayer::reset()
 {
-    // clear junk data out of filter
+    // clear junk data out of key shifter, isolator and filter
+    keyShifter.reset();
+    isolator.reset();
     filter.reset();
 }
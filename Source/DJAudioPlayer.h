@@ -11,13 +11,52 @@
 #pragma once
 
 #include "JuceHeader.h"
+#include "ReadAheadAudioSource.h"
+#include "DecodedTrackCache.h"
+#include "DecodedTrackAudioSource.h"
+#include "MappedAudioSource.h"
+#include "SeekIndexedReader.h"
+#include "LoopingAudioSource.h"
+#include "PlaybackGate.h"
+#include "DeckCommandQueue.h"
+#include "MasterClock.h"
+#include "JobScheduler.h"
+#include "PolyphaseResampler.h"
+#include "TimeStretcher.h"
+#include "PitchShifter.h"
+#include "DJFilter.h"
+#include "IsolatorEQ.h"
+#include <functional>
+#include <memory>
+#include <vector>
+#include <atomic>
 
 class DJAudioPlayer :   public juce::AudioSource
 {
 public:
-    /** inputs: reference to the audio format manager (juce::AudioFormatManager&)
+    /** what the library knows about a track, handed to the deck along with it */
+    struct TrackSettings
+    {
+        /** hot cues, -1 for those not set - in seconds */
+        juce::Array<double> hotCues;
+        /** tempo - in beats per minute, 0 if the track has not been analysed */
+        double bpm = 0.0;
+        /** first downbeat - in seconds */
+        double firstBeat = 0.0;
+        /** integrated loudness - in LUFS, 0 if the track has not been analysed */
+        double loudness = 0.0;
+        /** true peak - in dBTP */
+        double truePeak = 0.0;
+        /** first audible moment, where the track starts - in seconds */
+        double cueIn = 0.0;
+    };
+
+    /** inputs: reference to the audio format manager (juce::AudioFormatManager&); reference to the decoded track cache shared by all decks (DecodedTrackCache&); reference to the job scheduler that runs loads (JobScheduler&); optional clock shared by every deck, needed for timed and quantised commands (const MasterClock*)
      constructor */
-    DJAudioPlayer(juce::AudioFormatManager& _formatManager);
+    DJAudioPlayer(juce::AudioFormatManager& _formatManager,
+                  DecodedTrackCache& _trackCache,
+                  JobScheduler& _scheduler,
+                  const MasterClock* _clock = nullptr);
     /**
      destructor */
     ~DJAudioPlayer();
@@ -29,37 +68,280 @@ public:
      From https://docs.juce.com/master/classAudioSource.html "Called repeatedly to fetch subsequent blocks of audio data."
      recieves and manages chunks of audio in the form of buffers */
     void getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill) override;
+    /** inputs: reference to the target channel buffer (juce::AudioSourceChannelInfo&) | outputs: false if the deck is idle and the buffer was left untouched (bool)
+     renders the next block like getNextAudioBlock, but skips all the work once the deck has been stopped long enough to be silent.
+     timed starts, stops and jumps due within the block happen on their exact sample - audio thread only */
+    bool renderNextBlock(const juce::AudioSourceChannelInfo& bufferToFill);
+    /** outputs: channel fader gain, as last set with setGain, times the loaded track's trim (float)
+     renderNextBlock leaves the fader to the mixer, which reads it here - only on the thread rendering the deck, once the block is done */
+    float getChannelGain() const;
+    /** inputs: where the master clock stands for the next block (MasterClock::Position)
+     renderNextBlock lines up timed changes and sync against this rather than the clock itself - set before handing the deck over to be rendered */
+    void setClockPosition(const MasterClock::Position& position);
     /**
      From https://docs.juce.com/master/classAudioProcessor.html
      "Called after playback has stopped, to let the object free up any resources it no longer needs."
      release memorey resources at end of audio life-cycle */
     void releaseResources() override;
-    /** inputs: URL to audio file to be loaded (juce::URL) | load file from disk for playback */
-    void loadURL(juce::URL audioURL);
+    /** inputs: URL to audio file to be loaded (juce::URL); optional hot cues, beat grid, loudness and cue in of the track (TrackSettings) | load file from disk for playback, starting at the cue in */
+    void loadURL(juce::URL audioURL, TrackSettings settings = {});
+    /** inputs: URL to audio file to be loaded (juce::URL); optional function called on the message thread when the load finishes, passed true if the file could be played (std::function<void(bool)>); optional seek index of the file, from the library (std::shared_ptr<const SeekIndex>); optional hot cues, beat grid, loudness and cue in of the track (TrackSettings)
+     opens and prepares the file on a worker thread and swaps it in once ready, so the message thread never blocks.
+     tracks already in the decoded track cache load instantly, others stream from disk while being decoded into the cache for next time.
+     compressed files streamed with a seek index seek in constant time, and hot cues are in RAM before the track is swapped in.
+     the beat grid takes over loop lengths and sync as the track is swapped in, a track with none being taken to be 120 BPM from the start.
+     the track is trimmed to its loudness and starts at its cue in, so neither the deck nor its read-ahead spends time on the silence before it.
+     issuing another load to this deck cancels the one in progress, whose callback is then never called */
+    void loadURLAsync(juce::URL audioURL, std::function<void(bool)> onLoaded = nullptr, std::shared_ptr<const SeekIndex> seekIndex = nullptr, TrackSettings settings = {});
+    /** outputs: URL of the track on the deck, empty if none (juce::URL) */
+    juce::URL getLoadedURL() const;
     /** inputs: relative gain for output - between 0 [mute] and 1 [full volume] (double) | sets a playback volume for the file between 0 (silent) and 1 (maximum loudness without clipping) */
     void setGain(double gain);
-    /** inputs: relative speed for output - with 1.0 being normal speed (double) | sets a relative playback speed for the file from 0.1 (10% normal speed of the file) to 2.0 (200% the normal speed of the file) */
+    /** inputs: relative speed for output - with 1.0 being normal speed (double) | sets a relative playback speed for the file between -100 and 100 - negative speeds play backwards and 0 stops the deck.
+     the resampler tops out at PolyphaseResampler::maxRatio file samples per device sample, around 18x at matching sample rates, and faster speeds play at that */
     void setSpeed(double ratio);
+    /** inputs: flag stating whether the deck is being scratched (bool) | while scratching, the scratch rate replaces the speed and key-lock is ignored */
+    void setScratching(bool shouldScratch);
+    /** inputs: playback rate while scratching, from -maxScratchRate to maxScratchRate, negative being backwards (double) | drives the playhead from a jog or scratch control, through zero and back */
+    void setScratchRate(double rate);
+    /** fastest a deck can be scratched, either way */
+    static constexpr double maxScratchRate = 4.0;
+    /** inputs: flag stating if key-lock should be on (bool) | with key-lock on, speed changes the tempo but leaves the pitch alone.
+     the pitch only holds between TimeStretcher::minTempoRatio and maxTempoRatio (0.05x to 4x) - outside that the speed beyond the limit changes the pitch as it would unlocked, so 0 still stops the deck */
+    void setKeyLock(bool shouldBeLocked);
+    /** inputs: key shift in semitones, from -12 to +12 (int); fine tuning in cents, from -100 to +100 (double) | moves the pitch without touching the tempo, on top of any speed or key-lock setting */
+    void setKeyShift(int semitones, double cents);
     /** inputs: absolute position of the current moment in playback - in seconds (double) | sets the position of the playhead to a point in the file in seconds */
     void setPosition(double posInSecs);
     /** inputs: relative position of the current moment in playback - with 0 being the start and 1 being the end (double) | sets the position of the playhead to a relative point in the file */
     void setPositionRelative(double pos);
-    /** start playing the file */
+    /** start playing the file - on the next beat or bar if quantised */
     void start();
-    /** stop playing the file */
+    /** stop playing the file - on the next beat or bar if quantised */
     void stop();
+    /** inputs: when to start - in output samples of the master clock (juce::int64) | starts playing so the first sample is heard on exactly that sample, so decks given the same time start together whatever their latency */
+    void startAt(juce::int64 sampleTime);
+    /** inputs: when to stop - in output samples of the master clock (juce::int64) | stops playing so the fade out is heard from exactly that sample */
+    void stopAt(juce::int64 sampleTime);
+    /** inputs: absolute position to jump to - in seconds (double); when to jump - in output samples of the master clock (juce::int64) | moves the playhead so the jump is heard on exactly that sample */
+    void setPositionAt(double posInSecs, juce::int64 sampleTime);
+    /** inputs: how to line up starts, stops and hot cue jumps with the master clock (MasterClock::Quantize) | with quantising on, they wait for the next beat or bar */
+    void setQuantize(MasterClock::Quantize newQuantize);
     /** outputs: relative position of the current moment in playback - with 0 being the start and 1 being the end (double) | get the relative position of the playhead */
     double getPositionRelative() const;
-    /** inputs: the frequency for which bandwidths below are to be removed (double); the desired resonance (float) | update the state of the filter as the user changes parameters */
-    void updateFilter(float freq, float res);
+    /** inputs: filter knob position - from -1 [low-pass fully closed] through 0 [off] to 1 [high-pass fully closed] (float); the desired resonance (float) | update the state of the filter as the user changes parameters */
+    void updateFilter(float position, float res);
+    /** inputs: isolator band to set (IsolatorEQ::Band); gain for the band - in decibels, with eqKillDecibels or below killing it (float) | sets one band of the deck's isolator EQ */
+    void setEQGain(IsolatorEQ::Band band, float decibels);
+    /** isolator gain at and below which a band is killed outright - in decibels */
+    static constexpr float eqKillDecibels = -26.0f;
+    /** inputs: length of audio to keep buffered ahead of the playhead - in seconds (double) | sets the read-ahead buffer length, applied on the next load */
+    void setReadAheadTime(double seconds);
+    /** outputs: number of blocks the read-ahead buffer failed to fill since the current track was loaded (int) */
+    int getReadAheadUnderruns() const;
+    /** outputs: how full the read-ahead buffer is - with 0 being empty and 1 being full, always 1 for tracks that need no read-ahead (float) */
+    float getReadAheadFillLevel() const;
+    /** inputs: quality tier for speed changes (PolyphaseResampler::Quality) | trades resampling quality against CPU, see PolyphaseResampler for the cost of each tier */
+    void setResamplingQuality(PolyphaseResampler::Quality quality);
+    /** outputs: measured time the resampler spends per output sample - in nanoseconds (double) */
+    double getResamplerNanosPerSample() const;
+    /** inputs: tempo of the loaded track - in beats per minute (double) | sets the tempo beat lengths for loops are worked out from, and that sync matches to the master clock */
+    void setBPM(double bpm);
+    /** inputs: where the track's first beat falls - in seconds (double) | lines the track's beats up for sync */
+    void setFirstBeat(double seconds);
+    /** inputs: flag stating whether to lock the deck to the master clock (bool)
+     while synced and playing forwards, the deck plays at the clock's tempo whatever the speed control says, and its beats are kept on the clock's beats -
+     snapped into line on the first block and after any jump, then held there by nudging the resampling ratio a fraction of a sample at a time */
+    void setSync(bool shouldSync);
+    /** outputs: flag stating whether the deck is set to sync (bool) */
+    bool isSynced() const;
+    /** outputs: how far the deck's beats were ahead of the master clock's last block, negative if behind, 0 when not locked - in milliseconds (double) */
+    double getPhaseErrorMs() const;
+    /** marks the loop in point at the playhead */
+    void loopIn();
+    /** marks the loop out point at the playhead and starts looping back to the in point */
+    void loopOut();
+    /** inputs: length of the loop - in beats, from 1/4 to 32 (double) | starts a loop of that many beats at the playhead */
+    void setAutoLoop(double beats);
+    /** halves the current loop */
+    void halveLoop();
+    /** doubles the current loop */
+    void doubleLoop();
+    /** stops looping, playback carries on out of the loop end */
+    void exitLoop();
+    /** inputs: length of the roll - in beats, from 1/4 to 32 (double) | loops that many beats from the playhead while the track carries on underneath */
+    void startLoopRoll(double beats);
+    /** ends the roll, picking the track up where it would have been had it never rolled */
+    void stopLoopRoll();
+    /** outputs: flag stating whether a loop or roll is playing (bool) */
+    bool isLoopActive() const;
+    /** inputs: index of the cue, from 0 (int) | outputs: position the cue was set to, -1 if no track is loaded - in seconds (double)
+     sets a hot cue at the playhead, and has the audio after it copied into RAM straight away, playing or not */
+    double setHotCue(int index);
+    /** inputs: index of the cue, from 0 (int) | clears a hot cue */
+    void clearHotCue(int index);
+    /** inputs: index of the cue, from 0 (int) | jumps to a hot cue - the first moments after it are already in RAM, so output starts in the next block */
+    void jumpToHotCue(int index);
+    /** inputs: index of the cue, from 0 (int) | outputs: position of the cue, -1 if it is not set - in seconds (double) */
+    double getHotCue(int index) const;
+    /** number of hot cues per track */
+    static constexpr int numHotCues = LoopingAudioSource::numHotCues;
+    /** shortest and longest loops, in beats */
+    static constexpr double minLoopBeats = 0.25;
+    static constexpr double maxLoopBeats = 32.0;
+    /** inputs: integrated loudness of the loaded track - in LUFS, 0 if it has not been analysed (double); its true peak - in dBTP (double)
+     trims the deck so the track plays at targetLoudness, turning it up only as far as its true peak stays under truePeakCeiling */
+    void setLoudness(double loudness, double truePeak);
+    /** outputs: trim applied to the loaded track - in decibels (double) */
+    double getTrimDecibels() const;
+    /** loudness every track is trimmed to - in LUFS */
+    static constexpr double targetLoudness = -14.0;
+    /** highest a track's true peak is allowed to be turned up to - in dBTP */
+    static constexpr double truePeakCeiling = -1.0;
+    /** most a track is turned up or down - in decibels */
+    static constexpr double maxTrimDecibels = 12.0;
 
 private:
+    /** time a synced deck takes to pull in a phase error - in seconds */
+    static constexpr double syncCorrectionSeconds = 0.5;
+    /** most a synced deck's rate is nudged away from the clock's tempo to correct its phase, 1% being just short of audible */
+    static constexpr double maxSyncNudge = 0.01;
+    /** a phase error bigger than this is snapped out with a seek rather than nudged - in seconds */
+    static constexpr double phaseSnapSeconds = 0.005;
+    /** a change in phase error bigger than this from one block to the next means the playhead has jumped - in beats */
+    static constexpr double phaseJumpBeats = 0.05;
+    /** how quickly the smoothed phase error follows each block, smoothing over the key-lock stretcher's grain to grain wobble */
+    static constexpr double phaseErrorSmoothing = 0.2;
+
+    /** everything built for a track before it is handed to the transport */
+    struct PreparedSource
+    {
+        /** streams from disk, owns the reader - set when the track was not cached */
+        std::unique_ptr<ReadAheadAudioSource> readAheadSource;
+        /** plays from RAM - set when the track was in the decoded track cache */
+        std::unique_ptr<DecodedTrackAudioSource> decodedSource;
+        /** plays from a memory map of the file - set for uncompressed files that were not cached */
+        std::unique_ptr<MappedAudioSource> mappedSource;
+        double sampleRate = 0.0;
+        juce::URL url;
+        /** plays the track through the loop engine - declared last so it goes before the track source it reads from */
+        std::unique_ptr<LoopingAudioSource> loopSource;
+
+        /** outputs: the source the track is read from, nullptr if the file could not be read (juce::PositionableAudioSource*) */
+        juce::PositionableAudioSource* getTrackSource() const;
+        /** outputs: the source to hand to the transport, nullptr if the file could not be read (juce::PositionableAudioSource*) */
+        juce::PositionableAudioSource* getPlaybackSource() const;
+    };
+    /** worker job that prepares a track off the message thread */
+    class LoadJob;
+
+    /** inputs: URL to audio file to be loaded (juce::URL); length of the read-ahead buffer - in seconds (double); seek index of the file, may be nullptr (std::shared_ptr<const SeekIndex>) | outputs: the prepared sources, empty if the file could not be read (PreparedSource)
+     opens the file and builds the sources needed to play it - slow, safe to call from any thread */
+    PreparedSource prepareSource(juce::URL audioURL, double readAheadSeconds, std::shared_ptr<const SeekIndex> seekIndex);
+    /** inputs: the prepared sources for the new track (PreparedSource&); second source for the same track, read only to copy loops into RAM, may be nullptr (std::unique_ptr<juce::PositionableAudioSource>) | puts the loop engine in front of the track's source */
+    void addLoopSource(PreparedSource& prepared, std::unique_ptr<juce::PositionableAudioSource> preloadSource);
+    /** inputs: URL to audio file to be read (juce::URL); seek index of the file, may be nullptr (std::shared_ptr<const SeekIndex>) | outputs: reader for the file, seeking through the index if there is one that fits, nullptr if the file could not be read (juce::AudioFormatReader*) */
+    juce::AudioFormatReader* createReader(juce::URL audioURL, std::shared_ptr<const SeekIndex> seekIndex);
+    /** inputs: the prepared sources for the new track (PreparedSource&&); hot cues, beat grid, loudness and cue in of the track (const TrackSettings&) | hands the prepared sources to the transport in one step and frees the old ones */
+    void swapInSource(PreparedSource&& prepared, const TrackSettings& settings);
+
     juce::AudioFormatManager& formatManager;
-    std::unique_ptr<juce::AudioFormatReaderSource> readerSource;
+    DecodedTrackCache& trackCache;
+    JobScheduler& scheduler;
+    std::atomic<int> loadGeneration{0};
+    juce::TimeSliceThread readAheadThread{"Deck read-ahead"};
+    /** tracks posted to the message thread but not swapped in yet - their sources use the read-ahead thread, so the destructor drops them before stopping it */
+    std::vector<std::shared_ptr<PreparedSource>> pendingSwaps;
+    juce::CriticalSection pendingSwapsLock;
+    double readAheadTime = 2.0;
+    PreparedSource currentSource;
+    /** runs whenever a track is loaded - the gate decides whether it is heard */
     juce::AudioTransportSource transportSource;
-    juce::ResamplingAudioSource resampleSource{&transportSource, false, 2};
+    PlaybackGate playGate{transportSource};
+    PolyphaseResampler resampleSource{&playGate, false, 2};
+    TimeStretcher keyLockStretcher{&resampleSource, false};
+    bool keyLock = false;
+    std::atomic<double> sourceSampleRate{0.0};
+    double deviceSampleRate = 0.0;
+    double speed = 1.0;
+    bool scratching = false;
+    double scratchRate = 0.0;
+    /** speed and scratch settings as last sent to the audio thread, to work out which way the playhead moves - message thread only */
+    double requestedSpeed = 1.0;
+    bool requestedScratching = false;
+    double requestedScratchRate = 0.0;
+    /** tempo loops are measured against - until the track has been analysed, a guess */
+    double trackBPM = 120.0;
+    /** where the track's first beat falls - in seconds, message thread only */
+    double firstBeatSeconds = 0.0;
+    bool requestedSync = false;
+    /** beat grid and sync state as seen by the audio thread */
+    double syncBPM = 120.0;
+    double syncFirstBeat = 0.0;
+    bool syncEnabled = false;
+    /** playback rate set by sync, 0 when the deck is not locked - audio thread only */
+    double syncRate = 0.0;
+    /** phase error in beats, raw from the last block and smoothed over a few - audio thread only */
+    double lastPhaseError = 0.0;
+    double smoothedPhaseError = 0.0;
+    bool needsPhaseSnap = true;
+    std::atomic<double> phaseErrorMs{0.0};
+    /** hot cues of the track on the deck, -1 for those not set - in seconds, message thread only */
+    juce::Array<double> hotCues;
+    float channelGain = 1.0f;
+    float lastChannelGain = 1.0f;
+    /** loudness trim of the track on the deck - in decibels on the message thread, and as a gain on the audio thread */
+    double trimDecibels = 0.0;
+    float trimGain = 1.0f;
+    juce::int64 samplesSinceStopped = 0;
+    juce::int64 idleTailSamples = 0;
 
     void reset();
+    /** applies the control changes queued by the message thread - call at the start of each audio block */
+    void applyPendingCommands();
+    /** works out the resampling ratio from the file's sample rate, the device's sample rate and the speed - audio thread only */
+    void updateResamplingRatio();
+    /** inputs: position to read from next - in file samples (juce::int64)
+     moves the transport and flushes the audio held by the resampler and stretcher, so nothing from before the jump is played after it - audio thread only */
+    void seekTransport(juce::int64 position);
+    /** inputs: reference to the part of the block to render (juce::AudioSourceChannelInfo&) | outputs: false if the deck is idle and the buffer was left untouched (bool)
+     runs the deck's chain for part of a block - audio thread only */
+    bool renderSegment(const juce::AudioSourceChannelInfo& segment);
+    /** inputs: a timed or quantised change just taken off the queue (const DeckCommandQueue::ScheduledChange&) | outputs: the same change with the time it is due - in output samples (DeckCommandQueue::ScheduledChange)
+     audio thread only */
+    DeckCommandQueue::ScheduledChange resolveTime(const DeckCommandQueue::ScheduledChange& change) const;
+    /** outputs: time from a sample leaving the gate to it being heard, through the resampler, key-lock stretcher and key shifter - in output samples (double)
+     the isolator and filter are IIR filters with no delay worth counting - audio thread only */
+    double getLatencySamples() const;
+    /** inputs: time of the sample about to be rendered - in output samples (juce::int64) | makes any scheduled jump, then start or stop, that is due - audio thread only */
+    void applyScheduledChanges(juce::int64 now);
+    /** inputs: time of the sample about to be rendered - in output samples (juce::int64) | outputs: time of the next scheduled change after it, -1 if there is none (juce::int64) */
+    juce::int64 getNextScheduledTime(juce::int64 now) const;
+    /** inputs: time of the block about to be rendered - in output samples (juce::int64) | measures how far the deck's beats are from the master clock's and sets the rate to close the gap - audio thread only */
+    void updateSync(juce::int64 now);
+    /** tells the track's playhead which way to move and whether it is being scratched - message thread only */
+    void updateDirection();
+    /** starts the transport if a track is loaded and it has stopped itself at the end of the track - message thread only */
+    void keepTransportRunning();
+    /** outputs: length of the loaded track - in seconds (double) */
+    double getLengthInSeconds() const;
+    /** inputs: loop length - in beats (double) | outputs: loop length in samples of the loaded track (juce::int64) */
+    juce::int64 beatsToSamples(double beats) const;
+
+    DeckCommandQueue commandQueue;
+    const MasterClock* clock;
+    /** the clock as it stood for the block being rendered - written before the block is handed over, read while rendering */
+    MasterClock::Position blockClock;
+    /** how starts, stops and jumps line up with the clock - message thread only */
+    MasterClock::Quantize quantize = MasterClock::Quantize::none;
+    /** timed start or stop and jump waiting for their sample - audio thread only */
+    DeckCommandQueue::ScheduledChange scheduledTransport;
+    DeckCommandQueue::ScheduledChange scheduledPosition;
+    /** the deck's latency as of the start of the block, scheduled changes are made this much early so they are heard on time - in output samples, audio thread only */
+    juce::int64 latencySamples = 0;
+    PitchShifter keyShifter;
+    IsolatorEQ isolator;
+    DJFilter filter;
 
-    juce::dsp::StateVariableTPTFilter<float> filter;
+    JUCE_DECLARE_WEAK_REFERENCEABLE (DJAudioPlayer)
 };
@@ -0,0 +1,138 @@
+/*
+  ==============================================================================
+
+    DJFilter.cpp
+    Created: 19 Oct 2026 11:02:17am
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#include "DJFilter.h"
+
+namespace
+{
+    /** knob travel either side of centre that leaves the filter off */
+    constexpr float deadZone = 0.02f;
+    /** knob travel over which the filter fades in after the dead zone */
+    constexpr float fadeInAmount = 0.05f;
+    /** cutoff range of each side, from just past centre to fully turned */
+    constexpr float lowPassOpen = 20000.0f;
+    constexpr float lowPassClosed = 60.0f;
+    constexpr float highPassOpen = 20.0f;
+    constexpr float highPassClosed = 8000.0f;
+}
+
+DJFilter::DJFilter()
+{
+}
+
+DJFilter::~DJFilter()
+{
+}
+
+void DJFilter::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = spec.sampleRate;
+    // glide over a few blocks - fast enough to follow a sweep, slow enough not to step
+    cutoffSmoother.reset(sampleRate, 0.03);
+    wetSmoother.reset(sampleRate, 0.02);
+    reset();
+}
+
+void DJFilter::reset()
+{
+    std::fill(std::begin(state), std::end(state), 0.0f);
+    activeMode = Mode::off;
+    cutoffSmoother.setCurrentAndTargetValue(lowPassOpen);
+    wetSmoother.setCurrentAndTargetValue(0.0f);
+    lastCoefficients = DSPKernels::FilterCoefficients();
+}
+
+void DJFilter::setPosition(float newPosition)
+{
+    // setter for knob position
+    position = juce::jlimit(-1.0f, 1.0f, newPosition);
+}
+
+void DJFilter::setResonance(float newResonance)
+{
+    // setter for resonance
+    resonance = juce::jlimit(0.3f, 20.0f, newResonance);
+}
+
+void DJFilter::process(const juce::dsp::ProcessContextReplacing<float>& context)
+{
+    juce::ScopedNoDenormals noDenormals;
+    auto& block = context.getOutputBlock();
+    auto numSamples = static_cast<int>(block.getNumSamples());
+    jassert(block.getNumChannels() >= 2);
+    if (block.getNumChannels() < 2 || numSamples == 0)
+    {
+        return;
+    }
+
+    // work out which side of centre the knob is on and how far round it is
+    auto amount = juce::jlimit(0.0f, 1.0f, (std::abs(position) - deadZone) / (1.0f - deadZone));
+    auto targetMode = amount == 0.0f ? Mode::off : (position < 0.0f ? Mode::lowPass : Mode::highPass);
+    auto targetCutoff = targetMode == Mode::highPass
+                      ? highPassOpen * std::pow(highPassClosed / highPassOpen, amount)
+                      : lowPassOpen * std::pow(lowPassClosed / lowPassOpen, amount);
+    auto targetWet = juce::jmin(1.0f, amount / fadeInAmount);
+
+    if (targetMode != Mode::off && targetMode != activeMode)
+    {
+        if (wetSmoother.getCurrentValue() > 0.0f)
+        {
+            // fade the old side out through the dry signal before switching
+            wetSmoother.setTargetValue(0.0f);
+        }
+        else {
+            // fully dry - switch sides and fade the new one in from where the knob is
+            activeMode = targetMode;
+            cutoffSmoother.setCurrentAndTargetValue(targetCutoff);
+            wetSmoother.setTargetValue(targetWet);
+            lastCoefficients = makeCoefficients(activeMode, targetCutoff, 0.0f);
+        }
+    }
+    else {
+        if (targetMode != Mode::off)
+        {
+            cutoffSmoother.setTargetValue(targetCutoff);
+        }
+        wetSmoother.setTargetValue(targetWet);
+    }
+
+    // smooth per block, then slide sample by sample within it
+    auto startWet = wetSmoother.getCurrentValue();
+    auto cutoff = cutoffSmoother.skip(numSamples);
+    auto endWet = wetSmoother.skip(numSamples);
+    if (activeMode == Mode::off || (startWet == 0.0f && endWet == 0.0f))
+    {
+        // centred - leave the audio alone and start from silence next time
+        std::fill(std::begin(state), std::end(state), 0.0f);
+        lastCoefficients = makeCoefficients(activeMode, cutoff, 0.0f);
+        return;
+    }
+
+    auto coefficients = makeCoefficients(activeMode, cutoff, endWet);
+    DSPKernels::stateVariableFilterStereo(block.getChannelPointer(0), block.getChannelPointer(1), numSamples,
+                                          state, lastCoefficients, coefficients);
+    lastCoefficients = coefficients;
+}
+
+DSPKernels::FilterCoefficients DJFilter::makeCoefficients(Mode forMode, float cutoff, float wet) const
+{
+    // TPT state variable filter coefficients, as in juce::dsp::StateVariableTPTFilter
+    auto maxCutoff = static_cast<float>(sampleRate) * 0.49f;
+    auto g = std::tan(juce::MathConstants<float>::pi * juce::jmin(cutoff, maxCutoff) / static_cast<float>(sampleRate));
+    DSPKernels::FilterCoefficients c;
+    c.k = 1.0f / resonance;
+    c.a1 = 1.0f / (1.0f + g * (g + c.k));
+    c.a2 = g * c.a1;
+    c.a3 = g * c.a2;
+    c.dry = 1.0f - wet;
+    c.lowPass = forMode == Mode::lowPass ? wet : 0.0f;
+    c.highPass = forMode == Mode::highPass ? wet : 0.0f;
+    return c;
+}
@@ -0,0 +1,61 @@
+/*
+  ==============================================================================
+
+    DJFilter.h
+    Created: 19 Oct 2026 11:02:17am
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DSPKernels.h"
+
+/** single-knob DJ filter - low-pass one side of centre, high-pass the other, out of the signal path at centre.
+ a TPT state variable filter runs both stereo channels together in SIMD lanes.
+ the cutoff and the mix glide towards the knob from block to block and every coefficient is slid sample by sample across each block,
+ so fast sweeps don't zipper. crossing the centre fades out through the dry signal before switching sides */
+class DJFilter
+{
+public:
+    /**
+     constructor */
+    DJFilter();
+    /**
+     destructor */
+    ~DJFilter();
+    /** inputs: specifications of the audio to be processed (juce::dsp::ProcessSpec&) | sets up the smoothing for the sample rate */
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    /** clears the filter memory and jumps straight to the current settings */
+    void reset();
+    /** inputs: knob position - from -1 [low-pass fully closed] through 0 [off] to 1 [high-pass fully closed] (float) | sets the filter position */
+    void setPosition(float position);
+    /** inputs: resonance - from 0.3 to 20, with 0.71 being flat (float) | sets the filter resonance */
+    void setResonance(float resonance);
+    /** inputs: stereo audio to be filtered in place (juce::dsp::ProcessContextReplacing<float>&) | filters the block */
+    void process(const juce::dsp::ProcessContextReplacing<float>& context);
+
+private:
+    enum class Mode
+    {
+        off,
+        lowPass,
+        highPass
+    };
+
+    /** inputs: side of the knob to build coefficients for (Mode); cutoff frequency - in hz (float); how much of the filtered signal to use (float) | outputs: filter coefficients for those settings (DSPKernels::FilterCoefficients) */
+    DSPKernels::FilterCoefficients makeCoefficients(Mode forMode, float cutoff, float wet) const;
+
+    double sampleRate = 44100.0;
+    float position = 0.0f;
+    float resonance = 0.71f;
+    Mode activeMode = Mode::off;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> cutoffSmoother;
+    juce::SmoothedValue<float> wetSmoother;
+    DSPKernels::FilterCoefficients lastCoefficients;
+    float state[4] = {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DJFilter)
+};
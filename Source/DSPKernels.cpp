@@ -0,0 +1,735 @@
+/*
+  ==============================================================================
+
+    DSPKernels.cpp
+    Created: 18 Oct 2026 3:21:40pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#include "DSPKernels.h"
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+ #if JUCE_MSVC
+  #define DSPKERNELS_AVX2_TARGET
+ #else
+  // lets the AVX2 versions be built without turning AVX2 on for the whole app, they are only called once the CPU is checked
+  #define DSPKERNELS_AVX2_TARGET __attribute__ ((target ("avx2,fma")))
+ #endif
+#elif JUCE_ARM && (defined (__ARM_NEON__) || defined (__ARM_NEON))
+ #include <arm_neon.h>
+ #define DSPKERNELS_USE_NEON 1
+#endif
+
+namespace
+{
+    //==============================================================================
+    // plain C++ versions - used on CPUs without any of the instruction sets below,
+    // and to finish off the elements left over after the vector loops
+    float dotProductScalar(const float* a, const float* b, int num)
+    {
+        float sum = 0.0f;
+        for (int i = 0; i < num; ++i)
+        {
+            sum += a[i] * b[i];
+        }
+        return sum;
+    }
+
+    void interpolateScalar(float* dest, const float* a, const float* b, float amount, int num)
+    {
+        for (int i = 0; i < num; ++i)
+        {
+            dest[i] = a[i] + (b[i] - a[i]) * amount;
+        }
+    }
+
+    void stateVariableFilterStereoScalar(float* left, float* right, int num, float* state,
+                                         const DSPKernels::FilterCoefficients& start, const DSPKernels::FilterCoefficients& end)
+    {
+        auto c = start;
+        const float step = num > 0 ? 1.0f / num : 0.0f;
+        float* channels[2] = { left, right };
+        for (int i = 0; i < num; ++i)
+        {
+            c.a1 += (end.a1 - start.a1) * step;
+            c.a2 += (end.a2 - start.a2) * step;
+            c.a3 += (end.a3 - start.a3) * step;
+            c.k += (end.k - start.k) * step;
+            c.dry += (end.dry - start.dry) * step;
+            c.lowPass += (end.lowPass - start.lowPass) * step;
+            c.highPass += (end.highPass - start.highPass) * step;
+            for (int chan = 0; chan < 2; ++chan)
+            {
+                float& ic1 = state[chan];
+                float& ic2 = state[chan + 2];
+                const float x = channels[chan][i];
+                const float v3 = x - ic2;
+                const float v1 = c.a1 * ic1 + c.a2 * v3;
+                const float v2 = ic2 + c.a2 * ic1 + c.a3 * v3;
+                ic1 = 2.0f * v1 - ic1;
+                ic2 = 2.0f * v2 - ic2;
+                const float highPass = x - c.k * v1 - v2;
+                channels[chan][i] = c.dry * x + c.lowPass * v2 + c.highPass * highPass;
+            }
+        }
+    }
+
+    /** one sample of a TPT state variable filter over four lanes, as laid out by the isolator kernels */
+    void stateVariableStepScalar(const float* x, float* ic1, float* ic2, float a1, float a2, float a3, float k,
+                                 float* lowPass, float* bandPass, float* highPass)
+    {
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            const float v3 = x[lane] - ic2[lane];
+            const float v1 = a1 * ic1[lane] + a2 * v3;
+            const float v2 = ic2[lane] + a2 * ic1[lane] + a3 * v3;
+            ic1[lane] = 2.0f * v1 - ic1[lane];
+            ic2[lane] = 2.0f * v2 - ic2[lane];
+            lowPass[lane] = v2;
+            bandPass[lane] = v1;
+            highPass[lane] = x[lane] - k * v1 - v2;
+        }
+    }
+
+    void isolatorStereoScalar(float* left, float* right, int num, float* state, const DSPKernels::CrossoverCoefficients& c,
+                              const DSPKernels::BandGains& start, const DSPKernels::BandGains& end)
+    {
+        const float step = num > 0 ? 1.0f / num : 0.0f;
+        auto gains = start;
+        float in[4], lp[4], bp[4], hp[4];
+        for (int i = 0; i < num; ++i)
+        {
+            gains.low += (end.low - start.low) * step;
+            gains.mid += (end.mid - start.mid) * step;
+            gains.high += (end.high - start.high) * step;
+
+            // first half of the low crossover on the input
+            in[0] = left[i];
+            in[1] = right[i];
+            in[2] = 0.0f;
+            in[3] = 0.0f;
+            stateVariableStepScalar(in, state, state + 4, c.lowA1, c.lowA2, c.lowA3, c.k, lp, bp, hp);
+            // second half - low band in lanes 0-1, everything above it in lanes 2-3
+            in[0] = lp[0];
+            in[1] = lp[1];
+            in[2] = hp[0];
+            in[3] = hp[1];
+            stateVariableStepScalar(in, state + 8, state + 12, c.lowA1, c.lowA2, c.lowA3, c.k, lp, bp, hp);
+            // first half of the high crossover on what is above the low band, with the low band all-passed alongside to keep it in phase
+            in[0] = hp[2];
+            in[1] = hp[3];
+            in[2] = lp[0];
+            in[3] = lp[1];
+            stateVariableStepScalar(in, state + 16, state + 20, c.highA1, c.highA2, c.highA3, c.k, lp, bp, hp);
+            const float lowL = in[2] - 2.0f * c.k * bp[2];
+            const float lowR = in[3] - 2.0f * c.k * bp[3];
+            // second half - mid band in lanes 0-1, high band in lanes 2-3
+            in[0] = lp[0];
+            in[1] = lp[1];
+            in[2] = hp[0];
+            in[3] = hp[1];
+            stateVariableStepScalar(in, state + 24, state + 28, c.highA1, c.highA2, c.highA3, c.k, lp, bp, hp);
+
+            left[i] = gains.low * lowL + gains.mid * lp[0] + gains.high * hp[2];
+            right[i] = gains.low * lowR + gains.mid * lp[1] + gains.high * hp[3];
+        }
+    }
+
+    float kWeightedPowerStereoScalar(const float* left, const float* right, int num, float* state,
+                                     const DSPKernels::KWeightingCoefficients& c)
+    {
+        const float* channels[2] = { left, right };
+        float sum = 0.0f;
+        for (int i = 0; i < num; ++i)
+        {
+            for (int chan = 0; chan < 2; ++chan)
+            {
+                // two transposed direct form II biquads, one after the other
+                const float x = channels[chan][i];
+                const float shelf = c.shelfB0 * x + state[chan];
+                state[chan] = c.shelfB1 * x - c.shelfA1 * shelf + state[chan + 2];
+                state[chan + 2] = c.shelfB2 * x - c.shelfA2 * shelf;
+                const float y = c.highPassB0 * shelf + state[chan + 4];
+                state[chan + 4] = c.highPassB1 * shelf - c.highPassA1 * y + state[chan + 6];
+                state[chan + 6] = c.highPassB2 * shelf - c.highPassA2 * y;
+                sum += y * y;
+            }
+        }
+        return sum;
+    }
+
+    /** finishes off the elements a vector loop left over, carrying on each gain ramp from where it got to */
+    void mixWithGainRampsTail(float* dest, const float* const* sources, int numSources,
+                              const float* startGains, const float* endGains, int from, int num)
+    {
+        const float step = num > 0 ? 1.0f / num : 0.0f;
+        for (int i = from; i < num; ++i)
+        {
+            const float amount = (i + 1) * step;
+            float sum = 0.0f;
+            for (int source = 0; source < numSources; ++source)
+            {
+                sum += (startGains[source] + (endGains[source] - startGains[source]) * amount) * sources[source][i];
+            }
+            dest[i] = sum;
+        }
+    }
+
+    void mixWithGainRampsScalar(float* dest, const float* const* sources, int numSources,
+                                const float* startGains, const float* endGains, int num)
+    {
+        mixWithGainRampsTail(dest, sources, numSources, startGains, endGains, 0, num);
+    }
+
+   #if JUCE_INTEL
+    //==============================================================================
+    float dotProductSSE(const float* a, const float* b, int num)
+    {
+        __m128 sum = _mm_setzero_ps();
+        int i = 0;
+        for (; i + 4 <= num; i += 4)
+        {
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        }
+        // add the four lanes together
+        __m128 shuffled = _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(2, 3, 0, 1));
+        sum = _mm_add_ps(sum, shuffled);
+        shuffled = _mm_movehl_ps(shuffled, sum);
+        sum = _mm_add_ss(sum, shuffled);
+        return _mm_cvtss_f32(sum) + dotProductScalar(a + i, b + i, num - i);
+    }
+
+    void interpolateSSE(float* dest, const float* a, const float* b, float amount, int num)
+    {
+        const __m128 amountVec = _mm_set1_ps(amount);
+        int i = 0;
+        for (; i + 4 <= num; i += 4)
+        {
+            __m128 va = _mm_loadu_ps(a + i);
+            __m128 diff = _mm_sub_ps(_mm_loadu_ps(b + i), va);
+            _mm_storeu_ps(dest + i, _mm_add_ps(va, _mm_mul_ps(diff, amountVec)));
+        }
+        interpolateScalar(dest + i, a + i, b + i, amount, num - i);
+    }
+
+    /** the filter is recursive so samples can't be batched - the two channels share a register instead,
+     which is as wide as it gets, so AVX2 machines use this one too */
+    void stateVariableFilterStereoSSE(float* left, float* right, int num, float* state,
+                                      const DSPKernels::FilterCoefficients& start, const DSPKernels::FilterCoefficients& end)
+    {
+        const float step = num > 0 ? 1.0f / num : 0.0f;
+        // each coefficient and how far it moves per sample
+        __m128 a1 = _mm_set1_ps(start.a1), a1Step = _mm_set1_ps((end.a1 - start.a1) * step);
+        __m128 a2 = _mm_set1_ps(start.a2), a2Step = _mm_set1_ps((end.a2 - start.a2) * step);
+        __m128 a3 = _mm_set1_ps(start.a3), a3Step = _mm_set1_ps((end.a3 - start.a3) * step);
+        __m128 k = _mm_set1_ps(start.k), kStep = _mm_set1_ps((end.k - start.k) * step);
+        __m128 dry = _mm_set1_ps(start.dry), dryStep = _mm_set1_ps((end.dry - start.dry) * step);
+        __m128 lowPass = _mm_set1_ps(start.lowPass), lowPassStep = _mm_set1_ps((end.lowPass - start.lowPass) * step);
+        __m128 highPass = _mm_set1_ps(start.highPass), highPassStep = _mm_set1_ps((end.highPass - start.highPass) * step);
+        // lane 0 is left, lane 1 is right
+        __m128 ic1 = _mm_setr_ps(state[0], state[1], 0.0f, 0.0f);
+        __m128 ic2 = _mm_setr_ps(state[2], state[3], 0.0f, 0.0f);
+
+        for (int i = 0; i < num; ++i)
+        {
+            a1 = _mm_add_ps(a1, a1Step);
+            a2 = _mm_add_ps(a2, a2Step);
+            a3 = _mm_add_ps(a3, a3Step);
+            k = _mm_add_ps(k, kStep);
+            dry = _mm_add_ps(dry, dryStep);
+            lowPass = _mm_add_ps(lowPass, lowPassStep);
+            highPass = _mm_add_ps(highPass, highPassStep);
+
+            const __m128 x = _mm_setr_ps(left[i], right[i], 0.0f, 0.0f);
+            const __m128 v3 = _mm_sub_ps(x, ic2);
+            const __m128 v1 = _mm_add_ps(_mm_mul_ps(a1, ic1), _mm_mul_ps(a2, v3));
+            const __m128 v2 = _mm_add_ps(ic2, _mm_add_ps(_mm_mul_ps(a2, ic1), _mm_mul_ps(a3, v3)));
+            ic1 = _mm_sub_ps(_mm_add_ps(v1, v1), ic1);
+            ic2 = _mm_sub_ps(_mm_add_ps(v2, v2), ic2);
+            const __m128 hp = _mm_sub_ps(_mm_sub_ps(x, _mm_mul_ps(k, v1)), v2);
+            const __m128 y = _mm_add_ps(_mm_mul_ps(dry, x),
+                                        _mm_add_ps(_mm_mul_ps(lowPass, v2), _mm_mul_ps(highPass, hp)));
+            left[i] = _mm_cvtss_f32(y);
+            right[i] = _mm_cvtss_f32(_mm_shuffle_ps(y, y, _MM_SHUFFLE(1, 1, 1, 1)));
+        }
+
+        alignas(16) float ic1Out[4], ic2Out[4];
+        _mm_store_ps(ic1Out, ic1);
+        _mm_store_ps(ic2Out, ic2);
+        state[0] = ic1Out[0];
+        state[1] = ic1Out[1];
+        state[2] = ic2Out[0];
+        state[3] = ic2Out[1];
+    }
+
+    /** one sample of a TPT state variable filter over four lanes */
+    inline void stateVariableStepSSE(__m128 x, __m128& ic1, __m128& ic2, __m128 a1, __m128 a2, __m128 a3, __m128 k,
+                                     __m128& lowPass, __m128& bandPass, __m128& highPass)
+    {
+        const __m128 v3 = _mm_sub_ps(x, ic2);
+        const __m128 v1 = _mm_add_ps(_mm_mul_ps(a1, ic1), _mm_mul_ps(a2, v3));
+        const __m128 v2 = _mm_add_ps(ic2, _mm_add_ps(_mm_mul_ps(a2, ic1), _mm_mul_ps(a3, v3)));
+        ic1 = _mm_sub_ps(_mm_add_ps(v1, v1), ic1);
+        ic2 = _mm_sub_ps(_mm_add_ps(v2, v2), ic2);
+        lowPass = v2;
+        bandPass = v1;
+        highPass = _mm_sub_ps(_mm_sub_ps(x, _mm_mul_ps(k, v1)), v2);
+    }
+
+    void isolatorStereoSSE(float* left, float* right, int num, float* state, const DSPKernels::CrossoverCoefficients& c,
+                           const DSPKernels::BandGains& start, const DSPKernels::BandGains& end)
+    {
+        const float step = num > 0 ? 1.0f / num : 0.0f;
+        const __m128 lowA1 = _mm_set1_ps(c.lowA1), lowA2 = _mm_set1_ps(c.lowA2), lowA3 = _mm_set1_ps(c.lowA3);
+        const __m128 highA1 = _mm_set1_ps(c.highA1), highA2 = _mm_set1_ps(c.highA2), highA3 = _mm_set1_ps(c.highA3);
+        const __m128 k = _mm_set1_ps(c.k);
+        // the mid gain sits over lanes 0-1 and the high gain over lanes 2-3 of the last stage, the low gain over lanes 2-3 of the all-pass
+        __m128 midHighGain = _mm_setr_ps(start.mid, start.mid, start.high, start.high);
+        const __m128 midHighStep = _mm_mul_ps(_mm_setr_ps(end.mid - start.mid, end.mid - start.mid, end.high - start.high, end.high - start.high),
+                                              _mm_set1_ps(step));
+        __m128 lowGain = _mm_setr_ps(0.0f, 0.0f, start.low, start.low);
+        const __m128 lowStep = _mm_setr_ps(0.0f, 0.0f, (end.low - start.low) * step, (end.low - start.low) * step);
+
+        __m128 ic1[4], ic2[4];
+        for (int stage = 0; stage < 4; ++stage)
+        {
+            ic1[stage] = _mm_loadu_ps(state + stage * 8);
+            ic2[stage] = _mm_loadu_ps(state + stage * 8 + 4);
+        }
+
+        __m128 lp, bp, hp;
+        for (int i = 0; i < num; ++i)
+        {
+            midHighGain = _mm_add_ps(midHighGain, midHighStep);
+            lowGain = _mm_add_ps(lowGain, lowStep);
+
+            // first half of the low crossover on the input
+            stateVariableStepSSE(_mm_setr_ps(left[i], right[i], 0.0f, 0.0f), ic1[0], ic2[0], lowA1, lowA2, lowA3, k, lp, bp, hp);
+            // second half - low band in lanes 0-1, everything above it in lanes 2-3
+            stateVariableStepSSE(_mm_movelh_ps(lp, hp), ic1[1], ic2[1], lowA1, lowA2, lowA3, k, lp, bp, hp);
+            // first half of the high crossover on what is above the low band, with the low band all-passed alongside to keep it in phase
+            const __m128 upperAndLow = _mm_shuffle_ps(hp, lp, _MM_SHUFFLE(1, 0, 3, 2));
+            stateVariableStepSSE(upperAndLow, ic1[2], ic2[2], highA1, highA2, highA3, k, lp, bp, hp);
+            const __m128 allPassed = _mm_sub_ps(upperAndLow, _mm_mul_ps(_mm_add_ps(k, k), bp));
+            // second half - mid band in lanes 0-1, high band in lanes 2-3
+            stateVariableStepSSE(_mm_movelh_ps(lp, hp), ic1[3], ic2[3], highA1, highA2, highA3, k, lp, bp, hp);
+            const __m128 midAndHigh = _mm_shuffle_ps(lp, hp, _MM_SHUFFLE(3, 2, 1, 0));
+
+            // weight the bands, then fold lanes 2-3 onto lanes 0-1
+            const __m128 mixed = _mm_add_ps(_mm_mul_ps(midHighGain, midAndHigh), _mm_mul_ps(lowGain, allPassed));
+            const __m128 y = _mm_add_ps(mixed, _mm_movehl_ps(mixed, mixed));
+            left[i] = _mm_cvtss_f32(y);
+            right[i] = _mm_cvtss_f32(_mm_shuffle_ps(y, y, _MM_SHUFFLE(1, 1, 1, 1)));
+        }
+
+        for (int stage = 0; stage < 4; ++stage)
+        {
+            _mm_storeu_ps(state + stage * 8, ic1[stage]);
+            _mm_storeu_ps(state + stage * 8 + 4, ic2[stage]);
+        }
+    }
+
+    /** recursive like the state variable filter, so the two channels share a register and AVX2 machines use this one too */
+    float kWeightedPowerStereoSSE(const float* left, const float* right, int num, float* state,
+                                  const DSPKernels::KWeightingCoefficients& c)
+    {
+        const __m128 shelfB0 = _mm_set1_ps(c.shelfB0), shelfB1 = _mm_set1_ps(c.shelfB1), shelfB2 = _mm_set1_ps(c.shelfB2);
+        const __m128 shelfA1 = _mm_set1_ps(c.shelfA1), shelfA2 = _mm_set1_ps(c.shelfA2);
+        const __m128 highPassB0 = _mm_set1_ps(c.highPassB0), highPassB1 = _mm_set1_ps(c.highPassB1), highPassB2 = _mm_set1_ps(c.highPassB2);
+        const __m128 highPassA1 = _mm_set1_ps(c.highPassA1), highPassA2 = _mm_set1_ps(c.highPassA2);
+        // lane 0 is left, lane 1 is right
+        __m128 shelf1 = _mm_setr_ps(state[0], state[1], 0.0f, 0.0f);
+        __m128 shelf2 = _mm_setr_ps(state[2], state[3], 0.0f, 0.0f);
+        __m128 highPass1 = _mm_setr_ps(state[4], state[5], 0.0f, 0.0f);
+        __m128 highPass2 = _mm_setr_ps(state[6], state[7], 0.0f, 0.0f);
+        __m128 sum = _mm_setzero_ps();
+
+        for (int i = 0; i < num; ++i)
+        {
+            const __m128 x = _mm_setr_ps(left[i], right[i], 0.0f, 0.0f);
+            const __m128 shelf = _mm_add_ps(_mm_mul_ps(shelfB0, x), shelf1);
+            shelf1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(shelfB1, x), _mm_mul_ps(shelfA1, shelf)), shelf2);
+            shelf2 = _mm_sub_ps(_mm_mul_ps(shelfB2, x), _mm_mul_ps(shelfA2, shelf));
+            const __m128 y = _mm_add_ps(_mm_mul_ps(highPassB0, shelf), highPass1);
+            highPass1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(highPassB1, shelf), _mm_mul_ps(highPassA1, y)), highPass2);
+            highPass2 = _mm_sub_ps(_mm_mul_ps(highPassB2, shelf), _mm_mul_ps(highPassA2, y));
+            sum = _mm_add_ps(sum, _mm_mul_ps(y, y));
+        }
+
+        alignas(16) float out[4];
+        _mm_store_ps(out, shelf1);
+        state[0] = out[0];
+        state[1] = out[1];
+        _mm_store_ps(out, shelf2);
+        state[2] = out[0];
+        state[3] = out[1];
+        _mm_store_ps(out, highPass1);
+        state[4] = out[0];
+        state[5] = out[1];
+        _mm_store_ps(out, highPass2);
+        state[6] = out[0];
+        state[7] = out[1];
+        _mm_store_ps(out, sum);
+        return out[0] + out[1];
+    }
+
+    void mixWithGainRampsSSE(float* dest, const float* const* sources, int numSources,
+                             const float* startGains, const float* endGains, int num)
+    {
+        const float step = num > 0 ? 1.0f / num : 0.0f;
+        // each source's gain for the next four samples, and how far it moves every four
+        __m128 gains[DSPKernels::maxMixSources], gainSteps[DSPKernels::maxMixSources];
+        for (int source = 0; source < numSources; ++source)
+        {
+            const float perSample = (endGains[source] - startGains[source]) * step;
+            gains[source] = _mm_add_ps(_mm_set1_ps(startGains[source]),
+                                       _mm_mul_ps(_mm_set1_ps(perSample), _mm_setr_ps(1.0f, 2.0f, 3.0f, 4.0f)));
+            gainSteps[source] = _mm_set1_ps(perSample * 4.0f);
+        }
+        int i = 0;
+        for (; i + 4 <= num; i += 4)
+        {
+            __m128 sum = _mm_setzero_ps();
+            for (int source = 0; source < numSources; ++source)
+            {
+                sum = _mm_add_ps(sum, _mm_mul_ps(gains[source], _mm_loadu_ps(sources[source] + i)));
+                gains[source] = _mm_add_ps(gains[source], gainSteps[source]);
+            }
+            _mm_storeu_ps(dest + i, sum);
+        }
+        mixWithGainRampsTail(dest, sources, numSources, startGains, endGains, i, num);
+    }
+
+    //==============================================================================
+    DSPKERNELS_AVX2_TARGET float dotProductAVX2(const float* a, const float* b, int num)
+    {
+        __m256 sum = _mm256_setzero_ps();
+        int i = 0;
+        for (; i + 8 <= num; i += 8)
+        {
+            sum = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum);
+        }
+        // fold the eight lanes down to one
+        __m128 low = _mm256_castps256_ps128(sum);
+        __m128 high = _mm256_extractf128_ps(sum, 1);
+        __m128 quad = _mm_add_ps(low, high);
+        __m128 pair = _mm_add_ps(quad, _mm_movehl_ps(quad, quad));
+        __m128 single = _mm_add_ss(pair, _mm_shuffle_ps(pair, pair, 0x55));
+        return _mm_cvtss_f32(single) + dotProductScalar(a + i, b + i, num - i);
+    }
+
+    DSPKERNELS_AVX2_TARGET void interpolateAVX2(float* dest, const float* a, const float* b, float amount, int num)
+    {
+        const __m256 amountVec = _mm256_set1_ps(amount);
+        int i = 0;
+        for (; i + 8 <= num; i += 8)
+        {
+            __m256 va = _mm256_loadu_ps(a + i);
+            __m256 diff = _mm256_sub_ps(_mm256_loadu_ps(b + i), va);
+            _mm256_storeu_ps(dest + i, _mm256_fmadd_ps(diff, amountVec, va));
+        }
+        interpolateScalar(dest + i, a + i, b + i, amount, num - i);
+    }
+
+    DSPKERNELS_AVX2_TARGET void mixWithGainRampsAVX2(float* dest, const float* const* sources, int numSources,
+                                                      const float* startGains, const float* endGains, int num)
+    {
+        const float step = num > 0 ? 1.0f / num : 0.0f;
+        // each source's gain for the next eight samples, and how far it moves every eight
+        __m256 gains[DSPKernels::maxMixSources], gainSteps[DSPKernels::maxMixSources];
+        const __m256 ramp = _mm256_setr_ps(1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f);
+        for (int source = 0; source < numSources; ++source)
+        {
+            const float perSample = (endGains[source] - startGains[source]) * step;
+            gains[source] = _mm256_fmadd_ps(_mm256_set1_ps(perSample), ramp, _mm256_set1_ps(startGains[source]));
+            gainSteps[source] = _mm256_set1_ps(perSample * 8.0f);
+        }
+        int i = 0;
+        for (; i + 8 <= num; i += 8)
+        {
+            __m256 sum = _mm256_setzero_ps();
+            for (int source = 0; source < numSources; ++source)
+            {
+                sum = _mm256_fmadd_ps(gains[source], _mm256_loadu_ps(sources[source] + i), sum);
+                gains[source] = _mm256_add_ps(gains[source], gainSteps[source]);
+            }
+            _mm256_storeu_ps(dest + i, sum);
+        }
+        mixWithGainRampsTail(dest, sources, numSources, startGains, endGains, i, num);
+    }
+   #endif
+
+   #if DSPKERNELS_USE_NEON
+    //==============================================================================
+    float dotProductNEON(const float* a, const float* b, int num)
+    {
+        float32x4_t sum = vdupq_n_f32(0.0f);
+        int i = 0;
+        for (; i + 4 <= num; i += 4)
+        {
+            sum = vmlaq_f32(sum, vld1q_f32(a + i), vld1q_f32(b + i));
+        }
+        float32x2_t pair = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+        return vget_lane_f32(vpadd_f32(pair, pair), 0) + dotProductScalar(a + i, b + i, num - i);
+    }
+
+    void interpolateNEON(float* dest, const float* a, const float* b, float amount, int num)
+    {
+        int i = 0;
+        for (; i + 4 <= num; i += 4)
+        {
+            float32x4_t va = vld1q_f32(a + i);
+            float32x4_t diff = vsubq_f32(vld1q_f32(b + i), va);
+            vst1q_f32(dest + i, vmlaq_n_f32(va, diff, amount));
+        }
+        interpolateScalar(dest + i, a + i, b + i, amount, num - i);
+    }
+
+    void stateVariableFilterStereoNEON(float* left, float* right, int num, float* state,
+                                       const DSPKernels::FilterCoefficients& start, const DSPKernels::FilterCoefficients& end)
+    {
+        const float step = num > 0 ? 1.0f / num : 0.0f;
+        // each coefficient and how far it moves per sample
+        float32x2_t a1 = vdup_n_f32(start.a1), a1Step = vdup_n_f32((end.a1 - start.a1) * step);
+        float32x2_t a2 = vdup_n_f32(start.a2), a2Step = vdup_n_f32((end.a2 - start.a2) * step);
+        float32x2_t a3 = vdup_n_f32(start.a3), a3Step = vdup_n_f32((end.a3 - start.a3) * step);
+        float32x2_t k = vdup_n_f32(start.k), kStep = vdup_n_f32((end.k - start.k) * step);
+        float32x2_t dry = vdup_n_f32(start.dry), dryStep = vdup_n_f32((end.dry - start.dry) * step);
+        float32x2_t lowPass = vdup_n_f32(start.lowPass), lowPassStep = vdup_n_f32((end.lowPass - start.lowPass) * step);
+        float32x2_t highPass = vdup_n_f32(start.highPass), highPassStep = vdup_n_f32((end.highPass - start.highPass) * step);
+        // lane 0 is left, lane 1 is right
+        float32x2_t ic1 = vld1_f32(state);
+        float32x2_t ic2 = vld1_f32(state + 2);
+
+        for (int i = 0; i < num; ++i)
+        {
+            a1 = vadd_f32(a1, a1Step);
+            a2 = vadd_f32(a2, a2Step);
+            a3 = vadd_f32(a3, a3Step);
+            k = vadd_f32(k, kStep);
+            dry = vadd_f32(dry, dryStep);
+            lowPass = vadd_f32(lowPass, lowPassStep);
+            highPass = vadd_f32(highPass, highPassStep);
+
+            const float32x2_t x = vset_lane_f32(right[i], vdup_n_f32(left[i]), 1);
+            const float32x2_t v3 = vsub_f32(x, ic2);
+            const float32x2_t v1 = vmla_f32(vmul_f32(a1, ic1), a2, v3);
+            const float32x2_t v2 = vmla_f32(vmla_f32(ic2, a2, ic1), a3, v3);
+            ic1 = vsub_f32(vadd_f32(v1, v1), ic1);
+            ic2 = vsub_f32(vadd_f32(v2, v2), ic2);
+            const float32x2_t hp = vsub_f32(vmls_f32(x, k, v1), v2);
+            const float32x2_t y = vmla_f32(vmla_f32(vmul_f32(dry, x), lowPass, v2), highPass, hp);
+            left[i] = vget_lane_f32(y, 0);
+            right[i] = vget_lane_f32(y, 1);
+        }
+
+        vst1_f32(state, ic1);
+        vst1_f32(state + 2, ic2);
+    }
+
+    /** one sample of a TPT state variable filter over four lanes */
+    inline void stateVariableStepNEON(float32x4_t x, float32x4_t& ic1, float32x4_t& ic2, float32x4_t a1, float32x4_t a2, float32x4_t a3, float32x4_t k,
+                                      float32x4_t& lowPass, float32x4_t& bandPass, float32x4_t& highPass)
+    {
+        const float32x4_t v3 = vsubq_f32(x, ic2);
+        const float32x4_t v1 = vmlaq_f32(vmulq_f32(a1, ic1), a2, v3);
+        const float32x4_t v2 = vmlaq_f32(vmlaq_f32(ic2, a2, ic1), a3, v3);
+        ic1 = vsubq_f32(vaddq_f32(v1, v1), ic1);
+        ic2 = vsubq_f32(vaddq_f32(v2, v2), ic2);
+        lowPass = v2;
+        bandPass = v1;
+        highPass = vsubq_f32(vmlsq_f32(x, k, v1), v2);
+    }
+
+    void isolatorStereoNEON(float* left, float* right, int num, float* state, const DSPKernels::CrossoverCoefficients& c,
+                            const DSPKernels::BandGains& start, const DSPKernels::BandGains& end)
+    {
+        const float step = num > 0 ? 1.0f / num : 0.0f;
+        const float32x4_t lowA1 = vdupq_n_f32(c.lowA1), lowA2 = vdupq_n_f32(c.lowA2), lowA3 = vdupq_n_f32(c.lowA3);
+        const float32x4_t highA1 = vdupq_n_f32(c.highA1), highA2 = vdupq_n_f32(c.highA2), highA3 = vdupq_n_f32(c.highA3);
+        const float32x4_t k = vdupq_n_f32(c.k);
+        // the mid gain sits over lanes 0-1 and the high gain over lanes 2-3 of the last stage, the low gain over lanes 2-3 of the all-pass
+        const float midHighStart[4] = { start.mid, start.mid, start.high, start.high };
+        const float midHighSteps[4] = { (end.mid - start.mid) * step, (end.mid - start.mid) * step, (end.high - start.high) * step, (end.high - start.high) * step };
+        const float lowStart[4] = { 0.0f, 0.0f, start.low, start.low };
+        const float lowSteps[4] = { 0.0f, 0.0f, (end.low - start.low) * step, (end.low - start.low) * step };
+        float32x4_t midHighGain = vld1q_f32(midHighStart);
+        const float32x4_t midHighStep = vld1q_f32(midHighSteps);
+        float32x4_t lowGain = vld1q_f32(lowStart);
+        const float32x4_t lowStep = vld1q_f32(lowSteps);
+
+        float32x4_t ic1[4], ic2[4];
+        for (int stage = 0; stage < 4; ++stage)
+        {
+            ic1[stage] = vld1q_f32(state + stage * 8);
+            ic2[stage] = vld1q_f32(state + stage * 8 + 4);
+        }
+
+        float32x4_t lp, bp, hp;
+        for (int i = 0; i < num; ++i)
+        {
+            midHighGain = vaddq_f32(midHighGain, midHighStep);
+            lowGain = vaddq_f32(lowGain, lowStep);
+
+            // first half of the low crossover on the input
+            const float32x2_t input = vset_lane_f32(right[i], vdup_n_f32(left[i]), 1);
+            stateVariableStepNEON(vcombine_f32(input, vdup_n_f32(0.0f)), ic1[0], ic2[0], lowA1, lowA2, lowA3, k, lp, bp, hp);
+            // second half - low band in lanes 0-1, everything above it in lanes 2-3
+            stateVariableStepNEON(vcombine_f32(vget_low_f32(lp), vget_low_f32(hp)), ic1[1], ic2[1], lowA1, lowA2, lowA3, k, lp, bp, hp);
+            // first half of the high crossover on what is above the low band, with the low band all-passed alongside to keep it in phase
+            const float32x4_t upperAndLow = vcombine_f32(vget_high_f32(hp), vget_low_f32(lp));
+            stateVariableStepNEON(upperAndLow, ic1[2], ic2[2], highA1, highA2, highA3, k, lp, bp, hp);
+            const float32x4_t allPassed = vmlsq_f32(upperAndLow, vaddq_f32(k, k), bp);
+            // second half - mid band in lanes 0-1, high band in lanes 2-3
+            stateVariableStepNEON(vcombine_f32(vget_low_f32(lp), vget_low_f32(hp)), ic1[3], ic2[3], highA1, highA2, highA3, k, lp, bp, hp);
+            const float32x4_t midAndHigh = vcombine_f32(vget_low_f32(lp), vget_high_f32(hp));
+
+            // weight the bands, then fold lanes 2-3 onto lanes 0-1
+            const float32x4_t mixed = vmlaq_f32(vmulq_f32(midHighGain, midAndHigh), lowGain, allPassed);
+            const float32x2_t y = vadd_f32(vget_low_f32(mixed), vget_high_f32(mixed));
+            left[i] = vget_lane_f32(y, 0);
+            right[i] = vget_lane_f32(y, 1);
+        }
+
+        for (int stage = 0; stage < 4; ++stage)
+        {
+            vst1q_f32(state + stage * 8, ic1[stage]);
+            vst1q_f32(state + stage * 8 + 4, ic2[stage]);
+        }
+    }
+
+    float kWeightedPowerStereoNEON(const float* left, const float* right, int num, float* state,
+                                   const DSPKernels::KWeightingCoefficients& c)
+    {
+        const float32x2_t shelfB0 = vdup_n_f32(c.shelfB0), shelfB1 = vdup_n_f32(c.shelfB1), shelfB2 = vdup_n_f32(c.shelfB2);
+        const float32x2_t shelfA1 = vdup_n_f32(c.shelfA1), shelfA2 = vdup_n_f32(c.shelfA2);
+        const float32x2_t highPassB0 = vdup_n_f32(c.highPassB0), highPassB1 = vdup_n_f32(c.highPassB1), highPassB2 = vdup_n_f32(c.highPassB2);
+        const float32x2_t highPassA1 = vdup_n_f32(c.highPassA1), highPassA2 = vdup_n_f32(c.highPassA2);
+        // lane 0 is left, lane 1 is right
+        float32x2_t shelf1 = vld1_f32(state);
+        float32x2_t shelf2 = vld1_f32(state + 2);
+        float32x2_t highPass1 = vld1_f32(state + 4);
+        float32x2_t highPass2 = vld1_f32(state + 6);
+        float32x2_t sum = vdup_n_f32(0.0f);
+
+        for (int i = 0; i < num; ++i)
+        {
+            const float32x2_t x = vset_lane_f32(right[i], vdup_n_f32(left[i]), 1);
+            const float32x2_t shelf = vmla_f32(shelf1, shelfB0, x);
+            shelf1 = vmls_f32(vmla_f32(shelf2, shelfB1, x), shelfA1, shelf);
+            shelf2 = vmls_f32(vmul_f32(shelfB2, x), shelfA2, shelf);
+            const float32x2_t y = vmla_f32(highPass1, highPassB0, shelf);
+            highPass1 = vmls_f32(vmla_f32(highPass2, highPassB1, shelf), highPassA1, y);
+            highPass2 = vmls_f32(vmul_f32(highPassB2, shelf), highPassA2, y);
+            sum = vmla_f32(sum, y, y);
+        }
+
+        vst1_f32(state, shelf1);
+        vst1_f32(state + 2, shelf2);
+        vst1_f32(state + 4, highPass1);
+        vst1_f32(state + 6, highPass2);
+        return vget_lane_f32(vpadd_f32(sum, sum), 0);
+    }
+
+    void mixWithGainRampsNEON(float* dest, const float* const* sources, int numSources,
+                              const float* startGains, const float* endGains, int num)
+    {
+        const float step = num > 0 ? 1.0f / num : 0.0f;
+        // each source's gain for the next four samples, and how far it moves every four
+        float32x4_t gains[DSPKernels::maxMixSources], gainSteps[DSPKernels::maxMixSources];
+        const float rampValues[4] = { 1.0f, 2.0f, 3.0f, 4.0f };
+        const float32x4_t ramp = vld1q_f32(rampValues);
+        for (int source = 0; source < numSources; ++source)
+        {
+            const float perSample = (endGains[source] - startGains[source]) * step;
+            gains[source] = vmlaq_n_f32(vdupq_n_f32(startGains[source]), ramp, perSample);
+            gainSteps[source] = vdupq_n_f32(perSample * 4.0f);
+        }
+        int i = 0;
+        for (; i + 4 <= num; i += 4)
+        {
+            float32x4_t sum = vdupq_n_f32(0.0f);
+            for (int source = 0; source < numSources; ++source)
+            {
+                sum = vmlaq_f32(sum, gains[source], vld1q_f32(sources[source] + i));
+                gains[source] = vaddq_f32(gains[source], gainSteps[source]);
+            }
+            vst1q_f32(dest + i, sum);
+        }
+        mixWithGainRampsTail(dest, sources, numSources, startGains, endGains, i, num);
+    }
+   #endif
+
+    //==============================================================================
+    /** the set of kernels chosen for this CPU, picked once on first use */
+    struct KernelTable
+    {
+        float (*dotProduct)(const float*, const float*, int);
+        void (*interpolate)(float*, const float*, const float*, float, int);
+        void (*stateVariableFilterStereo)(float*, float*, int, float*, const DSPKernels::FilterCoefficients&, const DSPKernels::FilterCoefficients&);
+        void (*isolatorStereo)(float*, float*, int, float*, const DSPKernels::CrossoverCoefficients&, const DSPKernels::BandGains&, const DSPKernels::BandGains&);
+        float (*kWeightedPowerStereo)(const float*, const float*, int, float*, const DSPKernels::KWeightingCoefficients&);
+        void (*mixWithGainRamps)(float*, const float* const*, int, const float*, const float*, int);
+        const char* name;
+    };
+
+    KernelTable chooseKernels()
+    {
+       #if JUCE_INTEL
+        if (juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3())
+        {
+            return {dotProductAVX2, interpolateAVX2, stateVariableFilterStereoSSE, isolatorStereoSSE, kWeightedPowerStereoSSE, mixWithGainRampsAVX2, "AVX2"};
+        }
+        return {dotProductSSE, interpolateSSE, stateVariableFilterStereoSSE, isolatorStereoSSE, kWeightedPowerStereoSSE, mixWithGainRampsSSE, "SSE"};
+       #elif DSPKERNELS_USE_NEON
+        return {dotProductNEON, interpolateNEON, stateVariableFilterStereoNEON, isolatorStereoNEON, kWeightedPowerStereoNEON, mixWithGainRampsNEON, "NEON"};
+       #else
+        return {dotProductScalar, interpolateScalar, stateVariableFilterStereoScalar, isolatorStereoScalar, kWeightedPowerStereoScalar, mixWithGainRampsScalar, "scalar"};
+       #endif
+    }
+
+    const KernelTable& getKernels()
+    {
+        static const KernelTable kernels = chooseKernels();
+        return kernels;
+    }
+}
+
+float DSPKernels::dotProduct(const float* a, const float* b, int num)
+{
+    return getKernels().dotProduct(a, b, num);
+}
+
+void DSPKernels::interpolate(float* dest, const float* a, const float* b, float amount, int num)
+{
+    getKernels().interpolate(dest, a, b, amount, num);
+}
+
+void DSPKernels::stateVariableFilterStereo(float* left, float* right, int num, float* state, const FilterCoefficients& start, const FilterCoefficients& end)
+{
+    getKernels().stateVariableFilterStereo(left, right, num, state, start, end);
+}
+
+void DSPKernels::isolatorStereo(float* left, float* right, int num, float* state, const CrossoverCoefficients& coefficients, const BandGains& start, const BandGains& end)
+{
+    getKernels().isolatorStereo(left, right, num, state, coefficients, start, end);
+}
+
+float DSPKernels::kWeightedPowerStereo(const float* left, const float* right, int num, float* state, const KWeightingCoefficients& coefficients)
+{
+    return getKernels().kWeightedPowerStereo(left, right, num, state, coefficients);
+}
+
+void DSPKernels::mixWithGainRamps(float* dest, const float* const* sources, int numSources, const float* startGains, const float* endGains, int num)
+{
+    jassert(numSources <= maxMixSources);
+    getKernels().mixWithGainRamps(dest, sources, juce::jmin(numSources, maxMixSources), startGains, endGains, num);
+}
+
+const char* DSPKernels::getInstructionSetName()
+{
+    return getKernels().name;
+}
@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+    DSPKernels.h
+    Created: 18 Oct 2026 3:21:40pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/** hot inner loops shared by the deck's signal chain.
+ each one picks the widest instruction set the CPU running the app supports - AVX2/FMA or SSE on Intel, NEON on ARM,
+ plain C++ anywhere else - so callers never need to care which one they got */
+namespace DSPKernels
+{
+    /** most sources mixWithGainRamps takes in one pass - one per deck */
+    constexpr int maxMixSources = 8;
+
+    /** coefficients of a TPT state variable filter and how much of each of its outputs to mix in - see DJFilter */
+    struct FilterCoefficients
+    {
+        float a1 = 1.0f;
+        float a2 = 0.0f;
+        float a3 = 0.0f;
+        /** damping, one over the resonance */
+        float k = 1.0f;
+        float dry = 1.0f;
+        float lowPass = 0.0f;
+        float highPass = 0.0f;
+    };
+
+    /** coefficients of the isolator's two crossovers, each a pair of Butterworth TPT state variable filters - see IsolatorEQ */
+    struct CrossoverCoefficients
+    {
+        float lowA1 = 1.0f;
+        float lowA2 = 0.0f;
+        float lowA3 = 0.0f;
+        float highA1 = 1.0f;
+        float highA2 = 0.0f;
+        float highA3 = 0.0f;
+        /** damping, the square root of two for Butterworth */
+        float k = 1.4142135f;
+    };
+
+    /** linear gains of the isolator's three bands */
+    struct BandGains
+    {
+        float low = 1.0f;
+        float mid = 1.0f;
+        float high = 1.0f;
+    };
+
+    /** coefficients of the ITU-R BS.1770 K-weighting filter - a high shelf then a high pass, each a biquad normalised so a0 is 1 - see LoudnessAnalyser */
+    struct KWeightingCoefficients
+    {
+        float shelfB0 = 1.0f;
+        float shelfB1 = 0.0f;
+        float shelfB2 = 0.0f;
+        float shelfA1 = 0.0f;
+        float shelfA2 = 0.0f;
+        float highPassB0 = 1.0f;
+        float highPassB1 = 0.0f;
+        float highPassB2 = 0.0f;
+        float highPassA1 = 0.0f;
+        float highPassA2 = 0.0f;
+    };
+
+    /** inputs: first array (const float*); second array (const float*); number of elements (int) | outputs: sum of the element-wise products (float) */
+    float dotProduct(const float* a, const float* b, int num);
+    /** inputs: array to write to (float*); first array (const float*); second array (const float*); amount of the second array to blend in - with 0 being all of a and 1 being all of b (float); number of elements (int)
+     writes a + (b - a) * amount for every element */
+    void interpolate(float* dest, const float* a, const float* b, float amount, int num);
+    /** inputs: left channel, filtered in place (float*); right channel, filtered in place (float*); number of samples (int); filter memory - first integrator left and right, then second integrator left and right (float[4]); coefficients at the start of the block (const FilterCoefficients&); coefficients at the end of the block (const FilterCoefficients&)
+     runs a state variable filter over both channels at once, one channel per SIMD lane, sliding every coefficient from start to end across the block */
+    void stateVariableFilterStereo(float* left, float* right, int num, float* state, const FilterCoefficients& start, const FilterCoefficients& end);
+    /** inputs: left channel, processed in place (float*); right channel, processed in place (float*); number of samples (int); filter memory for the four crossover stages (float[32]); crossover coefficients (const CrossoverCoefficients&); band gains at the start of the block (const BandGains&); band gains at the end of the block (const BandGains&)
+     splits both channels into three bands with fourth-order Linkwitz-Riley crossovers and mixes them back at the given gains, sliding the gains across the block.
+     channels and bands share SIMD lanes, so every sample costs the same whatever the gains are */
+    void isolatorStereo(float* left, float* right, int num, float* state, const CrossoverCoefficients& coefficients, const BandGains& start, const BandGains& end);
+    /** inputs: left channel (const float*); right channel (const float*); number of samples (int); filter memory - shelf then high pass, two states each, left and right (float[8]); coefficients (const KWeightingCoefficients&) | outputs: sum of the squares of both K-weighted channels (float)
+     K-weights both channels at once, one channel per SIMD lane, and sums the power as it goes - the input is left as it was */
+    float kWeightedPowerStereo(const float* left, const float* right, int num, float* state, const KWeightingCoefficients& coefficients);
+    /** inputs: array to write the mix to (float*); arrays to mix (const float* const*); number of arrays to mix, up to maxMixSources (int); gain of each array at the start of the block (const float*); gain of each array at the end of the block (const float*); number of elements (int)
+     writes the sum of every source times its gain, each gain sliding from start to end across the block - one pass over the output, whatever the number of sources */
+    void mixWithGainRamps(float* dest, const float* const* sources, int numSources, const float* startGains, const float* endGains, int num);
+    /** outputs: name of the instruction set the kernels are running on (const char*) */
+    const char* getInstructionSetName();
+}
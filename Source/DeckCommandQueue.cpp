@@ -0,0 +1,134 @@
+/*
+  ==============================================================================
+
+    DeckCommandQueue.cpp
+    Created: 18 Oct 2026 2:03:51pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#include "DeckCommandQueue.h"
+
+DeckCommandQueue::DeckCommandQueue()
+{
+}
+
+DeckCommandQueue::~DeckCommandQueue()
+{
+}
+
+bool DeckCommandQueue::push(const Command& command)
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+    if (size1 + size2 == 0)
+    {
+        DBG("DeckCommandQueue::push queue full, command dropped");
+        return false;
+    }
+    // only one slot was asked for, so it is always in the first region
+    commands[static_cast<size_t>(start1)] = command;
+    fifo.finishedWrite(1);
+    return true;
+}
+
+DeckCommandQueue::PendingChanges DeckCommandQueue::drain()
+{
+    PendingChanges changes;
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+
+    // walk both regions of the ring in order, later commands overwriting earlier ones
+    auto collapse = [this, &changes](int start, int size)
+    {
+        for (int i = start; i < start + size; ++i)
+        {
+            const auto& command = commands[static_cast<size_t>(i)];
+            auto isScheduled = command.time >= 0 || command.quantize != MasterClock::Quantize::none;
+            switch (command.type)
+            {
+                case CommandType::gain:
+                    changes.hasGain = true;
+                    changes.gain = command.value1;
+                    break;
+                case CommandType::speed:
+                    changes.hasSpeed = true;
+                    changes.speed = command.value1;
+                    break;
+                case CommandType::position:
+                    if (isScheduled)
+                    {
+                        changes.scheduledPosition = {true, command.time, command.quantize, command.value1};
+                    }
+                    else {
+                        changes.hasPosition = true;
+                        changes.position = command.value1;
+                        changes.scheduledPosition = {};
+                        changes.cancelScheduledPosition = true;
+                    }
+                    break;
+                case CommandType::filter:
+                    changes.hasFilter = true;
+                    changes.filterPosition = static_cast<float>(command.value1);
+                    changes.resonance = static_cast<float>(command.value2);
+                    break;
+                case CommandType::start:
+                case CommandType::stop:
+                    if (isScheduled)
+                    {
+                        changes.scheduledTransport = {true, command.time, command.quantize, command.type == CommandType::start ? 1.0 : 0.0};
+                    }
+                    else {
+                        changes.hasTransportChange = true;
+                        changes.shouldPlay = command.type == CommandType::start;
+                        changes.scheduledTransport = {};
+                        changes.cancelScheduledTransport = true;
+                    }
+                    break;
+                case CommandType::keyLock:
+                    changes.hasKeyLock = true;
+                    changes.keyLock = command.value1 != 0.0;
+                    break;
+                case CommandType::keyShift:
+                    changes.hasKeyShift = true;
+                    changes.keyShift = static_cast<float>(command.value1);
+                    break;
+                case CommandType::eqGain:
+                {
+                    // value1 carries the band, value2 its gain
+                    auto band = juce::jlimit(0, 2, static_cast<int>(command.value1));
+                    changes.hasEQGain[band] = true;
+                    changes.eqGain[band] = static_cast<float>(command.value2);
+                    break;
+                }
+                case CommandType::scratch:
+                    changes.hasScratch = true;
+                    changes.scratching = command.value1 != 0.0;
+                    break;
+                case CommandType::scratchRate:
+                    changes.hasScratchRate = true;
+                    changes.scratchRate = command.value1;
+                    break;
+                case CommandType::sync:
+                    changes.hasSync = true;
+                    changes.sync = command.value1 != 0.0;
+                    break;
+                case CommandType::beatGrid:
+                    changes.hasBeatGrid = true;
+                    changes.bpm = command.value1;
+                    changes.firstBeat = command.value2;
+                    break;
+                case CommandType::trim:
+                    changes.hasTrim = true;
+                    changes.trim = static_cast<float>(command.value1);
+                    break;
+            }
+        }
+    };
+    collapse(start1, size1);
+    collapse(start2, size2);
+
+    fifo.finishedRead(size1 + size2);
+    return changes;
+}
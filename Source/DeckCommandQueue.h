@@ -0,0 +1,122 @@
+/*
+  ==============================================================================
+
+    DeckCommandQueue.h
+    Created: 18 Oct 2026 2:03:51pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "MasterClock.h"
+#include <array>
+
+class DeckCommandQueue
+{
+public:
+    /** the deck parameters and transport actions that can be sent to the audio thread */
+    enum class CommandType
+    {
+        gain,
+        speed,
+        position,
+        filter,
+        start,
+        stop,
+        keyLock,
+        keyShift,
+        eqGain,
+        scratch,
+        scratchRate,
+        sync,
+        beatGrid,
+        trim
+    };
+
+    /** one parameter change, as pushed by the message thread */
+    struct Command
+    {
+        CommandType type;
+        double value1 = 0.0;
+        double value2 = 0.0;
+        /** start, stop and position only - when to act, in output samples of the master clock, -1 for straight away */
+        juce::int64 time = -1;
+        /** start, stop and position only - line the change up with the master clock's next beat or bar instead */
+        MasterClock::Quantize quantize = MasterClock::Quantize::none;
+    };
+
+    /** a transport change or jump waiting for its time to come */
+    struct ScheduledChange
+    {
+        bool pending = false;
+        juce::int64 time = -1;
+        MasterClock::Quantize quantize = MasterClock::Quantize::none;
+        /** for transport changes, 1 to start and 0 to stop - for jumps, the position in seconds */
+        double value = 0.0;
+    };
+
+    /** every change waiting in the queue, collapsed so only the latest value of each parameter is kept */
+    struct PendingChanges
+    {
+        bool hasGain = false;
+        double gain = 0.0;
+        bool hasSpeed = false;
+        double speed = 0.0;
+        bool hasPosition = false;
+        double position = 0.0;
+        bool hasFilter = false;
+        float filterPosition = 0.0f;
+        float resonance = 0.0f;
+        bool hasTransportChange = false;
+        bool shouldPlay = false;
+        bool hasKeyLock = false;
+        bool keyLock = false;
+        bool hasKeyShift = false;
+        float keyShift = 0.0f;
+        /** one flag and gain per isolator band - low, mid, high */
+        bool hasEQGain[3] = {};
+        float eqGain[3] = {};
+        bool hasScratch = false;
+        bool scratching = false;
+        bool hasScratchRate = false;
+        double scratchRate = 0.0;
+        bool hasSync = false;
+        bool sync = false;
+        /** tempo of the track in beats per minute, and where its first beat falls in seconds */
+        bool hasBeatGrid = false;
+        double bpm = 0.0;
+        double firstBeat = 0.0;
+        /** trim for the loaded track's loudness - linear gain */
+        bool hasTrim = false;
+        float trim = 1.0f;
+        /** timed or quantised transport change and jump - the latest of each wins, and an immediate one cancels any still waiting */
+        ScheduledChange scheduledTransport;
+        bool cancelScheduledTransport = false;
+        ScheduledChange scheduledPosition;
+        bool cancelScheduledPosition = false;
+    };
+
+    /**
+     constructor */
+    DeckCommandQueue();
+    /**
+     destructor */
+    ~DeckCommandQueue();
+    /** inputs: the change to send (Command) | outputs: false if the queue was full and the change was dropped (bool)
+     wait-free - call from the message thread only */
+    bool push(const Command& command);
+    /** outputs: the latest value of every parameter changed since the last call (PendingChanges)
+     empties the queue in one go, however many slider moves piled up - wait-free, call from the audio thread only */
+    PendingChanges drain();
+
+private:
+    static constexpr int capacity = 1024;
+
+    juce::AbstractFifo fifo{capacity};
+    std::array<Command, capacity> commands;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DeckCommandQueue)
+};
@@ -0,0 +1,341 @@
+/*
+  ==============================================================================
+
+    DeckEngine.cpp
+    Created: 19 Oct 2026 3:26:14pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#include "DeckEngine.h"
+
+DeckEngine::DeckEngine(juce::AudioFormatManager& _formatManager,
+                       DecodedTrackCache& _trackCache,
+                       int numDecks)
+    : formatManager(_formatManager),
+    trackCache(_trackCache)
+{
+    // left-hand decks on A, right-hand decks on B
+    for (size_t i = 0; i < crossfaderSides.size(); ++i)
+    {
+        crossfaderSides[i].store(i % 2 == 0 ? CrossfaderSide::a : CrossfaderSide::b);
+    }
+    for (auto& gain : faderGains)
+    {
+        gain.setCurrentAndTargetValue(1.0f);
+    }
+    for (auto& time : deckRenderMicroseconds)
+    {
+        time.store(0.0f);
+    }
+    setNumDecks(numDecks);
+}
+
+DeckEngine::~DeckEngine()
+{
+    renderPool.stop();
+}
+
+void DeckEngine::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
+{
+    const juce::ScopedLock sl(deckLock);
+    preparedBlockSize = samplesPerBlockExpected;
+    preparedSampleRate = sampleRate;
+    masterClock.prepare(sampleRate);
+    // a buffer per deck to render into ahead of the mix
+    for (auto& buffer : deckBuffers)
+    {
+        buffer.setSize(2, samplesPerBlockExpected);
+    }
+    mixBlockSize = samplesPerBlockExpected;
+    numRenderedDecks = 0;
+    // faders glide over 20ms so moves never zipper
+    for (auto& gain : faderGains)
+    {
+        gain.reset(sampleRate, 0.02);
+    }
+    crossfader.reset(sampleRate, 0.02);
+    crossfader.setCurrentAndTargetValue(crossfaderPosition.load());
+    // a worker per spare core, up to one fewer than the most decks - the audio thread renders too
+    renderPool.start(juce::jlimit(0, maxDecks - 1, juce::SystemStats::getNumCpus() - 2));
+    serialBlocksRemaining = 0;
+    // prepare every deck created so far, parked ones too, so they are ready if the set grows again
+    for (auto& deck : decks)
+    {
+        if (deck != nullptr)
+        {
+            deck->prepareToPlay(samplesPerBlockExpected, sampleRate);
+        }
+    }
+}
+
+void DeckEngine::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    // decks dropped from the set stay in the mix until they have faded out and their tails have died away
+    auto numDecks = juce::jmax(numActiveDecks.load(), numRenderedDecks);
+    auto numChannels = juce::jmin(bufferToFill.buffer->getNumChannels(), 2);
+    if (mixBlockSize <= 0)
+    {
+        bufferToFill.clearActiveBufferRegion();
+        return;
+    }
+    crossfader.setTargetValue(crossfaderPosition.load());
+
+    // the device may ask for more than it promised - work through the block in pieces the deck buffers can hold
+    for (int done = 0; done < bufferToFill.numSamples; )
+    {
+        auto numSamples = juce::jmin(bufferToFill.numSamples - done, mixBlockSize);
+        auto crossfaderStart = crossfader.getCurrentValue();
+        auto crossfaderEnd = crossfader.skip(numSamples);
+        renderDecks(numDecks, numSamples);
+
+        const float* sources[2][DSPKernels::maxMixSources];
+        float startGains[DSPKernels::maxMixSources];
+        float endGains[DSPKernels::maxMixSources];
+        int numSources = 0;
+        for (int i = 0; i < numDecks; ++i)
+        {
+            auto index = static_cast<size_t>(i);
+            auto& buffer = deckBuffers[index];
+            // a deck that missed the block may still be rendering, so it keeps heading for the last gain it published
+            if (!renderJobs[index].dropped)
+            {
+                faderGains[index].setTargetValue(renderJobs[index].channelGain);
+            }
+            auto faderStart = faderGains[index].getCurrentValue();
+            auto faderEnd = faderGains[index].skip(numSamples);
+            // idle decks leave their buffer alone and are left out of the mix, as do decks that missed the block
+            if (renderJobs[index].dropped || !renderJobs[index].rendered)
+            {
+                continue;
+            }
+            auto side = crossfaderSides[index].load();
+            startGains[numSources] = faderStart * getCrossfaderGain(crossfaderStart, side);
+            endGains[numSources] = faderEnd * getCrossfaderGain(crossfaderEnd, side);
+            sources[0][numSources] = buffer.getReadPointer(0);
+            sources[1][numSources] = buffer.getReadPointer(1);
+            ++numSources;
+        }
+
+        // one pass per channel applies every deck's gains and sums them straight into the output
+        for (int chan = 0; chan < numChannels; ++chan)
+        {
+            DSPKernels::mixWithGainRamps(bufferToFill.buffer->getWritePointer(chan, bufferToFill.startSample + done),
+                                         sources[chan], numSources, startGains, endGains, numSamples);
+        }
+        // the next piece starts that much later on the timeline
+        masterClock.advance(numSamples);
+        done += numSamples;
+    }
+    // a dropped deck that has gone quiet can be parked now - only ever from the top, so the decks still in use keep their places
+    auto numActive = numActiveDecks.load();
+    while (numDecks > numActive)
+    {
+        auto& job = renderJobs[static_cast<size_t>(numDecks - 1)];
+        if (job.dropped || job.rendered)
+        {
+            break;
+        }
+        --numDecks;
+    }
+    numRenderedDecks = numDecks;
+    // any channels past stereo stay silent
+    for (int chan = numChannels; chan < bufferToFill.buffer->getNumChannels(); ++chan)
+    {
+        bufferToFill.buffer->clear(chan, bufferToFill.startSample, bufferToFill.numSamples);
+    }
+}
+
+void DeckEngine::renderDecks(int numDecks, int numSamples)
+{
+    auto startTicks = juce::Time::getHighResolutionTicks();
+    for (int i = 0; i < numDecks; ++i)
+    {
+        auto index = static_cast<size_t>(i);
+        if (DeckRenderPool::isInFlight(renderJobs[index]))
+        {
+            // still on a worker from a block it ran late for - it sits this one out
+            continue;
+        }
+        renderJobs[index].deck = decks[index].get();
+        renderJobs[index].buffer = &deckBuffers[index];
+        renderJobs[index].numSamples = numSamples;
+        // the clock moves on once the block is mixed, possibly while a late deck is still reading it - so each deck gets its own copy
+        decks[index]->setClockPosition(masterClock.getPosition());
+    }
+
+    auto parallel = parallelRenderingEnabled.load() && renderPool.getNumWorkers() > 0 && numDecks > 1 && serialBlocksRemaining == 0;
+    if (parallel)
+    {
+        // leave the rest of the block's time for the mix and whatever else the device callback has to do
+        auto budget = deadlineFraction * numSamples / preparedSampleRate;
+        auto deadline = startTicks + juce::Time::secondsToHighResolutionTicks(budget);
+        if (!renderPool.render(renderJobs.data(), numDecks, deadline))
+        {
+            // the workers aren't keeping up - maybe they are being held off their cores - so go it alone for a second
+            serialBlocksRemaining = juce::jmax(1, static_cast<int>(preparedSampleRate / numSamples));
+        }
+    }
+    else {
+        DeckRenderPool::renderInPlace(renderJobs.data(), numDecks);
+        serialBlocksRemaining = juce::jmax(0, serialBlocksRemaining - 1);
+    }
+    renderedInParallel.store(parallel);
+
+    // keep running averages for anyone watching how the load is spread
+    for (int i = 0; i < numDecks; ++i)
+    {
+        auto index = static_cast<size_t>(i);
+        if (renderJobs[index].dropped)
+        {
+            continue;
+        }
+        auto average = deckRenderMicroseconds[index].load();
+        deckRenderMicroseconds[index].store(average + timingSmoothing * (renderJobs[index].renderMicroseconds - average));
+    }
+    auto elapsed = static_cast<float>(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1.0e6);
+    auto average = blockRenderMicroseconds.load();
+    blockRenderMicroseconds.store(average + timingSmoothing * (elapsed - average));
+    // background work backs off while the decks are close to their deadline
+    if (preparedSampleRate > 0.0)
+    {
+        jobScheduler.setAudioLoad(static_cast<float>(elapsed * 1.0e-6 * preparedSampleRate / numSamples));
+    }
+}
+
+void DeckEngine::releaseResources()
+{
+    const juce::ScopedLock sl(deckLock);
+    renderPool.stop();
+    for (auto& deck : decks)
+    {
+        if (deck != nullptr)
+        {
+            deck->releaseResources();
+        }
+    }
+    preparedBlockSize = 0;
+    preparedSampleRate = 0.0;
+    mixBlockSize = 0;
+}
+
+void DeckEngine::setNumDecks(int numDecks)
+{
+    const juce::ScopedLock sl(deckLock);
+    numDecks = juce::jlimit(minDecks, maxDecks, numDecks);
+    auto current = numActiveDecks.load();
+
+    if (numDecks < current)
+    {
+        // stop the decks being dropped and take them out of the set - the audio thread keeps rendering them until they have faded out
+        for (int i = numDecks; i < current; ++i)
+        {
+            decks[static_cast<size_t>(i)]->stop();
+        }
+        numActiveDecks.store(numDecks);
+        return;
+    }
+
+    for (int i = current; i < numDecks; ++i)
+    {
+        auto& deck = decks[static_cast<size_t>(i)];
+        if (deck == nullptr)
+        {
+            // new decks are built and prepared before the audio thread can see them
+            deck = std::make_unique<DJAudioPlayer>(formatManager, trackCache, jobScheduler, &masterClock);
+            if (preparedSampleRate > 0.0)
+            {
+                deck->prepareToPlay(preparedBlockSize, preparedSampleRate);
+            }
+        }
+    }
+    numActiveDecks.store(numDecks);
+}
+
+int DeckEngine::getNumDecks() const
+{
+    return numActiveDecks.load();
+}
+
+DJAudioPlayer* DeckEngine::getDeck(int index) const
+{
+    if (index < 0 || index >= numActiveDecks.load())
+    {
+        return nullptr;
+    }
+    return decks[static_cast<size_t>(index)].get();
+}
+
+void DeckEngine::setCrossfader(float position)
+{
+    // setter for crossfader
+    crossfaderPosition.store(juce::jlimit(-1.0f, 1.0f, position));
+}
+
+void DeckEngine::setCrossfaderSide(int index, CrossfaderSide side)
+{
+    // setter for crossfader assignment
+    if (index >= 0 && index < maxDecks)
+    {
+        crossfaderSides[static_cast<size_t>(index)].store(side);
+    }
+}
+
+float DeckEngine::getCrossfaderGain(float position, CrossfaderSide side)
+{
+    if (side == CrossfaderSide::thru)
+    {
+        return 1.0f;
+    }
+    // a quarter turn of cosine and sine - the squares of the two gains always add up to one
+    auto angle = (juce::jlimit(-1.0f, 1.0f, position) + 1.0f) * 0.25f * juce::MathConstants<float>::pi;
+    return side == CrossfaderSide::a ? std::cos(angle) : std::sin(angle);
+}
+
+void DeckEngine::setParallelRendering(bool shouldRenderInParallel)
+{
+    // setter for parallel rendering
+    parallelRenderingEnabled.store(shouldRenderInParallel);
+}
+
+bool DeckEngine::isRenderingInParallel() const
+{
+    return renderedInParallel.load();
+}
+
+float DeckEngine::getDeckRenderMicroseconds(int index) const
+{
+    if (index < 0 || index >= maxDecks)
+    {
+        return 0.0f;
+    }
+    return deckRenderMicroseconds[static_cast<size_t>(index)].load();
+}
+
+float DeckEngine::getBlockRenderMicroseconds() const
+{
+    return blockRenderMicroseconds.load();
+}
+
+MasterClock& DeckEngine::getMasterClock()
+{
+    return masterClock;
+}
+
+JobScheduler& DeckEngine::getJobScheduler()
+{
+    return jobScheduler;
+}
+
+bool DeckEngine::loadToDeck(int index, juce::URL audioURL, std::function<void(bool)> onLoaded, std::shared_ptr<const SeekIndex> seekIndex, DJAudioPlayer::TrackSettings settings)
+{
+    auto* deck = getDeck(index);
+    if (deck == nullptr)
+    {
+        DBG("DeckEngine::loadToDeck there is no deck " << index);
+        return false;
+    }
+    deck->loadURLAsync(audioURL, std::move(onLoaded), std::move(seekIndex), std::move(settings));
+    return true;
+}
@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+    DeckEngine.h
+    Created: 19 Oct 2026 3:26:14pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DJAudioPlayer.h"
+#include "DecodedTrackCache.h"
+#include "DeckRenderPool.h"
+#include "MasterClock.h"
+#include "JobScheduler.h"
+#include <array>
+#include <atomic>
+#include <functional>
+
+/** owns the decks and mixes them to the output.
+ the number of decks can be changed while audio is running. decks dropped from the set are stopped and kept in the mix until they have faded out,
+ then parked rather than destroyed, so the audio thread never sees one disappear, and come back as they were if the set grows again.
+ decks are rendered side by side, then a single fused pass applies each deck's channel fader and crossfader gain and sums them into the output,
+ so the output is written once per block however many decks there are. stopped decks are skipped entirely.
+ with parallel rendering on, the decks are shared out between the audio thread and a pool of worker threads. if the pool misses its deadline
+ the engine renders serially on the audio thread for a while before trying the workers again */
+class DeckEngine :  public juce::AudioSource
+{
+public:
+    /** which side of the crossfader a deck is on */
+    enum class CrossfaderSide
+    {
+        a,
+        thru,
+        b
+    };
+
+    /** fewest decks the engine runs */
+    static constexpr int minDecks = 2;
+    /** most decks the engine runs */
+    static constexpr int maxDecks = 8;
+
+    /** inputs: reference to the audio format manager (juce::AudioFormatManager&); reference to the decoded track cache shared by all decks (DecodedTrackCache&); number of decks to start with (int)
+     constructor */
+    DeckEngine(juce::AudioFormatManager& _formatManager,
+               DecodedTrackCache& _trackCache,
+               int numDecks = minDecks);
+    /**
+     destructor */
+    ~DeckEngine() override;
+    /** inputs: expected number of samples per audio block [buffer] (int); sample rate of the output (double) | prepares every deck and the mix buffer */
+    void prepareToPlay (int samplesPerBlockExpected, double sampleRate) override;
+    /** inputs: reference to the target channel buffer (juce::AudioSourceChannelInfo&) | renders every deck that is playing and mixes them into the buffer */
+    void getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill) override;
+    /** releases every deck's resources */
+    void releaseResources() override;
+    /** inputs: number of decks, from minDecks to maxDecks (int) | grows or shrinks the set of decks - message thread only */
+    void setNumDecks(int numDecks);
+    /** outputs: number of decks in use (int) */
+    int getNumDecks() const;
+    /** inputs: index of the deck, from 0 (int) | outputs: the deck, nullptr if there is no deck with that index (DJAudioPlayer*) */
+    DJAudioPlayer* getDeck(int index) const;
+    /** inputs: index of the deck to load (int); URL to audio file to be loaded (juce::URL); optional function called on the message thread when the load finishes (std::function<void(bool)>); optional seek index of the file (std::shared_ptr<const SeekIndex>); optional hot cues, beat grid, loudness and cue in of the track (DJAudioPlayer::TrackSettings) | outputs: false if there is no deck with that index (bool)
+     loads a track onto any deck without blocking, see DJAudioPlayer::loadURLAsync */
+    bool loadToDeck(int index, juce::URL audioURL, std::function<void(bool)> onLoaded = nullptr, std::shared_ptr<const SeekIndex> seekIndex = nullptr, DJAudioPlayer::TrackSettings settings = {});
+    /** inputs: crossfader position - from -1 [all A] through 0 [both 3dB down] to 1 [all B] (float) | sets the crossfader
+     the two sides follow a constant power law, so the summed power of two uncorrelated tracks stays level all the way across */
+    void setCrossfader(float position);
+    /** inputs: index of the deck, from 0 (int); side of the crossfader to put it on (CrossfaderSide) | assigns a deck to the crossfader - decks start alternating A, B, A, B... */
+    void setCrossfaderSide(int index, CrossfaderSide side);
+
+    /** inputs: crossfader position - from -1 to 1 (float); side of the crossfader (CrossfaderSide) | outputs: gain for that side at that position (float) */
+    static float getCrossfaderGain(float position, CrossfaderSide side);
+
+    /** inputs: flag stating whether decks may be rendered in parallel on worker threads (bool) | turns parallel rendering on or off - safe to call while audio is running */
+    void setParallelRendering(bool shouldRenderInParallel);
+    /** outputs: flag stating whether the last block was rendered in parallel (bool) */
+    bool isRenderingInParallel() const;
+    /** inputs: index of the deck, from 0 (int) | outputs: average time the deck takes to render a block - in microseconds (float) */
+    float getDeckRenderMicroseconds(int index) const;
+    /** outputs: average time taken to render every deck for a block, wall clock - in microseconds (float)
+     compare with the sum of getDeckRenderMicroseconds to see how well the decks are spread over the workers */
+    float getBlockRenderMicroseconds() const;
+    /** outputs: the clock every deck's timed and quantised commands are lined up with (MasterClock&) */
+    MasterClock& getMasterClock();
+    /** outputs: the scheduler deck loads and library analysis share, throttled whenever the decks run close to their deadline (JobScheduler&) */
+    JobScheduler& getJobScheduler();
+
+private:
+    /** inputs: number of decks to render (int); number of samples to render (int)
+     renders every active deck into its own buffer, in parallel if possible, and records how long it took */
+    void renderDecks(int numDecks, int numSamples);
+
+    /** share of a block's duration the decks have to be rendered in when rendering in parallel */
+    static constexpr double deadlineFraction = 0.6;
+    /** how quickly the render time averages follow each block */
+    static constexpr float timingSmoothing = 0.05f;
+
+    juce::AudioFormatManager& formatManager;
+    DecodedTrackCache& trackCache;
+    /** runs deck loads, declared before the decks that queue jobs on it */
+    JobScheduler jobScheduler;
+    /** counts the samples mixed, declared before the decks that hold on to it */
+    MasterClock masterClock;
+    /** decks are created on first use and kept until the engine goes */
+    std::array<std::unique_ptr<DJAudioPlayer>, maxDecks> decks;
+    std::atomic<int> numActiveDecks{0};
+    /** decks still being rendered - more than are active while dropped decks fade out - audio thread only */
+    int numRenderedDecks = 0;
+    /** guards creating and preparing decks against the device starting or stopping - never taken on the audio thread */
+    juce::CriticalSection deckLock;
+    /** one buffer per deck, so every deck can be rendered before the single mixing pass */
+    std::array<juce::AudioBuffer<float>, maxDecks> deckBuffers;
+    /** channel faders, smoothed from block to block */
+    std::array<juce::SmoothedValue<float>, maxDecks> faderGains;
+    std::array<std::atomic<CrossfaderSide>, maxDecks> crossfaderSides;
+    std::atomic<float> crossfaderPosition{0.0f};
+    juce::SmoothedValue<float> crossfader;
+    int mixBlockSize = 0;
+    /** worker threads for parallel rendering, started in prepareToPlay and stopped in releaseResources so the audio thread never sees them change */
+    DeckRenderPool renderPool;
+    std::array<DeckRenderPool::Job, maxDecks> renderJobs;
+    std::atomic<bool> parallelRenderingEnabled{true};
+    std::atomic<bool> renderedInParallel{false};
+    /** blocks left to render serially after the workers missed a deadline */
+    int serialBlocksRemaining = 0;
+    std::array<std::atomic<float>, maxDecks> deckRenderMicroseconds;
+    std::atomic<float> blockRenderMicroseconds{0.0f};
+    int preparedBlockSize = 0;
+    double preparedSampleRate = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DeckEngine)
+};
@@ -21,12 +21,35 @@ DeckGUI::DeckGUI(DJAudioPlayer* _player,
     // reveal different sub components
     addAndMakeVisible(playButton);
     addAndMakeVisible(stopButton);
+    addAndMakeVisible(quantizeButton);
+    addAndMakeVisible(loopInButton);
+    addAndMakeVisible(loopOutButton);
+    addAndMakeVisible(autoLoopButton);
+    addAndMakeVisible(halveLoopButton);
+    addAndMakeVisible(doubleLoopButton);
+    addAndMakeVisible(loopRollButton);
+    for (int cue = 0; cue < DJAudioPlayer::numHotCues; ++cue)
+    {
+        auto* cueButton = hotCueButtons.add(new juce::TextButton(juce::String(cue + 1)));
+        // light cues up once they are set
+        cueButton->setColour(juce::TextButton::buttonOnColourId, juce::Colours::orange);
+        cueButton->addListener(this);
+        addAndMakeVisible(cueButton);
+    }
     addAndMakeVisible(volSlider);
     addAndMakeVisible(speedSlider);
+    addAndMakeVisible(keyLockButton);
+    addAndMakeVisible(syncButton);
+    addAndMakeVisible(reverseButton);
+    addAndMakeVisible(scratchSlider);
+    addAndMakeVisible(keyShiftSlider);
     addAndMakeVisible(posSlider);
     addAndMakeVisible(waveformDisplay);
     addAndMakeVisible(freqDial);
     addAndMakeVisible(resDial);
+    addAndMakeVisible(lowDial);
+    addAndMakeVisible(midDial);
+    addAndMakeVisible(highDial);
     
     // My default styles
     getLookAndFeel().setColour(juce::Slider::thumbColourId, juce::Colours::blue);
@@ -36,25 +59,61 @@ DeckGUI::DeckGUI(DJAudioPlayer* _player,
     
     // make play button green to indicate purpose
     playButton.setColour(juce::TextButton::buttonColourId, juce::Colours::green);
+    // light the loop button up while a loop is playing
+    autoLoopButton.setColour(juce::TextButton::buttonOnColourId, juce::Colours::orange);
     
     // set control readouts to be above controls
     volSlider.setTextBoxStyle(juce::Slider::TextEntryBoxPosition::TextBoxAbove, true, 100, 20);
     speedSlider.setTextBoxStyle(juce::Slider::TextEntryBoxPosition::TextBoxAbove, true, 100, 20);
+    keyShiftSlider.setTextBoxStyle(juce::Slider::TextEntryBoxPosition::TextBoxAbove, true, 100, 20);
     posSlider.setTextBoxStyle(juce::Slider::TextEntryBoxPosition::TextBoxAbove, true, 100, 20);
+    scratchSlider.setTextBoxStyle(juce::Slider::TextEntryBoxPosition::TextBoxAbove, true, 100, 20);
     
-    // make high pass filter dials rotary
+    // make filter dials rotary
     freqDial.setSliderStyle(juce::Slider::SliderStyle::Rotary);
     resDial.setSliderStyle(juce::Slider::SliderStyle::Rotary);
     
+    // make isolator EQ dials rotary - fully left kills the band, double-click to return to flat
+    for (auto* dial : {&lowDial, &midDial, &highDial})
+    {
+        dial->setSliderStyle(juce::Slider::SliderStyle::Rotary);
+        dial->setRange(DJAudioPlayer::eqKillDecibels, 6.0, 0.1);
+        dial->setValue(0.0);
+        dial->setDoubleClickReturnValue(true, 0.0);
+        dial->textFromValueFunction = [](double value)
+        {
+            if (value <= DJAudioPlayer::eqKillDecibels)
+            {
+                return juce::String("Kill");
+            }
+            return juce::String(value, 1) + "dB";
+        };
+        dial->updateText();
+        dial->addListener(this);
+    }
+    
     // set ranges and values for sliders and dials
-    freqDial.setRange(20.0f, 20000.0f);
-    freqDial.setTextValueSuffix("Hz");
-    freqDial.setNumDecimalPlacesToDisplay(2);
-    freqDial.setValue(20.0f);
+    // filter dial is bipolar - low-pass to the left, high-pass to the right, off in the middle - double-click to centre
+    freqDial.setRange(-1.0, 1.0);
+    freqDial.setValue(0.0);
+    freqDial.setDoubleClickReturnValue(true, 0.0);
+    freqDial.textFromValueFunction = [](double value)
+    {
+        auto percent = juce::String(juce::roundToInt(std::abs(value) * 100.0)) + "%";
+        if (value < -0.02)
+        {
+            return "LP " + percent;
+        }
+        if (value > 0.02)
+        {
+            return "HP " + percent;
+        }
+        return juce::String("Off");
+    };
+    freqDial.updateText();
     resDial.setRange(0.3f, 20.0f);
     resDial.setValue(0.71f);
     resDial.setNumDecimalPlacesToDisplay(2);
-    freqDial.setSkewFactorFromMidPoint(1000.0f);
     volSlider.setRange(0.0, 100.0);
     volSlider.setValue(50.0);
     volSlider.setNumDecimalPlacesToDisplay(0);
@@ -63,9 +122,30 @@ DeckGUI::DeckGUI(DJAudioPlayer* _player,
     speedSlider.setNumDecimalPlacesToDisplay(2);
     speedSlider.setValue(1.0);
     speedSlider.setTextValueSuffix("x Speed");
+    // key shift in semitones, cents as the hundredths - double-click to return to the original key
+    keyShiftSlider.setRange(-12.0, 12.0, 0.01);
+    keyShiftSlider.setNumDecimalPlacesToDisplay(2);
+    keyShiftSlider.setValue(0.0);
+    keyShiftSlider.setDoubleClickReturnValue(true, 0.0);
+    keyShiftSlider.setTextValueSuffix(" st Key");
     posSlider.setRange(0.0, 1.0);
     posSlider.setNumDecimalPlacesToDisplay(2);
     posSlider.setTextValueSuffix(" Position");
+    // scratching takes over from the speed while the jog is held, and springs back to the middle when let go
+    scratchSlider.setRange(-DJAudioPlayer::maxScratchRate, DJAudioPlayer::maxScratchRate);
+    scratchSlider.setNumDecimalPlacesToDisplay(2);
+    scratchSlider.setValue(0.0);
+    scratchSlider.setTextValueSuffix("x Scratch");
+    scratchSlider.onDragStart = [this]
+    {
+        player->setScratchRate(scratchSlider.getValue());
+        player->setScratching(true);
+    };
+    scratchSlider.onDragEnd = [this]
+    {
+        player->setScratching(false);
+        scratchSlider.setValue(0.0, juce::dontSendNotification);
+    };
     
     
     // add listeners to all interactive components
@@ -73,15 +153,27 @@ DeckGUI::DeckGUI(DJAudioPlayer* _player,
     resDial.addListener(this);
     playButton.addListener(this);
     stopButton.addListener(this);
+    quantizeButton.addListener(this);
+    loopInButton.addListener(this);
+    loopOutButton.addListener(this);
+    autoLoopButton.addListener(this);
+    halveLoopButton.addListener(this);
+    doubleLoopButton.addListener(this);
+    loopRollButton.addListener(this);
     volSlider.addListener(this);
     speedSlider.addListener(this);
+    keyLockButton.addListener(this);
+    syncButton.addListener(this);
+    reverseButton.addListener(this);
+    scratchSlider.addListener(this);
+    keyShiftSlider.addListener(this);
     posSlider.addListener(this);
     
     // set callback timer to broadcast 10 times every second
     // to keep animation smooth
     startTimer(100);
     
-    // update high pass filter with initial values
+    // update filter with initial values
     player->updateFilter(freqDial.getValue(), resDial.getValue());
 }
 
@@ -99,36 +191,73 @@ void DeckGUI::paint (juce::Graphics& g)
     // and set font size to 14 points
     g.setColour (juce::Colours::orange);
     g.setFont (14.0f);
-    // write out a label for high pass filter
-    g.drawText("High-pass filter", getWidth() / 2, 0, getWidth() / 2, 40, juce::Justification::centred);
-    // apply custom styles to high pass filter controls
+    // write out labels for the filter and isolator EQ
+    g.drawText("Low/high-pass filter", getWidth() / 2, 0, getWidth() / 2, 40, juce::Justification::centred);
+    g.drawText("Isolator EQ", getWidth() / 2, getHeight() / 2, getWidth() / 2, 40, juce::Justification::centred);
+    // apply custom styles to filter and isolator controls
     freqDial.setLookAndFeel(&freqDialLookAndFeel);
     resDial.setLookAndFeel(&resDialLookAndFeel);
+    lowDial.setLookAndFeel(&lowDialLookAndFeel);
+    midDial.setLookAndFeel(&midDialLookAndFeel);
+    highDial.setLookAndFeel(&highDialLookAndFeel);
 }
 
 void DeckGUI::resized()
 {
-    // keep high-pass filter controls within reasonable bounds on resize
+    // keep filter controls side by side in the top right quarter on resize
     freqDial.setBounds(getWidth() / 2,
                        40,
-                       getWidth() / 2,
-                       (getHeight() - 40) / 2);
-    resDial.setBounds(getWidth() / 2,
-                      (getHeight() / 2) + 20,
-                      getWidth() / 2,
-                      (getHeight() - 40) / 2);
-    // keep high-pass filter readouts within reasonable bounds on resize
+                       getWidth() / 4,
+                       getHeight() / 2 - 40);
+    resDial.setBounds(getWidth() * 3 / 4,
+                      40,
+                      getWidth() / 4,
+                      getHeight() / 2 - 40);
+    // keep isolator controls in a row in the bottom right quarter on resize
+    lowDial.setBounds(getWidth() / 2,
+                      getHeight() / 2 + 40,
+                      getWidth() / 6,
+                      getHeight() / 2 - 40);
+    midDial.setBounds(getWidth() * 2 / 3,
+                      getHeight() / 2 + 40,
+                      getWidth() / 6,
+                      getHeight() / 2 - 40);
+    highDial.setBounds(getWidth() * 5 / 6,
+                       getHeight() / 2 + 40,
+                       getWidth() / 6,
+                       getHeight() / 2 - 40);
+    // keep filter and isolator readouts within reasonable bounds on resize
     freqDial.setTextBoxStyle(juce::Slider::TextBoxAbove, true, getWidth() / 4, 20);
     resDial.setTextBoxStyle(juce::Slider::TextBoxAbove, true, getWidth() / 4, 20);
+    lowDial.setTextBoxStyle(juce::Slider::TextBoxAbove, true, getWidth() / 6, 20);
+    midDial.setTextBoxStyle(juce::Slider::TextBoxAbove, true, getWidth() / 6, 20);
+    highDial.setTextBoxStyle(juce::Slider::TextBoxAbove, true, getWidth() / 6, 20);
     // setup a constant row height by which to control the layout of other components
     double rowH = getHeight() / 8;
     double spacer = rowH / 3;
     // keep sizing of other components within reasonable bounds on resize
-    playButton.setBounds(0, 0, getWidth() / 2, rowH);
-    stopButton.setBounds(0, rowH, getWidth() / 2, rowH);
-    volSlider.setBounds(0, rowH * 2 + spacer * 1, getWidth() / 2, rowH);
-    speedSlider.setBounds(0, rowH * 3 + spacer * 2, getWidth() / 2, rowH);
-    posSlider.setBounds(0, rowH * 4 + spacer * 3, getWidth() / 2, rowH);
+    playButton.setBounds(0, 0, getWidth() / 6, rowH);
+    stopButton.setBounds(getWidth() / 6, 0, getWidth() / 6, rowH);
+    quantizeButton.setBounds(getWidth() / 3, 0, getWidth() / 12, rowH);
+    syncButton.setBounds(getWidth() * 5 / 12, 0, getWidth() / 12, rowH);
+    // loop controls in a row beneath play and stop
+    juce::Button* loopButtons[] = {&loopInButton, &loopOutButton, &autoLoopButton, &halveLoopButton, &doubleLoopButton, &loopRollButton};
+    for (int i = 0; i < 6; ++i)
+    {
+        loopButtons[i]->setBounds(getWidth() * i / 12, rowH, getWidth() / 12, rowH / 2);
+    }
+    // hot cues in a row beneath the loop controls
+    for (int i = 0; i < hotCueButtons.size(); ++i)
+    {
+        hotCueButtons[i]->setBounds(getWidth() * i / (hotCueButtons.size() * 2), rowH * 1.5, getWidth() / (hotCueButtons.size() * 2), rowH / 2);
+    }
+    volSlider.setBounds(0, rowH * 2 + spacer * 1, getWidth() / 4, rowH);
+    keyShiftSlider.setBounds(getWidth() / 4, rowH * 2 + spacer * 1, getWidth() / 4, rowH);
+    speedSlider.setBounds(0, rowH * 3 + spacer * 2, getWidth() / 4, rowH);
+    keyLockButton.setBounds(getWidth() / 4, rowH * 3 + spacer * 2, getWidth() / 8, rowH);
+    reverseButton.setBounds(getWidth() * 3 / 8, rowH * 3 + spacer * 2, getWidth() / 8, rowH);
+    posSlider.setBounds(0, rowH * 4 + spacer * 3, getWidth() / 4, rowH);
+    scratchSlider.setBounds(getWidth() / 4, rowH * 4 + spacer * 3, getWidth() / 4, rowH);
     waveformDisplay.setBounds(0, rowH * 6, getWidth() / 2, rowH * 2);
 }
 
@@ -144,6 +273,118 @@ void DeckGUI::buttonClicked(juce::Button* button)
         // if stop button is clicked, cease playback of loaded track
         player->stop();
     }
+    if (button == &quantizeButton)
+    {
+        // if quantise is clicked, move on to the next setting - off, beat, bar, off...
+        if (quantize == MasterClock::Quantize::none)
+        {
+            quantize = MasterClock::Quantize::beat;
+            quantizeButton.setButtonText("Q BEAT");
+        }
+        else if (quantize == MasterClock::Quantize::beat) {
+            quantize = MasterClock::Quantize::bar;
+            quantizeButton.setButtonText("Q BAR");
+        }
+        else {
+            quantize = MasterClock::Quantize::none;
+            quantizeButton.setButtonText("Q OFF");
+        }
+        player->setQuantize(quantize);
+    }
+    if (button == &keyLockButton)
+    {
+        // if key-lock is toggled, keep or release the track's pitch when the speed changes
+        player->setKeyLock(keyLockButton.getToggleState());
+    }
+    if (button == &syncButton)
+    {
+        // if sync is toggled, lock the deck's tempo and beats to the master clock or let them go
+        player->setSync(syncButton.getToggleState());
+    }
+    if (button == &reverseButton)
+    {
+        // if reverse is toggled, play the track backwards at the same speed
+        sliderValueChanged(&speedSlider);
+    }
+    if (button == &loopInButton)
+    {
+        // if loop in is clicked, mark the start of a loop at the playhead
+        player->loopIn();
+    }
+    if (button == &loopOutButton)
+    {
+        // if loop out is clicked, close the loop at the playhead and start looping
+        player->loopOut();
+    }
+    if (button == &autoLoopButton)
+    {
+        // if the loop button is clicked, loop from the playhead, or leave the loop if one is playing
+        if (player->isLoopActive())
+        {
+            player->exitLoop();
+        }
+        else {
+            player->setAutoLoop(autoLoopBeats);
+        }
+    }
+    if (button == &halveLoopButton)
+    {
+        // halve or double the loop playing, and the length of the next one
+        autoLoopBeats = juce::jmax(DJAudioPlayer::minLoopBeats, autoLoopBeats / 2.0);
+        player->halveLoop();
+    }
+    if (button == &doubleLoopButton)
+    {
+        autoLoopBeats = juce::jmin(DJAudioPlayer::maxLoopBeats, autoLoopBeats * 2.0);
+        player->doubleLoop();
+    }
+    if (button == &halveLoopButton || button == &doubleLoopButton)
+    {
+        // keep the loop button's label in step with the length
+        autoLoopButton.setButtonText(autoLoopBeats < 1.0 ? "LOOP 1/" + juce::String(juce::roundToInt(1.0 / autoLoopBeats))
+                                                         : "LOOP " + juce::String(juce::roundToInt(autoLoopBeats)));
+    }
+    auto cue = hotCueButtons.indexOf(dynamic_cast<juce::TextButton*>(button));
+    if (cue >= 0)
+    {
+        // if a hot cue is clicked, jump to it if it is set, set it if not - shift-click clears it
+        if (juce::ModifierKeys::currentModifiers.isShiftDown())
+        {
+            player->clearHotCue(cue);
+            if (onHotCueChanged)
+            {
+                onHotCueChanged(player->getLoadedURL(), cue, -1.0);
+            }
+        }
+        else if (player->getHotCue(cue) >= 0.0) {
+            player->jumpToHotCue(cue);
+        }
+        else {
+            auto seconds = player->setHotCue(cue);
+            if (seconds >= 0.0 && onHotCueChanged)
+            {
+                // keep the cue with the track in the library
+                onHotCueChanged(player->getLoadedURL(), cue, seconds);
+            }
+        }
+    }
+}
+
+void DeckGUI::buttonStateChanged(juce::Button* button)
+{
+    if (button == &loopRollButton)
+    {
+        // roll only while the button is held - the track picks up where it would have been on release
+        auto held = loopRollButton.isDown();
+        if (held && !loopRollHeld)
+        {
+            player->startLoopRoll(autoLoopBeats);
+        }
+        else if (!held && loopRollHeld) {
+            player->stopLoopRoll();
+        }
+        loopRollHeld = held;
+    }
 }
 
 void DeckGUI::sliderValueChanged(juce::Slider* slider)
@@ -155,17 +396,41 @@ void DeckGUI::sliderValueChanged(juce::Slider* slider)
     }
     if (slider == &speedSlider)
     {
-        // if speed slider is changed, adjust playback speed accordingly
-        player->setSpeed(slider->getValue());
+        // if speed slider is changed, adjust playback speed accordingly - backwards if reversed
+        player->setSpeed(reverseButton.getToggleState() ? -slider->getValue() : slider->getValue());
+    }
+    if (slider == &scratchSlider)
+    {
+        // if the jog is moved, scratch at that rate - through zero and back as it crosses the middle
+        player->setScratchRate(slider->getValue());
+    }
+    if (slider == &keyShiftSlider)
+    {
+        // if key shift slider is changed, split it into whole semitones and cents
+        auto semitones = static_cast<int>(slider->getValue());
+        player->setKeyShift(semitones, (slider->getValue() - semitones) * 100.0);
     }
     if (slider == &posSlider)
     {
         // if position slider is changed, adjust play head position occordingly
         player->setPositionRelative(slider->getValue());
     }
+    if (slider == &lowDial)
+    {
+        // if an isolator dial changes, set that band's gain accordingly
+        player->setEQGain(IsolatorEQ::Band::low, slider->getValue());
+    }
+    if (slider == &midDial)
+    {
+        player->setEQGain(IsolatorEQ::Band::mid, slider->getValue());
+    }
+    if (slider == &highDial)
+    {
+        player->setEQGain(IsolatorEQ::Band::high, slider->getValue());
+    }
     if (slider == &freqDial || slider == &resDial)
     {
-        // if high-pass controls change, update high pass filter accordingly
+        // if filter controls change, update the filter accordingly
         player->updateFilter(freqDial.getValue(), resDial.getValue());
     }
 }
@@ -175,4 +440,11 @@ void DeckGUI::timerCallback()
     // update the wave form display play head visual to keep position
     // relative to current moment in playback
     waveformDisplay.setPositionRelative(player->getPositionRelative());
+    // show whether a loop is playing
+    autoLoopButton.setToggleState(player->isLoopActive(), juce::dontSendNotification);
+    // and which hot cues are set
+    for (int cue = 0; cue < hotCueButtons.size(); ++cue)
+    {
+        hotCueButtons[cue]->setToggleState(player->getHotCue(cue) >= 0.0, juce::dontSendNotification);
+    }
 }
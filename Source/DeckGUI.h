@@ -44,6 +44,10 @@ public:
      from https://docs.juce.com/master/classButton_1_1Listener.html#a81499cef24b7189cd0d1581fd9dc9e14
      "Called when the button is clicked." */
     void buttonClicked(juce::Button* button) override;
+    /** inputs: pointer to the button whose state changed (juce::Button*)
+     from https://docs.juce.com/master/classButton_1_1Listener.html
+     "Called when the button's up/down/over state changes." */
+    void buttonStateChanged(juce::Button* button) override;
     /** inputs: pointer to the slider registering the change (juce::Slider*)
      from https://docs.juce.com/master/classSlider_1_1Listener.html#a127bfe68835dc3e584cf3c2a427a27e5
      "Called when the slider's value is changed." */
@@ -54,23 +58,56 @@ public:
     void timerCallback() override;
     /** wave form display GUI - exposed for use by playlist component */
     WaveformDisplay waveformDisplay;
+    /** called on the message thread whenever a hot cue is set or cleared, with the track's URL, the cue's index and its position in seconds, -1 if cleared */
+    std::function<void(juce::URL, int, double)> onHotCueChanged;
 
 private:
     
     juce::TextButton playButton{"PLAY"};
     juce::TextButton stopButton{"STOP"};
+    /** cycles through quantising off, to the beat and to the bar */
+    juce::TextButton quantizeButton{"Q OFF"};
+    MasterClock::Quantize quantize = MasterClock::Quantize::none;
+
+    juce::TextButton loopInButton{"IN"};
+    juce::TextButton loopOutButton{"OUT"};
+    juce::TextButton autoLoopButton{"LOOP 4"};
+    juce::TextButton halveLoopButton{"/2"};
+    juce::TextButton doubleLoopButton{"x2"};
+    juce::TextButton loopRollButton{"ROLL"};
+    /** beats in an auto-loop or roll */
+    double autoLoopBeats = 4.0;
+    /** flag stating whether the roll button is held down */
+    bool loopRollHeld = false;
+
+    /** one button per hot cue - click to set or jump, shift-click to clear */
+    juce::OwnedArray<juce::TextButton> hotCueButtons;
     
     juce::Slider volSlider;
     juce::Slider speedSlider;
+    juce::ToggleButton keyLockButton{"KEY LOCK"};
+    juce::ToggleButton syncButton{"SYNC"};
+    juce::ToggleButton reverseButton{"REV"};
+    /** spring-loaded jog - drag either way to scratch at up to maxScratchRate, let go to carry on as before */
+    juce::Slider scratchSlider;
+    juce::Slider keyShiftSlider;
     juce::Slider posSlider;
     
     DJAudioPlayer* player;
     
-    RotaryDialLookAndFeel freqDialLookAndFeel{"Cutoff"};
+    RotaryDialLookAndFeel freqDialLookAndFeel{"LP / HP"};
     RotaryDialLookAndFeel resDialLookAndFeel{"Resonance"};
     
     juce::Slider freqDial;
     juce::Slider resDial;
+
+    RotaryDialLookAndFeel lowDialLookAndFeel{"Low"};
+    RotaryDialLookAndFeel midDialLookAndFeel{"Mid"};
+    RotaryDialLookAndFeel highDialLookAndFeel{"High"};
+
+    juce::Slider lowDial;
+    juce::Slider midDial;
+    juce::Slider highDial;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DeckGUI)
 };
@@ -0,0 +1,273 @@
+/*
+  ==============================================================================
+
+    DeckRenderPool.cpp
+    Created: 19 Oct 2026 5:08:33pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#include "DeckRenderPool.h"
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+#endif
+
+namespace
+{
+    /** how long a worker keeps checking for work before going to sleep - long enough to stay awake from one small audio block to the next */
+    constexpr double spinSeconds = 0.005;
+
+    /** tells the CPU the thread is busy-waiting, so it backs off the core it shares with another thread and saves power while it does */
+    inline void pauseCpu()
+    {
+       #if JUCE_INTEL
+        _mm_pause();
+       #elif JUCE_ARM && (JUCE_CLANG || JUCE_GCC)
+        __asm__ __volatile__ ("yield");
+       #endif
+    }
+}
+
+/** a worker that renders decks whenever the audio thread posts them */
+class DeckRenderPool::Worker :  public juce::Thread
+{
+public:
+    /** inputs: reference to the pool the worker takes jobs from (DeckRenderPool&); index of the worker, from 0 (int)
+     constructor */
+    Worker(DeckRenderPool& _pool, int index)
+        : juce::Thread("Deck render " + juce::String(index)),
+        pool(_pool)
+    {
+    }
+
+    /**
+     From https://docs.juce.com/master/classThread.html "Must be implemented to perform the thread's actual code."
+     renders jobs as they are posted, spinning for a while after each block and sleeping once the decks go quiet */
+    void run() override
+    {
+        auto spinTicks = juce::Time::secondsToHighResolutionTicks(spinSeconds);
+        auto idleSince = juce::Time::getHighResolutionTicks();
+        while (!threadShouldExit())
+        {
+            if (pool.renderPendingJobs() > 0)
+            {
+                idleSince = juce::Time::getHighResolutionTicks();
+            }
+            else if (juce::Time::getHighResolutionTicks() - idleSince < spinTicks) {
+                // stay awake - the next block is likely only a millisecond or two away
+                juce::Thread::yield();
+            }
+            else {
+                // go to sleep, unless something was posted while deciding to
+                parked.store(true);
+                if (!pool.hasUnclaimedJobs())
+                {
+                    wakeUp.wait(100);
+                }
+                parked.store(false);
+                idleSince = juce::Time::getHighResolutionTicks();
+            }
+        }
+    }
+
+    /** wakes the worker if it is asleep - the only call the audio thread makes on a worker */
+    void wake()
+    {
+        if (parked.load())
+        {
+            wakeUp.signal();
+        }
+    }
+
+    /** wakes the worker so it can see it has been asked to exit */
+    void interrupt()
+    {
+        wakeUp.signal();
+    }
+
+private:
+    DeckRenderPool& pool;
+    juce::WaitableEvent wakeUp;
+    std::atomic<bool> parked{false};
+};
+
+DeckRenderPool::DeckRenderPool()
+{
+    for (auto& slot : postedJobs)
+    {
+        slot.store(nullptr);
+    }
+}
+
+DeckRenderPool::~DeckRenderPool()
+{
+    stop();
+}
+
+void DeckRenderPool::start(int numWorkers)
+{
+    stop();
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        auto* worker = workers.add(new Worker(*this, i));
+       #if JUCE_WINDOWS || JUCE_LINUX
+        // one core per worker, leaving the first one for the audio thread and the message thread
+        auto core = (i + 1) % juce::jmax(1, juce::jmin(juce::SystemStats::getNumCpus(), 32));
+        worker->setAffinityMask(static_cast<juce::uint32>(1) << core);
+       #endif
+        worker->startThread(juce::Thread::realtimeAudioPriority);
+    }
+}
+
+void DeckRenderPool::stop()
+{
+    for (auto* worker : workers)
+    {
+        worker->signalThreadShouldExit();
+        worker->interrupt();
+    }
+    for (auto* worker : workers)
+    {
+        worker->stopThread(2000);
+    }
+    workers.clear();
+}
+
+int DeckRenderPool::getNumWorkers() const
+{
+    return workers.size();
+}
+
+bool DeckRenderPool::render(Job* jobs, int numJobs, juce::int64 deadlineTicks)
+{
+    if (numJobs <= 0)
+    {
+        return true;
+    }
+    jassert (numJobs <= maxJobs);
+    numJobs = juce::jmin(numJobs, maxJobs);
+    if (workers.isEmpty() || numJobs == 1)
+    {
+        // nothing to share out - render in place
+        renderInPlace(jobs, numJobs);
+        return juce::Time::getHighResolutionTicks() <= deadlineTicks;
+    }
+
+    // post the jobs - any still on a worker from an earlier block are dropped again rather than rendered twice.
+    // the release on the claim counter makes the slots visible to any worker that claims from it
+    int numPosted = 0;
+    for (int i = 0; i < numJobs; ++i)
+    {
+        auto& job = jobs[i];
+        job.dropped = job.inFlight.load(std::memory_order_acquire);
+        if (!job.dropped)
+        {
+            job.inFlight.store(true, std::memory_order_relaxed);
+            postedJobs[static_cast<size_t>(numPosted++)].store(&job, std::memory_order_release);
+        }
+    }
+    claimState.store(static_cast<std::uint64_t>(numPosted) << 32, std::memory_order_release);
+    for (auto* worker : workers)
+    {
+        worker->wake();
+    }
+
+    // work alongside the workers - anything they have not picked up yet gets rendered here
+    renderPendingJobs();
+
+    // whatever is left is part way through on a worker and can't be taken back, so wait for it - but only until the deadline
+    auto allFinished = [jobs, numJobs]
+    {
+        for (int i = 0; i < numJobs; ++i)
+        {
+            if (!jobs[i].dropped && jobs[i].inFlight.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+    auto onTime = true;
+    while (!allFinished())
+    {
+        if (juce::Time::getHighResolutionTicks() > deadlineTicks)
+        {
+            onTime = false;
+            break;
+        }
+        pauseCpu();
+    }
+    // withdraw the posting so nothing can be claimed until the next block
+    claimState.store(0, std::memory_order_relaxed);
+    if (!onTime)
+    {
+        // a deck that misses the block is left out of the mix, and left alone until its worker lets go of it
+        for (int i = 0; i < numJobs; ++i)
+        {
+            jobs[i].dropped = jobs[i].inFlight.load(std::memory_order_acquire);
+        }
+    }
+    return onTime && juce::Time::getHighResolutionTicks() <= deadlineTicks;
+}
+
+void DeckRenderPool::renderInPlace(Job* jobs, int numJobs)
+{
+    for (int i = 0; i < numJobs; ++i)
+    {
+        auto& job = jobs[i];
+        job.dropped = isInFlight(job);
+        if (!job.dropped)
+        {
+            renderJob(job);
+        }
+    }
+}
+
+bool DeckRenderPool::isInFlight(const Job& job)
+{
+    return job.inFlight.load(std::memory_order_acquire);
+}
+
+void DeckRenderPool::renderJob(Job& job)
+{
+    auto startTicks = juce::Time::getHighResolutionTicks();
+    job.rendered = job.deck->renderNextBlock(juce::AudioSourceChannelInfo(job.buffer, 0, job.numSamples));
+    auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    job.renderMicroseconds = static_cast<float>(elapsed * 1.0e6);
+    // the deck takes fader moves on board while rendering, so its gain is read here rather than by the mixer
+    job.channelGain = job.deck->getChannelGain();
+}
+
+int DeckRenderPool::renderPendingJobs()
+{
+    int numRendered = 0;
+    while (hasUnclaimedJobs())
+    {
+        // one atomic add claims the next job and says whether there was one to claim
+        auto state = claimState.fetch_add(1, std::memory_order_acq_rel);
+        auto index = static_cast<std::uint32_t>(state);
+        auto numJobs = static_cast<std::uint32_t>(state >> 32);
+        if (index >= numJobs)
+        {
+            break;
+        }
+        // empty if a thread holding a claim from an earlier block took this block's job first
+        auto* job = postedJobs[index].exchange(nullptr, std::memory_order_acquire);
+        if (job == nullptr)
+        {
+            continue;
+        }
+        renderJob(*job);
+        job->inFlight.store(false, std::memory_order_release);
+        ++numRendered;
+    }
+    return numRendered;
+}
+
+bool DeckRenderPool::hasUnclaimedJobs() const
+{
+    auto state = claimState.load(std::memory_order_acquire);
+    return static_cast<std::uint32_t>(state) < static_cast<std::uint32_t>(state >> 32);
+}
@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    DeckRenderPool.h
+    Created: 19 Oct 2026 5:08:33pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DJAudioPlayer.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+/** renders decks in parallel for the audio thread.
+ a few worker threads at real-time priority pick decks off a shared list while the audio thread works through the same list itself.
+ the workers are pinned to a core each on Windows and Linux - macOS has no way to pin a thread, so there the scheduler places them.
+ handing work over and back is done with atomics only - the audio thread never takes a lock or waits for a worker to wake up.
+ whatever no worker has picked up the audio thread renders itself, and a deck a worker is still half way through at the deadline is dropped from the block */
+class DeckRenderPool
+{
+public:
+    /** one deck to be rendered for the current block */
+    struct Job
+    {
+        DJAudioPlayer* deck = nullptr;
+        juce::AudioBuffer<float>* buffer = nullptr;
+        int numSamples = 0;
+        /** filled in once rendered - false if the deck was idle and left the buffer alone */
+        bool rendered = false;
+        /** filled in once rendered - time taken, in microseconds */
+        float renderMicroseconds = 0.0f;
+        /** filled in once rendered - the deck's fader gain as of this block, read on the thread that rendered it */
+        float channelGain = 1.0f;
+        /** set by the audio thread for a job that missed the block - still being rendered, or not started because it was - so its buffer must not be mixed */
+        bool dropped = false;
+        /** set from posting until rendered - a job that stays set past its block is still on a worker, and must be left alone until it clears */
+        std::atomic<bool> inFlight{false};
+    };
+
+    /** most jobs render can take at once */
+    static constexpr int maxJobs = 16;
+
+    /**
+     constructor */
+    DeckRenderPool();
+    /**
+     destructor */
+    ~DeckRenderPool();
+    /** inputs: number of worker threads to run alongside the audio thread (int) | starts the workers, stopping any already running - never call from the audio thread */
+    void start(int numWorkers);
+    /** stops and joins every worker - never call from the audio thread */
+    void stop();
+    /** outputs: number of worker threads running (int) */
+    int getNumWorkers() const;
+    /** inputs: decks to render (Job*); number of decks (int); time by which every deck should be done - in high resolution ticks (juce::int64) | outputs: false if the deadline passed waiting for a worker (bool)
+     renders every job, sharing them out between the workers and the calling thread, and returns once they are all done or the deadline passes.
+     a job still on a worker at the deadline is marked dropped and left to finish in the background - audio thread only */
+    bool render(Job* jobs, int numJobs, juce::int64 deadlineTicks);
+    /** inputs: decks to render (Job*); number of decks (int)
+     renders every job on the calling thread, dropping any a worker is still finishing from an earlier block - audio thread only */
+    static void renderInPlace(Job* jobs, int numJobs);
+    /** inputs: job to check (const Job&) | outputs: flag stating whether a worker is still rendering the job, so its deck, buffer and results must not be touched (bool) */
+    static bool isInFlight(const Job& job);
+
+    /** inputs: deck to render (Job&) | renders a single job on the calling thread and times it */
+    static void renderJob(Job& job);
+
+private:
+    class Worker;
+
+    /** outputs: number of jobs the caller rendered (int)
+     claims and renders jobs until there are none left unclaimed */
+    int renderPendingJobs();
+    /** outputs: flag stating whether there are jobs posted that nobody has claimed yet (bool) */
+    bool hasUnclaimedJobs() const;
+
+    /** claim counter - the posted number of jobs in the top half and the next job to be claimed in the bottom half, so one fetch_add both claims a job and says whether it exists */
+    std::atomic<std::uint64_t> claimState{0};
+    /** the posted jobs - taken out of their slot by whoever claims them, so a worker that claimed a slot in a block it then slept through can't render a job twice */
+    std::array<std::atomic<Job*>, maxJobs> postedJobs;
+    juce::OwnedArray<Worker> workers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DeckRenderPool)
+};
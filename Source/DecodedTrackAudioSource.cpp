@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+    DecodedTrackAudioSource.cpp
+    Created: 18 Oct 2026 12:15:03pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#include "DecodedTrackAudioSource.h"
+
+DecodedTrackAudioSource::DecodedTrackAudioSource(std::shared_ptr<const DecodedTrack> _track)
+    : track(_track)
+{
+    jassert(track != nullptr);
+}
+
+DecodedTrackAudioSource::~DecodedTrackAudioSource()
+{
+}
+
+void DecodedTrackAudioSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+}
+
+void DecodedTrackAudioSource::releaseResources()
+{
+}
+
+void DecodedTrackAudioSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    auto pos = nextPlayPos.load();
+    auto& audio = track->audio;
+    // work out how much of the block lies within the track
+    auto numAvailable = static_cast<int>(juce::jlimit(static_cast<juce::int64>(0),
+                                                      static_cast<juce::int64>(bufferToFill.numSamples),
+                                                      getTotalLength() - pos));
+    if (pos < 0 || numAvailable == 0)
+    {
+        bufferToFill.clearActiveBufferRegion();
+    }
+    else {
+        for (int chan = 0; chan < bufferToFill.buffer->getNumChannels(); ++chan)
+        {
+            // mono tracks feed every output channel
+            auto sourceChan = juce::jmin(chan, audio.getNumChannels() - 1);
+            bufferToFill.buffer->copyFrom(chan, bufferToFill.startSample,
+                                          audio, sourceChan, static_cast<int>(pos),
+                                          numAvailable);
+        }
+        // silence whatever runs past the end of the track
+        if (numAvailable < bufferToFill.numSamples)
+        {
+            bufferToFill.buffer->clear(bufferToFill.startSample + numAvailable,
+                                       bufferToFill.numSamples - numAvailable);
+        }
+    }
+    // advance the playhead, only if nobody moved it while we were copying
+    nextPlayPos.compare_exchange_strong(pos, pos + bufferToFill.numSamples);
+}
+
+void DecodedTrackAudioSource::setNextReadPosition(juce::int64 newPosition)
+{
+    nextPlayPos = newPosition;
+}
+
+juce::int64 DecodedTrackAudioSource::getNextReadPosition() const
+{
+    return nextPlayPos.load();
+}
+
+juce::int64 DecodedTrackAudioSource::getTotalLength() const
+{
+    return track->audio.getNumSamples();
+}
+
+bool DecodedTrackAudioSource::isLooping() const
+{
+    return false;
+}
@@ -0,0 +1,51 @@
+/*
+  ==============================================================================
+
+    DecodedTrackAudioSource.h
+    Created: 18 Oct 2026 12:15:03pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include "DecodedTrackCache.h"
+
+class DecodedTrackAudioSource : public juce::PositionableAudioSource
+{
+public:
+    /** inputs: the decoded track to play, kept alive for as long as this source exists (std::shared_ptr<const DecodedTrack>)
+     constructor */
+    DecodedTrackAudioSource(std::shared_ptr<const DecodedTrack> track);
+    /**
+     destructor */
+    ~DecodedTrackAudioSource() override;
+    /** inputs: expected number of samples per audio block [buffer] (int); sample rate the output will be used at (double)
+     From https://docs.juce.com/master/classAudioSource.html "Tells the source to prepare for playing."
+     nothing to prepare - the whole track is already in memory */
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    /**
+     From https://docs.juce.com/master/classAudioSource.html "Allows the source to release anything it no longer needs after playback has stopped." */
+    void releaseResources() override;
+    /** inputs: reference to the target channel buffer (juce::AudioSourceChannelInfo&)
+     From https://docs.juce.com/master/classAudioSource.html "Called repeatedly to fetch subsequent blocks of audio data."
+     copies straight out of the decoded track, no decoding or disk access */
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    /** inputs: absolute position to read from next - in samples (juce::int64) */
+    void setNextReadPosition(juce::int64 newPosition) override;
+    /** outputs: absolute position that will be read from next - in samples (juce::int64) */
+    juce::int64 getNextReadPosition() const override;
+    /** outputs: total length of the track - in samples (juce::int64) */
+    juce::int64 getTotalLength() const override;
+    /** outputs: flag stating whether the source is looping (bool) */
+    bool isLooping() const override;
+
+private:
+    std::shared_ptr<const DecodedTrack> track;
+    std::atomic<juce::int64> nextPlayPos{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DecodedTrackAudioSource)
+};
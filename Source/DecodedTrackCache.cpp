@@ -0,0 +1,131 @@
+/*
+  ==============================================================================
+
+    DecodedTrackCache.cpp
+    Created: 18 Oct 2026 11:40:27am
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#include "DecodedTrackCache.h"
+
+DecodedTrackCache::DecodedTrackCache(juce::int64 maxBytes)
+    : budget(maxBytes)
+{
+}
+
+DecodedTrackCache::~DecodedTrackCache()
+{
+}
+
+void DecodedTrackCache::setMemoryBudget(juce::int64 maxBytes)
+{
+    // setter for memory budget
+    const juce::ScopedLock sl(lock);
+    budget = maxBytes;
+    evictToFitBudget();
+}
+
+juce::int64 DecodedTrackCache::getMemoryBudget() const
+{
+    const juce::ScopedLock sl(lock);
+    return budget;
+}
+
+juce::int64 DecodedTrackCache::getMemoryUsed() const
+{
+    const juce::ScopedLock sl(lock);
+    return used;
+}
+
+std::shared_ptr<const DecodedTrack> DecodedTrackCache::lookup(const juce::File& file)
+{
+    const juce::ScopedLock sl(lock);
+    auto found = index.find(makeKey(file));
+    if (found == index.end())
+    {
+        return nullptr;
+    }
+    // move the entry to the front so it is the last to be evicted
+    entries.splice(entries.begin(), entries, found->second);
+    return found->second->track;
+}
+
+std::shared_ptr<const DecodedTrack> DecodedTrackCache::decodeAndStore(const juce::File& file,
+                                                                     juce::AudioFormatManager& formatManager,
+                                                                     std::function<bool()> shouldAbort)
+{
+    // nothing to do if another deck already decoded this version of the file
+    if (auto existing = lookup(file))
+    {
+        return existing;
+    }
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr)
+    {
+        return nullptr;
+    }
+    auto numChannels = static_cast<int>(juce::jmin(2u, reader->numChannels));
+    auto numBytes = reader->lengthInSamples * numChannels * static_cast<juce::int64>(sizeof(float));
+    if (numBytes > getMemoryBudget() || reader->lengthInSamples > std::numeric_limits<int>::max())
+    {
+        // would never fit, don't waste time decoding it
+        return nullptr;
+    }
+
+    auto track = std::make_shared<DecodedTrack>();
+    track->sampleRate = reader->sampleRate;
+    track->audio.setSize(numChannels, static_cast<int>(reader->lengthInSamples));
+    // decode in chunks so a cancelled job can stop promptly
+    const int chunkSize = 65536;
+    for (juce::int64 pos = 0; pos < reader->lengthInSamples; pos += chunkSize)
+    {
+        if (shouldAbort != nullptr && shouldAbort())
+        {
+            return nullptr;
+        }
+        auto numSamples = static_cast<int>(juce::jmin(static_cast<juce::int64>(chunkSize),
+                                                      reader->lengthInSamples - pos));
+        reader->read(&track->audio, static_cast<int>(pos), numSamples, pos, true, true);
+    }
+
+    const juce::ScopedLock sl(lock);
+    auto key = makeKey(file);
+    if (index.find(key) == index.end())
+    {
+        // add as most recently used, then make room for it
+        entries.push_front({key, track, numBytes});
+        index[key] = entries.begin();
+        used += numBytes;
+        evictToFitBudget();
+    }
+    return track;
+}
+
+void DecodedTrackCache::clear()
+{
+    const juce::ScopedLock sl(lock);
+    entries.clear();
+    index.clear();
+    used = 0;
+}
+
+juce::String DecodedTrackCache::makeKey(const juce::File& file)
+{
+    // identify the file by where it is and which version of it is there
+    return file.getFullPathName()
+        + "|" + juce::String(file.getSize())
+        + "|" + juce::String(file.getLastModificationTime().toMilliseconds());
+}
+
+void DecodedTrackCache::evictToFitBudget()
+{
+    // drop tracks from the back (least recently used) until within budget
+    while (used > budget && !entries.empty())
+    {
+        used -= entries.back().bytes;
+        index.erase(entries.back().key);
+        entries.pop_back();
+    }
+}
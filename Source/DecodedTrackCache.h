@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    DecodedTrackCache.h
+    Created: 18 Oct 2026 11:40:27am
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+
+/** a whole track decoded to float samples at its native sample rate */
+struct DecodedTrack
+{
+    juce::AudioBuffer<float> audio;
+    double sampleRate = 0.0;
+};
+
+class DecodedTrackCache
+{
+public:
+    /** inputs: maximum number of bytes of decoded audio to hold (juce::int64)
+     constructor */
+    DecodedTrackCache(juce::int64 maxBytes);
+    /**
+     destructor */
+    ~DecodedTrackCache();
+    /** inputs: maximum number of bytes of decoded audio to hold (juce::int64) | changes the memory budget, evicting least recently used tracks if now over it */
+    void setMemoryBudget(juce::int64 maxBytes);
+    /** outputs: maximum number of bytes of decoded audio to hold (juce::int64) */
+    juce::int64 getMemoryBudget() const;
+    /** outputs: number of bytes of decoded audio currently held (juce::int64) */
+    juce::int64 getMemoryUsed() const;
+    /** inputs: audio file to look for (juce::File) | outputs: the decoded track, or nullptr if not cached (std::shared_ptr<const DecodedTrack>)
+     returns the cached track and marks it as most recently used */
+    std::shared_ptr<const DecodedTrack> lookup(const juce::File& file);
+    /** inputs: audio file to decode (juce::File); reference to audio format manager (juce::AudioFormatManager&); function polled between chunks that returns true to abandon decoding (std::function<bool()>) | outputs: the decoded track, or nullptr if it could not be decoded or was abandoned (std::shared_ptr<const DecodedTrack>)
+     decodes the whole file and adds it to the cache - slow, call from a worker thread */
+    std::shared_ptr<const DecodedTrack> decodeAndStore(const juce::File& file,
+                                                       juce::AudioFormatManager& formatManager,
+                                                       std::function<bool()> shouldAbort);
+    /** remove every track from the cache, tracks still playing stay alive until their decks let go */
+    void clear();
+
+private:
+    /** inputs: audio file (juce::File) | outputs: key identifying this version of the file (juce::String)
+     built from path, size and modification time so an edited file is never served stale */
+    static juce::String makeKey(const juce::File& file);
+    /** evicts least recently used tracks until within budget - lock must be held */
+    void evictToFitBudget();
+
+    struct Entry
+    {
+        juce::String key;
+        std::shared_ptr<const DecodedTrack> track;
+        juce::int64 bytes;
+    };
+
+    juce::CriticalSection lock;
+    std::list<Entry> entries; // most recently used at the front
+    std::map<juce::String, std::list<Entry>::iterator> index;
+    juce::int64 budget;
+    juce::int64 used = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DecodedTrackCache)
+};
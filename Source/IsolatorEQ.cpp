@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    IsolatorEQ.cpp
+    Created: 19 Oct 2026 1:47:52pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#include "IsolatorEQ.h"
+
+IsolatorEQ::IsolatorEQ()
+{
+    // every band starts at unity
+    for (auto& gain : gains)
+    {
+        gain.setCurrentAndTargetValue(1.0f);
+    }
+}
+
+IsolatorEQ::~IsolatorEQ()
+{
+}
+
+void IsolatorEQ::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    // Butterworth TPT state variable filter coefficients at each crossover, two in a row make a Linkwitz-Riley
+    auto sampleRate = static_cast<float>(spec.sampleRate);
+    auto k = coefficients.k;
+    auto g = std::tan(juce::MathConstants<float>::pi * lowCrossover / sampleRate);
+    coefficients.lowA1 = 1.0f / (1.0f + g * (g + k));
+    coefficients.lowA2 = g * coefficients.lowA1;
+    coefficients.lowA3 = g * coefficients.lowA2;
+    g = std::tan(juce::MathConstants<float>::pi * highCrossover / sampleRate);
+    coefficients.highA1 = 1.0f / (1.0f + g * (g + k));
+    coefficients.highA2 = g * coefficients.highA1;
+    coefficients.highA3 = g * coefficients.highA2;
+    // glide over a few blocks so kills and knob turns don't click
+    for (auto& gain : gains)
+    {
+        gain.reset(spec.sampleRate, 0.02);
+    }
+    reset();
+}
+
+void IsolatorEQ::reset()
+{
+    std::fill(std::begin(state), std::end(state), 0.0f);
+    for (auto& gain : gains)
+    {
+        gain.setCurrentAndTargetValue(gain.getTargetValue());
+    }
+    lastGains = { gains[0].getCurrentValue(), gains[1].getCurrentValue(), gains[2].getCurrentValue() };
+}
+
+void IsolatorEQ::setBandGain(Band band, float gain)
+{
+    // setter for band gain
+    gains[static_cast<int>(band)].setTargetValue(juce::jmax(0.0f, gain));
+}
+
+void IsolatorEQ::process(const juce::dsp::ProcessContextReplacing<float>& context)
+{
+    juce::ScopedNoDenormals noDenormals;
+    auto& block = context.getOutputBlock();
+    auto numSamples = static_cast<int>(block.getNumSamples());
+    jassert(block.getNumChannels() >= 2);
+    if (block.getNumChannels() < 2 || numSamples == 0)
+    {
+        return;
+    }
+
+    // smooth per block, then slide sample by sample within it
+    DSPKernels::BandGains nextGains = { gains[0].skip(numSamples), gains[1].skip(numSamples), gains[2].skip(numSamples) };
+    DSPKernels::isolatorStereo(block.getChannelPointer(0), block.getChannelPointer(1), numSamples,
+                               state, coefficients, lastGains, nextGains);
+    lastGains = nextGains;
+}
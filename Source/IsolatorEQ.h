@@ -0,0 +1,58 @@
+/*
+  ==============================================================================
+
+    IsolatorEQ.h
+    Created: 19 Oct 2026 1:47:52pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DSPKernels.h"
+
+/** three-band full-kill isolator - low, mid and high, each from silent to a small boost.
+ fourth-order Linkwitz-Riley crossovers split the signal, so with every band at unity the bands add back up to the input, all-passed.
+ both channels and the bands go through SIMD lanes together and every band is always computed,
+ so the cost per sample is the same whichever bands are turned down */
+class IsolatorEQ
+{
+public:
+    /** the three bands */
+    enum class Band
+    {
+        low,
+        mid,
+        high
+    };
+
+    /**
+     constructor */
+    IsolatorEQ();
+    /**
+     destructor */
+    ~IsolatorEQ();
+    /** inputs: specifications of the audio to be processed (juce::dsp::ProcessSpec&) | works out the crossovers for the sample rate */
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    /** clears the filter memory and jumps straight to the current gains */
+    void reset();
+    /** inputs: band to set (Band); linear gain - with 0 killing the band and 1 leaving it alone (float) | sets the gain of one band */
+    void setBandGain(Band band, float gain);
+    /** inputs: stereo audio to be equalised in place (juce::dsp::ProcessContextReplacing<float>&) | equalises the block */
+    void process(const juce::dsp::ProcessContextReplacing<float>& context);
+
+    /** crossover between the low and mid bands - in hz */
+    static constexpr float lowCrossover = 300.0f;
+    /** crossover between the mid and high bands - in hz */
+    static constexpr float highCrossover = 3000.0f;
+
+private:
+    DSPKernels::CrossoverCoefficients coefficients;
+    juce::SmoothedValue<float> gains[3];
+    DSPKernels::BandGains lastGains;
+    float state[32] = {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (IsolatorEQ)
+};
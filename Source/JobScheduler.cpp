@@ -0,0 +1,381 @@
+/*
+  ==============================================================================
+
+    JobScheduler.cpp
+    Created: 21 Oct 2026 10:14:36am
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#include "JobScheduler.h"
+
+//==============================================================================
+class JobScheduler::Worker : public juce::Thread
+{
+public:
+    /** inputs: reference to the scheduler to take jobs from (JobScheduler&)
+     constructor */
+    Worker(JobScheduler& _scheduler)
+        : juce::Thread("Job scheduler worker"),
+        scheduler(_scheduler)
+    {
+    }
+
+    /** From https://docs.juce.com/master/classThread.html "Must be implemented to perform the thread's actual code."
+     runs jobs until told to stop */
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            if (!scheduler.runNextJob())
+            {
+                // nothing can start - sleep until there is new work, or long enough for a hold to have lifted
+                wait(100);
+            }
+        }
+    }
+
+private:
+    JobScheduler& scheduler;
+};
+
+//==============================================================================
+JobScheduler::Job::Job(const juce::String& _name, bool _decodesAudio)
+    : name(_name),
+    decodesAudio(_decodesAudio)
+{
+}
+
+JobScheduler::Job::~Job()
+{
+}
+
+bool JobScheduler::Job::shouldExit()
+{
+    if (scheduler != nullptr)
+    {
+        scheduler->waitWhileHeld(*this);
+    }
+    return exitSignalled.load();
+}
+
+void JobScheduler::Job::signalJobShouldExit()
+{
+    exitSignalled.store(true);
+}
+
+void JobScheduler::Job::setPriority(Priority newPriority)
+{
+    if (scheduler != nullptr)
+    {
+        scheduler->changePriority(*this, newPriority);
+    }
+    else {
+        priority.store(newPriority);
+    }
+}
+
+JobScheduler::Priority JobScheduler::Job::getPriority() const
+{
+    return priority.load();
+}
+
+juce::String JobScheduler::Job::getName() const
+{
+    return name;
+}
+
+//==============================================================================
+JobScheduler::JobScheduler(int numThreads, int _maxDecoders)
+    : maxDecoders(juce::jmax(1, _maxDecoders))
+{
+    for (int i = 0; i < juce::jmax(2, numThreads); ++i)
+    {
+        workers.push_back(std::make_unique<Worker>(*this));
+    }
+    for (auto& worker : workers)
+    {
+        worker->startThread();
+    }
+}
+
+JobScheduler::~JobScheduler()
+{
+    juce::Array<Job*> removed;
+    {
+        const juce::ScopedLock sl(lock);
+        removed.swapWith(queue);
+        for (auto* job : running)
+        {
+            job->signalJobShouldExit();
+        }
+    }
+    for (auto* job : removed)
+    {
+        delete job;
+    }
+    for (auto& worker : workers)
+    {
+        worker->signalThreadShouldExit();
+        worker->notify();
+    }
+    for (auto& worker : workers)
+    {
+        worker->stopThread(5000);
+    }
+}
+
+void JobScheduler::addJob(Job* job, Priority priority, const void* owner, const juce::String& tag)
+{
+    job->scheduler = this;
+    job->owner = owner;
+    job->tag = tag;
+    job->priority.store(priority);
+    {
+        const juce::ScopedLock sl(lock);
+        if (priority == Priority::deckCritical)
+        {
+            ++numDeckCritical;
+        }
+        queue.add(job);
+    }
+    notifyWorkers();
+}
+
+bool JobScheduler::removeJobs(const void* owner, bool interruptRunning, int timeoutMs)
+{
+    juce::Array<Job*> removed;
+    {
+        const juce::ScopedLock sl(lock);
+        for (int i = queue.size(); --i >= 0;)
+        {
+            if (queue[i]->owner == owner)
+            {
+                if (queue[i]->getPriority() == Priority::deckCritical)
+                {
+                    --numDeckCritical;
+                }
+                removed.add(queue.removeAndReturn(i));
+            }
+        }
+        if (interruptRunning)
+        {
+            for (auto* job : running)
+            {
+                if (job->owner == owner)
+                {
+                    job->signalJobShouldExit();
+                }
+            }
+        }
+    }
+    for (auto* job : removed)
+    {
+        delete job;
+    }
+    // a removed deck load may have been holding everything else back
+    notifyWorkers();
+
+    auto start = juce::Time::getMillisecondCounter();
+    for (;;)
+    {
+        {
+            const juce::ScopedLock sl(lock);
+            bool stillRunning = false;
+            for (auto* job : running)
+            {
+                stillRunning = stillRunning || job->owner == owner;
+            }
+            if (!stillRunning)
+            {
+                return true;
+            }
+        }
+        if (timeoutMs >= 0 && static_cast<int>(juce::Time::getMillisecondCounter() - start) >= timeoutMs)
+        {
+            return false;
+        }
+        jobFinished.wait(2);
+    }
+}
+
+void JobScheduler::setVisibleJobs(const void* owner, const juce::StringArray& visibleTags)
+{
+    {
+        const juce::ScopedLock sl(lock);
+        for (auto* job : queue)
+        {
+            if (job->owner == owner && job->getPriority() != Priority::deckCritical)
+            {
+                job->priority.store(visibleTags.contains(job->tag) ? Priority::visible : Priority::bulk);
+            }
+        }
+    }
+    notifyWorkers();
+}
+
+void JobScheduler::setBulkPaused(bool shouldPause)
+{
+    bulkPaused.store(shouldPause);
+    notifyWorkers();
+}
+
+bool JobScheduler::isBulkPaused() const
+{
+    return bulkPaused.load();
+}
+
+void JobScheduler::setAudioLoad(float load)
+{
+    // only a timestamp is stored - held jobs and idle workers check it for themselves, so the audio thread never wakes a thread
+    if (load > throttleLoad)
+    {
+        lastLateBlockTicks.store(juce::Time::getHighResolutionTicks());
+    }
+}
+
+int JobScheduler::getNumQueuedJobs() const
+{
+    const juce::ScopedLock sl(lock);
+    return queue.size();
+}
+
+bool JobScheduler::runNextJob()
+{
+    Job* job = nullptr;
+    {
+        const juce::ScopedLock sl(lock);
+        job = pickNextJob();
+        if (job == nullptr)
+        {
+            return false;
+        }
+        queue.removeFirstMatchingValue(job);
+        running.add(job);
+    }
+    auto status = job->runJob();
+    bool runAgain = status == Job::jobNeedsRunningAgain && !job->exitSignalled.load();
+    {
+        const juce::ScopedLock sl(lock);
+        running.removeFirstMatchingValue(job);
+        if (runAgain)
+        {
+            queue.add(job);
+        }
+        else if (job->getPriority() == Priority::deckCritical) {
+            --numDeckCritical;
+        }
+    }
+    if (!runAgain)
+    {
+        delete job;
+    }
+    jobFinished.signal();
+    // a decoder slot has freed up, or a finished deck load has let the held jobs go
+    notifyWorkers();
+    return true;
+}
+
+JobScheduler::Job* JobScheduler::pickNextJob() const
+{
+    // most urgent class first, oldest first within a class
+    for (auto priority : {Priority::deckCritical, Priority::visible, Priority::bulk})
+    {
+        for (auto* job : queue)
+        {
+            if (job->getPriority() == priority && canStart(*job))
+            {
+                return job;
+            }
+        }
+    }
+    return nullptr;
+}
+
+bool JobScheduler::canStart(const Job& job) const
+{
+    if (job.getPriority() == Priority::deckCritical)
+    {
+        return true;
+    }
+    if (shouldHold(job))
+    {
+        return false;
+    }
+    int numOthers = 0;
+    int numDecoders = 0;
+    for (auto* other : running)
+    {
+        if (other->getPriority() != Priority::deckCritical)
+        {
+            ++numOthers;
+            numDecoders += other->decodesAudio ? 1 : 0;
+        }
+    }
+    // keep a worker free for the next deck load
+    if (numOthers >= static_cast<int>(workers.size()) - 1)
+    {
+        return false;
+    }
+    return !job.decodesAudio || numDecoders < maxDecoders;
+}
+
+bool JobScheduler::shouldHold(const Job& job) const
+{
+    auto priority = job.getPriority();
+    if (priority == Priority::deckCritical)
+    {
+        return false;
+    }
+    if (numDeckCritical.load() > 0 || isThrottled())
+    {
+        return true;
+    }
+    return priority == Priority::bulk && bulkPaused.load();
+}
+
+bool JobScheduler::isThrottled() const
+{
+    auto last = lastLateBlockTicks.load();
+    return last != 0
+        && juce::Time::getHighResolutionTicks() - last < juce::Time::secondsToHighResolutionTicks(throttleHoldSeconds);
+}
+
+void JobScheduler::waitWhileHeld(Job& job)
+{
+    while (!job.exitSignalled.load() && shouldHold(job))
+    {
+        juce::Thread::sleep(holdPollMilliseconds);
+    }
+}
+
+void JobScheduler::changePriority(Job& job, Priority newPriority)
+{
+    {
+        const juce::ScopedLock sl(lock);
+        auto oldPriority = job.getPriority();
+        if (oldPriority == newPriority)
+        {
+            return;
+        }
+        if (oldPriority == Priority::deckCritical)
+        {
+            --numDeckCritical;
+        }
+        if (newPriority == Priority::deckCritical)
+        {
+            ++numDeckCritical;
+        }
+        job.priority.store(newPriority);
+    }
+    notifyWorkers();
+}
+
+void JobScheduler::notifyWorkers()
+{
+    for (auto& worker : workers)
+    {
+        worker->notify();
+    }
+}
@@ -0,0 +1,148 @@
+/*
+  ==============================================================================
+
+    JobScheduler.h
+    Created: 21 Oct 2026 10:14:36am
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/** runs deck loads, seek indexing and track analysis on a shared set of worker threads, most urgent first.
+ jobs come in three classes. deck loads are deck critical and start straight away - a worker is kept free for them, and while one is waiting or running
+ every other job holds at its next call to shouldExit, so a deck never waits behind a library import. jobs for tracks on screen in the playlist go next, then bulk work.
+ only a few jobs that decode audio run at once, so the disk and memory bandwidth left over goes to the decks. while the audio thread is close to its deadline
+ everything but deck loads holds too, and bulk work can be paused outright or cancelled */
+class JobScheduler
+{
+public:
+    /** how urgent a job is, most urgent first */
+    enum class Priority
+    {
+        deckCritical,
+        visible,
+        bulk
+    };
+
+    /** a piece of work for the scheduler - call shouldExit regularly, it is where the job is cancelled and where it waits while held */
+    class Job
+    {
+    public:
+        /** what runJob wants done with the job next */
+        enum JobStatus
+        {
+            jobHasFinished,
+            jobNeedsRunningAgain
+        };
+
+        /** inputs: name of the job (const juce::String&); flag stating whether the job decodes audio, counting towards the scheduler's cap on decoders (bool)
+         constructor */
+        Job(const juce::String& _name, bool _decodesAudio = true);
+        /**
+         destructor */
+        virtual ~Job();
+        /** outputs: whether the job is done, or should go back in the queue (JobStatus)
+         does the job's work, on one of the scheduler's worker threads */
+        virtual JobStatus runJob() = 0;
+        /** outputs: flag stating whether the job has been cancelled and should stop (bool)
+         if the job is being held back - by a deck load, by the audio thread running late or by bulk work being paused - this waits until it is let go */
+        bool shouldExit();
+        /** asks the job to stop at its next call to shouldExit */
+        void signalJobShouldExit();
+        /** inputs: class to move the job to (Priority) | lets a running job change how urgent it is, such as a deck load carrying on to work that can wait */
+        void setPriority(Priority newPriority);
+        /** outputs: how urgent the job is (Priority) */
+        Priority getPriority() const;
+        /** outputs: name of the job (juce::String) */
+        juce::String getName() const;
+
+    private:
+        friend class JobScheduler;
+        juce::String name;
+        bool decodesAudio;
+        std::atomic<Priority> priority{Priority::bulk};
+        std::atomic<bool> exitSignalled{false};
+        /** set when the job is added */
+        JobScheduler* scheduler = nullptr;
+        const void* owner = nullptr;
+        juce::String tag;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Job)
+    };
+
+    /** inputs: number of worker threads, at least two so one is always free for deck loads (int); most jobs decoding audio at once, deck loads aside (int)
+     constructor - starts the workers */
+    JobScheduler(int numThreads = juce::jmax(2, juce::SystemStats::getNumCpus() - 1),
+                 int _maxDecoders = juce::jlimit(1, 4, juce::SystemStats::getNumCpus() / 2));
+    /**
+     destructor - cancels every job and stops the workers */
+    ~JobScheduler();
+    /** inputs: job to run, deleted by the scheduler once finished or removed (Job*); how urgent it is (Priority); whoever added it, to cancel it by (const void*); optional label to find it by, such as the URL of its track (const juce::String&)
+     queues a job, behind others of the same class */
+    void addJob(Job* job, Priority priority, const void* owner, const juce::String& tag = {});
+    /** inputs: whoever added the jobs (const void*); flag stating whether to ask running jobs to stop too (bool); time to wait for running jobs to stop, 0 not to wait and -1 to wait as long as it takes - in milliseconds (int) | outputs: false if a running job was still going when time ran out (bool)
+     removes every queued job added by the owner */
+    bool removeJobs(const void* owner, bool interruptRunning, int timeoutMs);
+    /** inputs: whoever added the jobs (const void*); labels of the jobs now on screen (const juce::StringArray&)
+     moves the owner's queued jobs with those labels up to visible, and the rest of its visible ones back to bulk */
+    void setVisibleJobs(const void* owner, const juce::StringArray& visibleTags);
+    /** inputs: flag stating whether bulk work should be paused (bool) | pauses or resumes bulk jobs, those already running holding where they are */
+    void setBulkPaused(bool shouldPause);
+    /** outputs: flag stating whether bulk work is paused (bool) */
+    bool isBulkPaused() const;
+    /** inputs: time the audio thread spent rendering its last block, as a share of the block's duration (float)
+     tells the scheduler how close the audio thread is to its deadline - lock free, so safe on the audio thread */
+    void setAudioLoad(float load);
+    /** outputs: number of jobs waiting to start (int) */
+    int getNumQueuedJobs() const;
+
+    /** a render taking more than this share of its block's duration holds back everything but deck loads */
+    static constexpr float throttleLoad = 0.5f;
+    /** how long the hold lasts after the last late block - in seconds */
+    static constexpr double throttleHoldSeconds = 0.5;
+    /** how often a held job checks whether it has been let go - in milliseconds */
+    static constexpr int holdPollMilliseconds = 10;
+
+private:
+    /** one worker thread */
+    class Worker;
+
+    /** outputs: flag stating whether a job was run (bool) | takes the most urgent job that can start and runs it - worker threads only */
+    bool runNextJob();
+    /** outputs: the most urgent job that can start now, nullptr if none can (Job*) - call with the lock held */
+    Job* pickNextJob() const;
+    /** inputs: a queued job (const Job&) | outputs: flag stating whether the job can start now (bool) - call with the lock held */
+    bool canStart(const Job& job) const;
+    /** inputs: a queued or running job (const Job&) | outputs: flag stating whether the job should wait before going any further (bool) */
+    bool shouldHold(const Job& job) const;
+    /** outputs: flag stating whether the audio thread has run late recently (bool) */
+    bool isThrottled() const;
+    /** inputs: a running job (Job&) | waits while the job is held and has not been cancelled */
+    void waitWhileHeld(Job& job);
+    /** inputs: a job (Job&); class to move it to (Priority) | changes a job's class, keeping count of the deck critical ones */
+    void changePriority(Job& job, Priority newPriority);
+    /** wakes every worker to look for work */
+    void notifyWorkers();
+
+    /** guards the queue and the list of running jobs - never taken on the audio thread */
+    juce::CriticalSection lock;
+    juce::Array<Job*> queue;
+    juce::Array<Job*> running;
+    std::vector<std::unique_ptr<Worker>> workers;
+    int maxDecoders;
+    /** deck critical jobs queued or running - everything else holds while there are any */
+    std::atomic<int> numDeckCritical{0};
+    std::atomic<bool> bulkPaused{false};
+    /** when the audio thread last ran late - in high resolution ticks, 0 if it never has */
+    std::atomic<juce::int64> lastLateBlockTicks{0};
+    juce::WaitableEvent jobFinished;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JobScheduler)
+};
@@ -0,0 +1,148 @@
+/*
+  ==============================================================================
+
+    KeyAnalyser.cpp
+    Created: 20 Oct 2026 6:21:44pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#include "KeyAnalyser.h"
+
+namespace
+{
+    /** how often each scale degree, from the tonic up, turns up in music in a major or minor key - Temperley's counts from the Kostka-Payne corpus.
+     they lean on the tonic and fifth less than listening-test profiles, so the third harmonics of real instruments don't pull the answer a fifth up */
+    constexpr double majorProfile[12] = {0.748, 0.060, 0.488, 0.082, 0.670, 0.460, 0.096, 0.715, 0.104, 0.366, 0.057, 0.400};
+    constexpr double minorProfile[12] = {0.712, 0.084, 0.474, 0.618, 0.049, 0.460, 0.105, 0.747, 0.404, 0.067, 0.133, 0.330};
+
+    /** inputs: chroma (const std::array<double, 12>&); key profile (const double*); tonic - as a pitch class (int) | outputs: correlation between the chroma and the profile in that key, from -1 to 1 (double) */
+    double correlate(const std::array<double, 12>& chroma, const double* profile, int tonic)
+    {
+        double chromaMean = 0.0;
+        double profileMean = 0.0;
+        for (int i = 0; i < 12; ++i)
+        {
+            chromaMean += chroma[static_cast<size_t>(i)] / 12.0;
+            profileMean += profile[i] / 12.0;
+        }
+        double product = 0.0;
+        double chromaSquares = 0.0;
+        double profileSquares = 0.0;
+        for (int pitch = 0; pitch < 12; ++pitch)
+        {
+            auto x = chroma[static_cast<size_t>(pitch)] - chromaMean;
+            auto y = profile[(pitch - tonic + 12) % 12] - profileMean;
+            product += x * y;
+            chromaSquares += x * x;
+            profileSquares += y * y;
+        }
+        auto denominator = std::sqrt(chromaSquares * profileSquares);
+        return denominator > 0.0 ? product / denominator : 0.0;
+    }
+}
+
+KeyAnalyser::Result KeyAnalyser::analyse(juce::AudioFormatReader& reader, std::function<bool()> shouldExit)
+{
+    Result result;
+    if (reader.sampleRate <= 0.0 || reader.lengthInSamples < fftSize)
+    {
+        return result;
+    }
+    auto chroma = getChroma(reader, shouldExit);
+
+    // try every key, major and minor
+    auto bestScore = 0.0;
+    for (int tonic = 0; tonic < 12; ++tonic)
+    {
+        for (auto isMinor : {false, true})
+        {
+            auto score = correlate(chroma, isMinor ? minorProfile : majorProfile, tonic);
+            if (score > bestScore)
+            {
+                bestScore = score;
+                result.tonic = tonic;
+                result.isMinor = isMinor;
+                result.valid = true;
+            }
+        }
+    }
+    return result;
+}
+
+juce::String KeyAnalyser::toCamelot(const Result& key)
+{
+    if (!key.valid)
+    {
+        return {};
+    }
+    // the wheel goes round in fifths, C major at 8B with A minor, its relative minor, beside it at 8A
+    auto relativeMajor = key.isMinor ? (key.tonic + 3) % 12 : key.tonic;
+    auto number = (relativeMajor * 7 + 7) % 12 + 1;
+    return juce::String(number) + (key.isMinor ? "A" : "B");
+}
+
+std::array<double, 12> KeyAnalyser::getChroma(juce::AudioFormatReader& reader, const std::function<bool()>& shouldExit)
+{
+    std::array<double, 12> chroma{};
+    juce::dsp::FFT fft(fftOrder);
+    juce::dsp::WindowingFunction<float> window(static_cast<size_t>(fftSize), juce::dsp::WindowingFunction<float>::hann, false);
+    std::vector<float> fftData(static_cast<size_t>(fftSize * 2));
+
+    // which pitch class each bin belongs to, -1 for bins outside the range counted
+    std::vector<int> pitchClasses(static_cast<size_t>(fftSize / 2), -1);
+    for (int bin = 1; bin < fftSize / 2; ++bin)
+    {
+        auto frequency = bin * reader.sampleRate / fftSize;
+        if (frequency >= minFrequency && frequency <= maxFrequency)
+        {
+            // semitones above A440, then round to the nearest note and fold into an octave counted from C
+            auto note = static_cast<int>(std::lround(12.0 * std::log2(frequency / 440.0)));
+            pitchClasses[static_cast<size_t>(bin)] = ((note + 9) % 12 + 12) % 12;
+        }
+    }
+
+    // excerpts spread through the body of the track, leaving out intros and outros that often sit on a single drum loop
+    auto excerptLength = static_cast<juce::int64>(excerptSeconds * reader.sampleRate);
+    auto bodyStart = reader.lengthInSamples / 10;
+    auto bodyLength = reader.lengthInSamples - 2 * bodyStart;
+    auto numToTake = numExcerpts;
+    if (bodyLength < excerptLength * numExcerpts)
+    {
+        // short track - read all of it, in one go
+        bodyStart = 0;
+        bodyLength = reader.lengthInSamples;
+        excerptLength = reader.lengthInSamples;
+        numToTake = 1;
+    }
+    juce::AudioBuffer<float> block(juce::jmax(1, static_cast<int>(reader.numChannels)), static_cast<int>(excerptLength));
+    for (int excerpt = 0; excerpt < numToTake; ++excerpt)
+    {
+        if (shouldExit && shouldExit())
+        {
+            return {};
+        }
+        auto start = bodyStart + (bodyLength - excerptLength) * excerpt / juce::jmax(1, numToTake - 1);
+        reader.read(&block, 0, static_cast<int>(excerptLength), start, true, true);
+        for (int frame = 0; frame + fftSize <= excerptLength; frame += fftSize / 2)
+        {
+            // mix down to mono and window
+            std::fill(fftData.begin(), fftData.end(), 0.0f);
+            for (int chan = 0; chan < block.getNumChannels(); ++chan)
+            {
+                juce::FloatVectorOperations::add(fftData.data(), block.getReadPointer(chan, frame), fftSize);
+            }
+            window.multiplyWithWindowingTable(fftData.data(), static_cast<size_t>(fftSize));
+            fft.performFrequencyOnlyForwardTransform(fftData.data());
+            for (size_t bin = 1; bin < pitchClasses.size(); ++bin)
+            {
+                if (pitchClasses[bin] >= 0)
+                {
+                    chroma[static_cast<size_t>(pitchClasses[bin])] += fftData[bin];
+                }
+            }
+        }
+    }
+    return chroma;
+}
@@ -0,0 +1,53 @@
+/*
+  ==============================================================================
+
+    KeyAnalyser.h
+    Created: 20 Oct 2026 6:21:44pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <functional>
+
+/** finds a track's musical key.
+ a handful of short excerpts spread through the body of the track are decoded - not the whole track - and folded into a chroma vector,
+ how much of each of the twelve pitch classes is playing. that is compared against the Temperley major and minor key profiles
+ in all twelve keys, and the best match is the key, reported in Camelot notation so harmonic mixing is a matter of neighbouring numbers */
+class KeyAnalyser
+{
+public:
+    /** what the analysis found */
+    struct Result
+    {
+        /** false if the file could not be read, had no pitched content or analysis was stopped */
+        bool valid = false;
+        /** tonic - as a pitch class, 0 being C */
+        int tonic = 0;
+        bool isMinor = false;
+    };
+
+    /** inputs: reader for the track, ideally one that seeks quickly (juce::AudioFormatReader&); optional function returning true if analysis should give up (std::function<bool()>) | outputs: the key (Result)
+     reads only the excerpts - call from a background thread */
+    static Result analyse(juce::AudioFormatReader& reader, std::function<bool()> shouldExit = nullptr);
+    /** inputs: key (const Result&) | outputs: the key in Camelot notation - 1 to 12 round the circle of fifths, A for minor and B for major - empty if not valid (juce::String) */
+    static juce::String toCamelot(const Result& key);
+
+    /** excerpts decoded, and the length of each - in seconds */
+    static constexpr int numExcerpts = 8;
+    static constexpr double excerptSeconds = 8.0;
+    /** size of each frame the chroma is measured over, long enough to tell neighbouring semitones apart in the bass - in samples */
+    static constexpr int fftOrder = 13;
+    static constexpr int fftSize = 1 << fftOrder;
+    /** lowest and highest frequencies counted towards the chroma - in Hz */
+    static constexpr double minFrequency = 50.0;
+    static constexpr double maxFrequency = 5000.0;
+
+private:
+    /** inputs: reader for the track (juce::AudioFormatReader&); function returning true if analysis should give up (const std::function<bool()>&) | outputs: energy in each pitch class over every excerpt, all zero if stopped (std::array<double, 12>) */
+    static std::array<double, 12> getChroma(juce::AudioFormatReader& reader, const std::function<bool()>& shouldExit);
+};
@@ -0,0 +1,575 @@
+/*
+  ==============================================================================
+
+    LoopingAudioSource.cpp
+    Created: 20 Oct 2026 9:14:26am
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#include "LoopingAudioSource.h"
+
+namespace
+{
+    /** shortest loop allowed, however many times it is halved - in samples */
+    constexpr juce::int64 minLoopLength = 32;
+    /** most copied into RAM per background time slice, so a new loop never waits behind a long copy */
+    constexpr int preloadChunkSize = 8192;
+}
+
+LoopingAudioSource::LoopingAudioSource(juce::PositionableAudioSource* _source,
+                                       std::unique_ptr<juce::PositionableAudioSource> _preloadSource,
+                                       juce::TimeSliceThread& _backgroundThread,
+                                       double sampleRate)
+    : source(_source),
+    preloadSource(std::move(_preloadSource)),
+    backgroundThread(_backgroundThread),
+    maxLoopLength(static_cast<juce::int64>(maxLoopSeconds * sampleRate)),
+    cueLength(static_cast<juce::int64>(hotCueSeconds * sampleRate)),
+    scratchWindow(sampleRate)
+{
+    jassert(source != nullptr);
+    // room for the longest loop and every cue, allocated now so setting a loop or cue never allocates
+    loopBuffer.setSize(2, static_cast<int>(maxLoopLength));
+    for (int cue = 0; cue < numHotCues; ++cue)
+    {
+        cueBuffers[static_cast<size_t>(cue)].setSize(2, static_cast<int>(cueLength));
+        cuePositions[static_cast<size_t>(cue)].store(-1);
+        cueStates[static_cast<size_t>(cue)].store(0);
+    }
+}
+
+LoopingAudioSource::~LoopingAudioSource()
+{
+    // make sure the background thread is finished with us before going away
+    backgroundThread.removeTimeSliceClient(this);
+}
+
+void LoopingAudioSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    source->prepareToPlay(samplesPerBlockExpected, sampleRate);
+    // hand over to the background thread, which copies loops into RAM as they are set
+    if (preloadSource != nullptr)
+    {
+        backgroundThread.addTimeSliceClient(this);
+    }
+}
+
+void LoopingAudioSource::releaseResources()
+{
+    // wait for the background thread to let go of us before releasing the source
+    backgroundThread.removeTimeSliceClient(this);
+    source->releaseResources();
+}
+
+void LoopingAudioSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    auto originalPosition = nextPlayPos.load();
+    auto position = originalPosition;
+    if (position != lastEndPosition)
+    {
+        // moved from outside - a seek landing right on a cue plays from its RAM, just as a jump to it would
+        for (int cue = 0; cue < numHotCues; ++cue)
+        {
+            if (cuePositions[static_cast<size_t>(cue)].load() == position)
+            {
+                activeCue = cue;
+                break;
+            }
+        }
+    }
+    applyActions(position);
+    scratchWindow.setPlayhead(position);
+    if (reverse.load())
+    {
+        renderBackwards(bufferToFill, position);
+        lastEndPosition = position;
+        nextPlayPos.compare_exchange_strong(originalPosition, position);
+        return;
+    }
+
+    auto* buffer = bufferToFill.buffer;
+    for (int done = 0; done < bufferToFill.numSamples; )
+    {
+        auto start = loopStart.load();
+        auto end = loopEnd.load();
+        auto hasRegion = start >= 0 && end > start;
+        auto inRegion = hasRegion && position >= start && position < end;
+        // break the block at the loop's edges, so the wrap lands on exactly the right sample
+        auto segment = static_cast<juce::int64>(bufferToFill.numSamples - done);
+        if (hasRegion && position < start)
+        {
+            segment = juce::jmin(segment, start - position);
+        }
+        else if (inRegion) {
+            segment = juce::jmin(segment, end - position);
+        }
+        auto numToRead = static_cast<int>(segment);
+        auto destStart = bufferToFill.startSample + done;
+
+        // play from RAM for as much of the loop as has been copied, failing that the cue last jumped to
+        const juce::AudioBuffer<float>* ramBuffer = nullptr;
+        juce::int64 ramStart = 0;
+        juce::int64 ramLength = 0;
+        if (inRegion)
+        {
+            ramBuffer = &loopBuffer;
+            ramStart = start;
+            ramLength = static_cast<juce::int64>(preloadState.load(std::memory_order_acquire) & copiedMask);
+        }
+        if (position - ramStart >= ramLength && activeCue >= 0)
+        {
+            auto index = static_cast<size_t>(activeCue);
+            if ((cueStates[index].load(std::memory_order_acquire) & 1) != 0)
+            {
+                ramBuffer = &cueBuffers[index];
+                ramStart = cuePositions[index].load();
+                ramLength = cueLength;
+            }
+        }
+        int numFromBuffer = 0;
+        if (ramBuffer != nullptr && position >= ramStart)
+        {
+            numFromBuffer = static_cast<int>(juce::jlimit(static_cast<juce::int64>(0),
+                                                          static_cast<juce::int64>(numToRead),
+                                                          ramLength - (position - ramStart)));
+        }
+        if (numFromBuffer > 0)
+        {
+            numToRead = numFromBuffer;
+            for (int chan = 0; chan < buffer->getNumChannels(); ++chan)
+            {
+                buffer->copyFrom(chan, destStart, *ramBuffer, juce::jmin(chan, ramBuffer->getNumChannels() - 1),
+                                 static_cast<int>(position - ramStart), numToRead);
+            }
+            // park the track's source at the end of what is in RAM, so it seeks and buffers while we play from memory
+            auto parkAt = ramBuffer == &loopBuffer ? end : ramStart + ramLength;
+            if (sourcePosition != parkAt)
+            {
+                source->setNextReadPosition(parkAt);
+                sourcePosition = parkAt;
+            }
+        }
+        else if (!scratching.load() || !scratchWindow.read(*buffer, destStart, position, numToRead, false)) {
+            // scratching plays from the window when it can, leaving the track's source alone
+            if (sourcePosition != position)
+            {
+                source->setNextReadPosition(position);
+            }
+            source->getNextAudioBlock(juce::AudioSourceChannelInfo(buffer, destStart, numToRead));
+            sourcePosition = position + numToRead;
+        }
+
+        position += numToRead;
+        done += numToRead;
+        if (rolling.load())
+        {
+            // the track carries on underneath the roll
+            rollPosition += numToRead;
+        }
+        if (inRegion && looping.load() && position >= end)
+        {
+            // wrap
+            position = start;
+        }
+    }
+    lastEndPosition = position;
+    // advance the playhead, only if nobody moved it while we were reading
+    nextPlayPos.compare_exchange_strong(originalPosition, position);
+}
+
+void LoopingAudioSource::renderBackwards(const juce::AudioSourceChannelInfo& bufferToFill, juce::int64& position)
+{
+    auto* buffer = bufferToFill.buffer;
+    for (int done = 0; done < bufferToFill.numSamples; )
+    {
+        auto start = loopStart.load();
+        auto end = loopEnd.load();
+        auto inLoop = looping.load() && start >= 0 && end > start && position > start && position <= end;
+        // stop at the loop start to wrap, and at the start of the track
+        auto segment = static_cast<juce::int64>(bufferToFill.numSamples - done);
+        if (inLoop)
+        {
+            segment = juce::jmin(segment, position - start);
+        }
+        segment = juce::jmin(segment, position);
+        auto destStart = bufferToFill.startSample + done;
+        if (segment <= 0)
+        {
+            // backed up to the very start - nothing more to play
+            buffer->clear(destStart, bufferToFill.numSamples - done);
+            break;
+        }
+        auto numToRead = static_cast<int>(segment);
+        if (!scratchWindow.read(*buffer, destStart, position, numToRead, true))
+        {
+            // the window is still being built around the playhead - keep moving, in silence, rather than seek the decoder backwards
+            buffer->clear(destStart, numToRead);
+        }
+        position -= numToRead;
+        done += numToRead;
+        if (rolling.load())
+        {
+            // the track runs backwards underneath the roll too
+            rollPosition -= numToRead;
+        }
+        if (inLoop && position <= start)
+        {
+            // wrap, backwards
+            position = end;
+        }
+    }
+}
+
+void LoopingAudioSource::setNextReadPosition(juce::int64 newPosition)
+{
+    nextPlayPos = newPosition;
+}
+
+juce::int64 LoopingAudioSource::getNextReadPosition() const
+{
+    return nextPlayPos.load();
+}
+
+juce::int64 LoopingAudioSource::getTotalLength() const
+{
+    return source->getTotalLength();
+}
+
+bool LoopingAudioSource::isLooping() const
+{
+    return false;
+}
+
+void LoopingAudioSource::setLoopIn()
+{
+    push({ActionType::loopIn});
+}
+
+void LoopingAudioSource::setLoopOut()
+{
+    push({ActionType::loopOut});
+}
+
+void LoopingAudioSource::setAutoLoop(juce::int64 length)
+{
+    push({ActionType::autoLoop, length});
+}
+
+void LoopingAudioSource::halveLoop()
+{
+    push({ActionType::halve});
+}
+
+void LoopingAudioSource::doubleLoop()
+{
+    push({ActionType::doubleLength});
+}
+
+void LoopingAudioSource::exitLoop()
+{
+    push({ActionType::exit});
+}
+
+void LoopingAudioSource::startLoopRoll(juce::int64 length)
+{
+    push({ActionType::rollStart, length});
+}
+
+void LoopingAudioSource::stopLoopRoll()
+{
+    push({ActionType::rollEnd});
+}
+
+void LoopingAudioSource::setHotCue(int index, juce::int64 position)
+{
+    if (index >= 0 && index < numHotCues)
+    {
+        push({ActionType::setCue, 0, index, juce::jmax(static_cast<juce::int64>(-1), position)});
+    }
+}
+
+void LoopingAudioSource::jumpToHotCue(int index)
+{
+    if (index >= 0 && index < numHotCues)
+    {
+        push({ActionType::jumpToCue, 0, index});
+    }
+}
+
+void LoopingAudioSource::loadHotCues(const juce::Array<juce::int64>& positions)
+{
+    for (int cue = 0; cue < numHotCues; ++cue)
+    {
+        moveCue(cue, cue < positions.size() ? positions[cue] : -1);
+    }
+}
+
+void LoopingAudioSource::setReverse(bool shouldReverse)
+{
+    reverse.store(shouldReverse);
+    scratchWindow.setActive(reverse.load() || scratching.load());
+}
+
+void LoopingAudioSource::setScratching(bool shouldScratch)
+{
+    scratching.store(shouldScratch);
+    scratchWindow.setActive(reverse.load() || scratching.load());
+}
+
+bool LoopingAudioSource::isLoopActive() const
+{
+    return looping.load();
+}
+
+juce::int64 LoopingAudioSource::getLoopStart() const
+{
+    return loopStart.load();
+}
+
+juce::int64 LoopingAudioSource::getLoopEnd() const
+{
+    return loopEnd.load();
+}
+
+void LoopingAudioSource::push(Action action)
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+    if (size1 + size2 == 0)
+    {
+        DBG("LoopingAudioSource::push queue full, loop action dropped");
+        return;
+    }
+    actions[static_cast<size_t>(start1)] = action;
+    fifo.finishedWrite(1);
+}
+
+void LoopingAudioSource::applyActions(juce::int64& position)
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+
+    // unlike control changes, loop actions are applied one after another in the order they were queued
+    auto apply = [this, &position](int start, int size)
+    {
+        for (int i = start; i < start + size; ++i)
+        {
+            const auto& action = actions[static_cast<size_t>(i)];
+            auto currentStart = loopStart.load();
+            auto currentEnd = loopEnd.load();
+            auto hasRegion = currentStart >= 0 && currentEnd > currentStart;
+            switch (action.type)
+            {
+                case ActionType::loopIn:
+                    pendingLoopIn = position;
+                    if (!looping.load())
+                    {
+                        // start copying from the in point now, so the loop is in RAM by the time the out point is set
+                        preload(position, maxLoopLength);
+                    }
+                    break;
+                case ActionType::loopOut:
+                {
+                    // an out point on its own moves the end of the loop already set
+                    auto in = pendingLoopIn >= 0 ? pendingLoopIn : currentStart;
+                    if (in >= 0 && position > in)
+                    {
+                        setRegion(in, position);
+                        looping = true;
+                        pendingLoopIn = -1;
+                        // the out point is where we are, so wrap straight away
+                        position = loopStart.load();
+                    }
+                    break;
+                }
+                case ActionType::autoLoop:
+                    setRegion(position, position + juce::jmax(minLoopLength, action.length));
+                    looping = true;
+                    pendingLoopIn = -1;
+                    break;
+                case ActionType::halve:
+                    if (hasRegion)
+                    {
+                        auto newLength = juce::jmax(minLoopLength, (currentEnd - currentStart) / 2);
+                        setRegion(currentStart, currentStart + newLength);
+                        if (looping.load() && position >= currentStart + newLength && position < currentEnd)
+                        {
+                            // in the half that has gone - jump back by a loop length to stay in step
+                            position = currentStart + (position - currentStart) % newLength;
+                        }
+                    }
+                    break;
+                case ActionType::doubleLength:
+                    if (hasRegion)
+                    {
+                        setRegion(currentStart, currentStart + (currentEnd - currentStart) * 2);
+                    }
+                    break;
+                case ActionType::exit:
+                    looping = false;
+                    break;
+                case ActionType::rollStart:
+                    if (!rolling.load())
+                    {
+                        // remember the track's place and whatever loop was set, to go back to when the roll ends
+                        rollPosition = position;
+                        loopStartBeforeRoll = currentStart;
+                        loopEndBeforeRoll = currentEnd;
+                        loopingBeforeRoll = looping.load();
+                        rolling = true;
+                        setRegion(position, position + juce::jmax(minLoopLength, action.length));
+                    }
+                    else {
+                        // a new roll length while rolling keeps the roll's start
+                        setRegion(currentStart, currentStart + juce::jmax(minLoopLength, action.length));
+                    }
+                    looping = true;
+                    break;
+                case ActionType::rollEnd:
+                    if (rolling.load())
+                    {
+                        rolling = false;
+                        position = rollPosition;
+                        setRegion(loopStartBeforeRoll, loopEndBeforeRoll);
+                        looping = loopingBeforeRoll;
+                    }
+                    break;
+                case ActionType::setCue:
+                    moveCue(action.cue, action.position);
+                    break;
+                case ActionType::jumpToCue:
+                {
+                    auto cuePosition = cuePositions[static_cast<size_t>(action.cue)].load();
+                    if (cuePosition < 0)
+                    {
+                        break;
+                    }
+                    if (rolling.load())
+                    {
+                        // a jump during a roll moves the track underneath it
+                        rollPosition = cuePosition;
+                        break;
+                    }
+                    if (looping.load() && (cuePosition < currentStart || cuePosition >= currentEnd))
+                    {
+                        // jumping out of the loop leaves it
+                        looping = false;
+                    }
+                    position = cuePosition;
+                    activeCue = action.cue;
+                    break;
+                }
+            }
+        }
+    };
+    apply(start1, size1);
+    apply(start2, size2);
+
+    fifo.finishedRead(size1 + size2);
+}
+
+void LoopingAudioSource::setRegion(juce::int64 start, juce::int64 end)
+{
+    if (start < 0 || end <= start)
+    {
+        // no loop
+        start = -1;
+        end = -1;
+    }
+    else {
+        end = juce::jmin(end, start + maxLoopLength);
+    }
+    preload(start, start >= 0 ? end - start : 0);
+    loopStart = start;
+    loopEnd = end;
+}
+
+void LoopingAudioSource::preload(juce::int64 start, juce::int64 length)
+{
+    auto state = preloadState.load();
+    auto generation = (state >> generationShift) + 1;
+    // a loop that keeps its start keeps what has been copied, up to its new length
+    juce::uint64 copied = 0;
+    if (start >= 0 && start == preloadRegionStart.load())
+    {
+        copied = juce::jmin(state & copiedMask, static_cast<juce::uint64>(length));
+    }
+    // publish the region before the state, so the background thread never sees a state without its region
+    preloadRegionStart.store(start);
+    preloadRegionLength.store(start >= 0 ? length : 0);
+    preloadState.store((generation << generationShift) | copied, std::memory_order_release);
+}
+
+void LoopingAudioSource::moveCue(int cue, juce::int64 position)
+{
+    auto index = static_cast<size_t>(cue);
+    if (activeCue == cue)
+    {
+        // stop playing from the cue's buffer before it is overwritten
+        activeCue = -1;
+    }
+    // publish the position before the state, and drop the in RAM bit so the cue is copied again
+    cuePositions[index].store(position);
+    auto generation = (cueStates[index].load() >> 1) + 1;
+    cueStates[index].store(generation << 1, std::memory_order_release);
+}
+
+bool LoopingAudioSource::preloadNextCue()
+{
+    for (int cue = 0; cue < numHotCues; ++cue)
+    {
+        auto index = static_cast<size_t>(cue);
+        auto state = cueStates[index].load(std::memory_order_acquire);
+        auto position = cuePositions[index].load();
+        if ((state & 1) != 0 || position < 0 || cueStates[index].load(std::memory_order_acquire) != state)
+        {
+            // already copied, not set, or moved while we were looking
+            continue;
+        }
+        preloadSource->setNextReadPosition(position);
+        preloadSource->getNextAudioBlock(juce::AudioSourceChannelInfo(&cueBuffers[index], 0, static_cast<int>(cueLength)));
+        // publish - unless the cue has moved since, in which case it will be copied again
+        auto expected = state;
+        cueStates[index].compare_exchange_strong(expected, state | 1, std::memory_order_release);
+        return true;
+    }
+    return false;
+}
+
+int LoopingAudioSource::useTimeSlice()
+{
+    // a deck playing backwards or being scratched needs its window now
+    if (scratchWindow.update(*preloadSource))
+    {
+        return 0;
+    }
+    // cues are short and a jump can come at any moment, so they go ahead of loops
+    if (preloadNextCue())
+    {
+        return 0;
+    }
+    auto state = preloadState.load(std::memory_order_acquire);
+    auto start = preloadRegionStart.load();
+    auto length = preloadRegionLength.load();
+    if (preloadState.load(std::memory_order_acquire) != state)
+    {
+        // the loop moved while we were looking - start again
+        return 0;
+    }
+    auto copied = static_cast<juce::int64>(state & copiedMask);
+    if (length <= 0 || copied >= length)
+    {
+        // nothing left to copy
+        return 20;
+    }
+    // the audio thread only reads what has been published as copied, so the part being written here is never heard early
+    auto numToCopy = static_cast<int>(juce::jmin(static_cast<juce::int64>(preloadChunkSize), length - copied));
+    preloadSource->setNextReadPosition(start + copied);
+    preloadSource->getNextAudioBlock(juce::AudioSourceChannelInfo(&loopBuffer, static_cast<int>(copied), numToCopy));
+    // publish - unless the loop has moved since, in which case this chunk is thrown away
+    auto expected = state;
+    preloadState.compare_exchange_strong(expected, state + static_cast<juce::uint64>(numToCopy), std::memory_order_release);
+    return 0;
+}
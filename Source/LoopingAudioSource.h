@@ -0,0 +1,196 @@
+/*
+  ==============================================================================
+
+    LoopingAudioSource.h
+    Created: 20 Oct 2026 9:14:26am
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ScratchWindow.h"
+#include <array>
+#include <atomic>
+#include <memory>
+
+/** the deck's playhead - sits between the track's source and the transport and handles loops and hot cues.
+ loop points are in samples of the track and the wrap happens at exactly the loop end, part way through a block if need be.
+ the loop region is copied into RAM in the background as soon as it is set, so once it is there every pass - and the wrap itself -
+ plays from memory and never waits on the disk or the decoder. until the copy catches up, the track's own source is read instead.
+ the first moments after each hot cue are kept in RAM the same way, so a jump plays from memory while the track's source seeks past them.
+ playing backwards, and scratching in either direction, read from a window of decoded audio kept around the playhead, so direction changes never touch the decoder.
+ loop and cue actions are queued by the message thread and applied at the start of the next block, at the playhead as it stands then */
+class LoopingAudioSource :  public juce::PositionableAudioSource,
+                            private juce::TimeSliceClient
+{
+public:
+    /** inputs: the track's source, not owned - must outlive this (juce::PositionableAudioSource*); a second, independent source for the same track, only ever read on the background thread (std::unique_ptr<juce::PositionableAudioSource>); reference to the thread that copies loops into RAM (juce::TimeSliceThread&); sample rate of the track (double)
+     constructor */
+    LoopingAudioSource(juce::PositionableAudioSource* source,
+                       std::unique_ptr<juce::PositionableAudioSource> preloadSource,
+                       juce::TimeSliceThread& backgroundThread,
+                       double sampleRate);
+    /**
+     destructor */
+    ~LoopingAudioSource() override;
+    /** inputs: expected number of samples per audio block [buffer] (int); sample rate the output will be used at (double)
+     From https://docs.juce.com/master/classAudioSource.html "Tells the source to prepare for playing."
+     prepares the track's source and registers with the background thread */
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    /**
+     From https://docs.juce.com/master/classAudioSource.html "Allows the source to release anything it no longer needs after playback has stopped." */
+    void releaseResources() override;
+    /** inputs: reference to the target channel buffer (juce::AudioSourceChannelInfo&)
+     From https://docs.juce.com/master/classAudioSource.html "Called repeatedly to fetch subsequent blocks of audio data."
+     applies queued loop actions, then plays on from the playhead, wrapping at the loop end */
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    /** inputs: absolute position to read from next - in samples (juce::int64) */
+    void setNextReadPosition(juce::int64 newPosition) override;
+    /** outputs: absolute position that will be read from next - in samples (juce::int64) */
+    juce::int64 getNextReadPosition() const override;
+    /** outputs: total length of the track - in samples (juce::int64) */
+    juce::int64 getTotalLength() const override;
+    /** outputs: flag stating whether the source wraps at the end of the track - it never does (bool) */
+    bool isLooping() const override;
+
+    /** marks the loop in point at the playhead */
+    void setLoopIn();
+    /** marks the loop out point at the playhead and starts looping back to the in point */
+    void setLoopOut();
+    /** inputs: length of the loop - in samples (juce::int64) | starts a loop of that length at the playhead */
+    void setAutoLoop(juce::int64 length);
+    /** halves the loop, keeping its start - the playhead stays in step if it was in the half that goes */
+    void halveLoop();
+    /** doubles the loop, keeping its start */
+    void doubleLoop();
+    /** stops looping - playback carries on out of the loop end */
+    void exitLoop();
+    /** inputs: length of the roll - in samples (juce::int64) | loops that length from the playhead while the track carries on silently underneath */
+    void startLoopRoll(juce::int64 length);
+    /** ends the roll, picking the track up where it would have been had it never rolled */
+    void stopLoopRoll();
+
+    /** inputs: index of the cue, from 0 (int); position of the cue, -1 to clear it - in samples (juce::int64) | sets a hot cue and has the audio just after it copied into RAM */
+    void setHotCue(int index, juce::int64 position);
+    /** inputs: index of the cue, from 0 (int) | jumps the playhead to a hot cue, leaving any loop the cue is outside of */
+    void jumpToHotCue(int index);
+    /** inputs: positions of the hot cues, -1 for those not set - in samples (const juce::Array<juce::int64>&)
+     sets every hot cue at once - only before the source is handed to the audio thread, so the cues are in RAM before the first block */
+    void loadHotCues(const juce::Array<juce::int64>& positions);
+
+    /** inputs: flag stating whether the playhead should move backwards (bool) | the samples before the playhead are played nearest first, from the scratch window */
+    void setReverse(bool shouldReverse);
+    /** inputs: flag stating whether the deck is being scratched (bool) | while scratching, forwards play also comes from the scratch window, so it is there for the next change of direction */
+    void setScratching(bool shouldScratch);
+
+    /** outputs: flag stating whether a loop or roll is playing (bool) */
+    bool isLoopActive() const;
+    /** outputs: loop start, -1 if no loop has been set (juce::int64) */
+    juce::int64 getLoopStart() const;
+    /** outputs: loop end, -1 if no loop has been set (juce::int64) */
+    juce::int64 getLoopEnd() const;
+
+    /** longest loop that can be held in RAM - in seconds */
+    static constexpr double maxLoopSeconds = 32.0;
+    /** number of hot cues per track */
+    static constexpr int numHotCues = 8;
+    /** audio kept in RAM after each hot cue - long enough for any source to have seeked and refilled - in seconds */
+    static constexpr double hotCueSeconds = 0.5;
+
+private:
+    /** the loop actions that can be queued */
+    enum class ActionType
+    {
+        loopIn,
+        loopOut,
+        autoLoop,
+        halve,
+        doubleLength,
+        exit,
+        rollStart,
+        rollEnd,
+        setCue,
+        jumpToCue
+    };
+    struct Action
+    {
+        ActionType type;
+        juce::int64 length = 0;
+        int cue = 0;
+        juce::int64 position = -1;
+    };
+
+    /** inputs: the action to queue (Action) | wait-free - message thread only */
+    void push(Action action);
+    /** inputs: position of the playhead - in samples (juce::int64&) | applies every queued action, moving the playhead if an action calls for it - audio thread only */
+    void applyActions(juce::int64& position);
+    /** inputs: loop start, -1 for no loop (juce::int64); loop end (juce::int64) | moves the loop and has it copied into RAM - audio thread only */
+    void setRegion(juce::int64 start, juce::int64 end);
+    /** inputs: first sample to copy, -1 for none (juce::int64); number of samples to copy (juce::int64) | tells the background thread what to copy, keeping whatever is already copied if the start has not moved - audio thread only */
+    void preload(juce::int64 start, juce::int64 length);
+    /** inputs: index of the cue (int); position of the cue, -1 to clear it (juce::int64) | moves the cue and has it copied into RAM - audio thread, or before the audio thread has seen the source */
+    void moveCue(int cue, juce::int64 position);
+    /** outputs: flag stating whether a cue was copied (bool)
+     copies the first hot cue waiting to be copied into RAM - background thread only */
+    bool preloadNextCue();
+    /** inputs: reference to the target channel buffer (juce::AudioSourceChannelInfo&); position of the playhead - in samples (juce::int64&)
+     plays backwards from the playhead, wrapping at the loop start - audio thread only */
+    void renderBackwards(const juce::AudioSourceChannelInfo& bufferToFill, juce::int64& position);
+    /** outputs: milliseconds to wait before being called again (int)
+     From https://docs.juce.com/master/classTimeSliceClient.html "Called back by a TimeSliceThread."
+     copies the next chunk of the loop region into RAM */
+    int useTimeSlice() override;
+
+    /** the preload state packs the region generation into the top bits and the number of samples copied so far into the rest, so both change in one step */
+    static constexpr int generationShift = 40;
+    static constexpr juce::uint64 copiedMask = (static_cast<juce::uint64>(1) << generationShift) - 1;
+
+    juce::PositionableAudioSource* source;
+    std::unique_ptr<juce::PositionableAudioSource> preloadSource;
+    juce::TimeSliceThread& backgroundThread;
+    juce::AudioBuffer<float> loopBuffer;
+    juce::int64 maxLoopLength;
+
+    juce::AbstractFifo fifo{64};
+    std::array<Action, 64> actions;
+
+    std::atomic<juce::int64> nextPlayPos{0};
+    /** where the track's source will read from next, so it is only moved when it has to be - audio thread only */
+    juce::int64 sourcePosition = -1;
+    std::atomic<juce::int64> loopStart{-1};
+    std::atomic<juce::int64> loopEnd{-1};
+    std::atomic<bool> looping{false};
+    std::atomic<bool> rolling{false};
+    /** in point waiting for an out point - audio thread only */
+    juce::int64 pendingLoopIn = -1;
+    /** where the track would be had it not rolled, and the loop to go back to afterwards - audio thread only */
+    juce::int64 rollPosition = 0;
+    juce::int64 loopStartBeforeRoll = -1;
+    juce::int64 loopEndBeforeRoll = -1;
+    bool loopingBeforeRoll = false;
+
+    /** region to copy, written by the audio thread before the preload state that publishes it */
+    std::atomic<juce::int64> preloadRegionStart{0};
+    std::atomic<juce::int64> preloadRegionLength{0};
+    std::atomic<juce::uint64> preloadState{0};
+
+    /** the audio after each hot cue, and the cue positions */
+    std::array<juce::AudioBuffer<float>, numHotCues> cueBuffers;
+    juce::int64 cueLength;
+    std::array<std::atomic<juce::int64>, numHotCues> cuePositions;
+    /** per cue - a generation bumped each time the cue moves, shifted up one, with the bottom bit set once the cue is in RAM */
+    std::array<std::atomic<juce::uint64>, numHotCues> cueStates;
+    /** cue last jumped to, played from RAM while the playhead is within its buffer - audio thread only */
+    int activeCue = -1;
+    /** where the last block left the playhead, to tell when it has been moved from outside - audio thread only */
+    juce::int64 lastEndPosition = -1;
+
+    ScratchWindow scratchWindow;
+    std::atomic<bool> reverse{false};
+    std::atomic<bool> scratching{false};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LoopingAudioSource)
+};
@@ -0,0 +1,158 @@
+/*
+  ==============================================================================
+
+    LoudnessAnalyser.cpp
+    Created: 20 Oct 2026 7:38:15pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#include "LoudnessAnalyser.h"
+
+LoudnessAnalyser::LoudnessAnalyser(double _sampleRate, juce::int64 lengthInSamples)
+    : sampleRate(_sampleRate),
+    stepLength(juce::jmax(1, static_cast<int>(std::round(stepSeconds * _sampleRate)))),
+    coefficients(getKWeighting(juce::jmax(1.0, _sampleRate))),
+    oversampler(2, oversamplingOrder, juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple, false)
+{
+    // nothing is processed in pieces longer than a step
+    oversampler.initProcessing(static_cast<size_t>(stepLength));
+    stepPowers.reserve(static_cast<size_t>(juce::jmax(static_cast<juce::int64>(0), lengthInSamples) / stepLength + 1));
+}
+
+void LoudnessAnalyser::process(const juce::AudioBuffer<float>& block, int numSamples)
+{
+    if (block.getNumChannels() == 0)
+    {
+        return;
+    }
+    auto rightChannel = juce::jmin(1, block.getNumChannels() - 1);
+    for (int done = 0; done < numSamples; )
+    {
+        // blocks don't line up with the steps, so finish the step under way before starting the next
+        auto num = juce::jmin(numSamples - done, stepLength - stepFill);
+        const float* channels[2] = { block.getReadPointer(0, done), block.getReadPointer(rightChannel, done) };
+        stepPower += DSPKernels::kWeightedPowerStereo(channels[0], channels[1], num, filterState, coefficients);
+        stepFill += num;
+        // gating only counts whole steps - a short one at the end is only checked for peaks
+        if (stepFill == stepLength)
+        {
+            stepPowers.push_back(stepPower / stepLength);
+            stepPower = 0.0;
+            stepFill = 0;
+        }
+        // the highest sample, and the highest point between samples
+        juce::dsp::AudioBlock<const float> audioBlock(channels, 2, static_cast<size_t>(num));
+        auto oversampled = oversampler.processSamplesUp(audioBlock);
+        for (int chan = 0; chan < 2; ++chan)
+        {
+            auto samples = juce::FloatVectorOperations::findMinAndMax(channels[chan], num);
+            auto between = juce::FloatVectorOperations::findMinAndMax(oversampled.getChannelPointer(static_cast<size_t>(chan)),
+                                                                     static_cast<int>(oversampled.getNumSamples()));
+            peak = juce::jmax(peak, -samples.getStart(), samples.getEnd());
+            peak = juce::jmax(peak, -between.getStart(), between.getEnd());
+        }
+        done += num;
+    }
+}
+
+LoudnessAnalyser::Result LoudnessAnalyser::getResult() const
+{
+    Result result;
+    if (sampleRate <= 0.0)
+    {
+        return result;
+    }
+    // 400 ms gating blocks, each starting 100 ms after the last
+    std::vector<double> blockPowers;
+    blockPowers.reserve(stepPowers.size());
+    for (size_t last = stepsPerBlock - 1; last < stepPowers.size(); ++last)
+    {
+        auto total = 0.0;
+        for (size_t step = last + 1 - stepsPerBlock; step <= last; ++step)
+        {
+            total += stepPowers[step];
+        }
+        blockPowers.push_back(total / stepsPerBlock);
+    }
+    auto loudness = getGatedLoudness(blockPowers);
+    if (!std::isfinite(loudness))
+    {
+        // too short, or silent all the way through
+        return result;
+    }
+    result.loudness = loudness;
+    result.truePeak = juce::Decibels::gainToDecibels(peak, -100.0f);
+    result.valid = true;
+    return result;
+}
+
+DSPKernels::KWeightingCoefficients LoudnessAnalyser::getKWeighting(double sampleRate)
+{
+    // the filters BS.1770 specifies at 48 kHz, worked back to their analogue prototypes so they can be rebuilt at any rate
+    DSPKernels::KWeightingCoefficients c;
+    {
+        // high shelf, +4 dB above about 1.5 kHz - the head's effect on what reaches the ear
+        constexpr double frequency = 1681.974450955533;
+        constexpr double gain = 3.999843853973347;
+        constexpr double q = 0.7071752369554196;
+        auto k = std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+        auto vh = std::pow(10.0, gain / 20.0);
+        auto vb = std::pow(vh, 0.4996667741545416);
+        auto a0 = 1.0 + k / q + k * k;
+        c.shelfB0 = static_cast<float>((vh + vb * k / q + k * k) / a0);
+        c.shelfB1 = static_cast<float>(2.0 * (k * k - vh) / a0);
+        c.shelfB2 = static_cast<float>((vh - vb * k / q + k * k) / a0);
+        c.shelfA1 = static_cast<float>(2.0 * (k * k - 1.0) / a0);
+        c.shelfA2 = static_cast<float>((1.0 - k / q + k * k) / a0);
+    }
+    {
+        // high pass at about 38 Hz - the ear hardly hears the deep bass
+        constexpr double frequency = 38.13547087602444;
+        constexpr double q = 0.5003270373238773;
+        auto k = std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+        auto a0 = 1.0 + k / q + k * k;
+        c.highPassB0 = 1.0f;
+        c.highPassB1 = -2.0f;
+        c.highPassB2 = 1.0f;
+        c.highPassA1 = static_cast<float>(2.0 * (k * k - 1.0) / a0);
+        c.highPassA2 = static_cast<float>((1.0 - k / q + k * k) / a0);
+    }
+    return c;
+}
+
+double LoudnessAnalyser::getGatedLoudness(const std::vector<double>& blockPowers)
+{
+    // first leave out the silence, then anything well below the loudness of what is left
+    auto threshold = absoluteGate;
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        auto total = 0.0;
+        int count = 0;
+        for (auto power : blockPowers)
+        {
+            if (powerToLoudness(power) > threshold)
+            {
+                total += power;
+                ++count;
+            }
+        }
+        if (count == 0)
+        {
+            break;
+        }
+        auto loudness = powerToLoudness(total / count);
+        if (pass == 1)
+        {
+            return loudness;
+        }
+        threshold = loudness + relativeGate;
+    }
+    return -std::numeric_limits<double>::infinity();
+}
+
+double LoudnessAnalyser::powerToLoudness(double power)
+{
+    return power > 0.0 ? -0.691 + 10.0 * std::log10(power) : -std::numeric_limits<double>::infinity();
+}
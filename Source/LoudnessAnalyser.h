@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+    LoudnessAnalyser.h
+    Created: 20 Oct 2026 7:38:15pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DSPKernels.h"
+#include <vector>
+
+/** measures a track's loudness the way EBU R128 does, so decks can be matched by how loud they sound rather than by their peaks.
+ the track is fed in block by block, from the one pass that decodes it for every analysis that needs all of it. every 100 ms of it is K-weighted - filtered to roughly the ear's sensitivity - and its power summed as it goes,
+ and the 400 ms gating blocks are built from those summaries, so leaving out the silent and quiet parts costs next to nothing.
+ the true peak, how high the waveform goes between samples once it is turned back into sound, is read off a 4x oversampled copy */
+class LoudnessAnalyser
+{
+public:
+    /** what the analysis found */
+    struct Result
+    {
+        /** false if the file could not be read, was too short or silent, or analysis was stopped */
+        bool valid = false;
+        /** integrated loudness - in LUFS */
+        double loudness = 0.0;
+        /** true peak - in dBTP */
+        double truePeak = 0.0;
+    };
+
+    /** inputs: sample rate of the track (double); length of the track, to size the summaries up front - in samples (juce::int64)
+     constructor */
+    LoudnessAnalyser(double _sampleRate, juce::int64 lengthInSamples);
+    /** inputs: the next block of the track, in order from the start - a mono track read into both channels, as it is heard (const juce::AudioBuffer<float>&); number of samples in the block (int)
+     K-weights the first two channels of the block and adds them to the power summaries and the peak */
+    void process(const juce::AudioBuffer<float>& block, int numSamples);
+    /** outputs: integrated loudness and true peak (Result)
+     call once the whole track has been processed */
+    Result getResult() const;
+    /** inputs: sample rate (double) | outputs: the BS.1770 K-weighting filter at that rate (DSPKernels::KWeightingCoefficients) */
+    static DSPKernels::KWeightingCoefficients getKWeighting(double sampleRate);
+
+    /** length of each power summary, and how many make up a gating block - in seconds, and steps */
+    static constexpr double stepSeconds = 0.1;
+    static constexpr int stepsPerBlock = 4;
+    /** blocks quieter than this are left out as silence - in LUFS */
+    static constexpr double absoluteGate = -70.0;
+    /** then blocks this far below the loudness of what is left are left out too - in LU */
+    static constexpr double relativeGate = -10.0;
+    /** the true peak is measured at 2 to the power of this times the sample rate */
+    static constexpr int oversamplingOrder = 2;
+
+private:
+    /** inputs: mean power of each gating block (const std::vector<double>&) | outputs: loudness of the blocks that pass both gates, minus infinity if none do - in LUFS (double) */
+    static double getGatedLoudness(const std::vector<double>& blockPowers);
+    /** inputs: mean power of the K-weighted channels, summed (double) | outputs: loudness - in LUFS (double) */
+    static double powerToLoudness(double power);
+
+    double sampleRate;
+    /** length of each power summary - in samples */
+    int stepLength;
+    DSPKernels::KWeightingCoefficients coefficients;
+    float filterState[8] = {};
+    juce::dsp::Oversampling<float> oversampler;
+    /** power summed so far over the step under way, and the samples it covers */
+    double stepPower = 0.0;
+    int stepFill = 0;
+    /** mean power of each whole step so far */
+    std::vector<double> stepPowers;
+    float peak = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LoudnessAnalyser)
+};
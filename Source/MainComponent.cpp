@@ -23,9 +23,41 @@ MainComponent::MainComponent()
     // set the background color to be black for the whole app
     getLookAndFeel().setColour(juce::ResizableWindow::backgroundColourId, juce::Colours::black);
     
-    // reveal both decks
-    addAndMakeVisible(deckGUI1);
-    addAndMakeVisible(deckGUI2);
+    // offer every deck count the engine supports, starting with two decks
+    for (int numDecks = DeckEngine::minDecks; numDecks <= DeckEngine::maxDecks; ++numDecks)
+    {
+        deckCountBox.addItem(juce::String(numDecks) + " decks", numDecks);
+    }
+    deckCountBox.addListener(this);
+    addAndMakeVisible(deckCountBox);
+    // reveal the decks
+    setNumDecks(DeckEngine::minDecks);
+    deckCountBox.setSelectedId(DeckEngine::minDecks, juce::dontSendNotification);
+    // crossfader, from the A decks on the left to the B decks on the right, double click to centre
+    crossfaderSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    crossfaderSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
+    crossfaderSlider.setRange(-1.0, 1.0);
+    crossfaderSlider.setValue(0.0);
+    crossfaderSlider.setDoubleClickReturnValue(true, 0.0);
+    crossfaderSlider.addListener(this);
+    addAndMakeVisible(crossfaderSlider);
+    // master tempo, in beats per minute, for synced decks to follow
+    masterTempoSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    masterTempoSlider.setTextBoxStyle(juce::Slider::TextBoxLeft, false, 60, 30);
+    masterTempoSlider.setRange(60.0, 200.0, 0.1);
+    masterTempoSlider.setValue(deckEngine.getMasterClock().getTempo());
+    masterTempoSlider.setTextValueSuffix(" BPM");
+    masterTempoSlider.addListener(this);
+    addAndMakeVisible(masterTempoSlider);
+    // show tracks sent from the playlist on the deck they went to
+    playlistComponent.onTrackLoaded = [this](int deck, juce::URL url, juce::String title)
+    {
+        if (deck >= 0 && deck < static_cast<int>(deckGUIs.size()))
+        {
+            deckGUIs[static_cast<size_t>(deck)]->waveformDisplay.loadURL(url);
+            deckGUIs[static_cast<size_t>(deck)]->waveformDisplay.setCurrentTrackTitle(title);
+        }
+    };
     // reveal playlist component
     addAndMakeVisible(playlistComponent);
     // register basic formats once ahead of other component creation
@@ -42,18 +74,14 @@ MainComponent::~MainComponent()
 //==============================================================================
 void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
 {
-    // register both players with mixerSource for parallel playback
-    mixerSource.addInputSource(&player1, false);
-    mixerSource.addInputSource(&player2, false);
-    // prepare both players for plaback
-    player1.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    player2.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    // prepare every deck for playback
+    deckEngine.prepareToPlay(samplesPerBlockExpected, sampleRate);
 }
 
 void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
 {
-    // pass incoming audio block to mixerSource
-    mixerSource.getNextAudioBlock(bufferToFill);
+    // pass incoming audio block to the deck engine to be rendered, across its worker threads where possible, and mixed
+    deckEngine.getNextAudioBlock(bufferToFill);
 }
 
 void MainComponent::releaseResources()
@@ -63,11 +91,8 @@ void MainComponent::releaseResources()
 
     // For more details, see the help for AudioProcessor::releaseResources()
     
-    // release resources from sources and players
-    mixerSource.removeAllInputs();
-    mixerSource.releaseResources();
-    player1.releaseResources();
-    player2.releaseResources();
+    // release resources from the decks
+    deckEngine.releaseResources();
 }
 
 //==============================================================================
@@ -79,9 +104,66 @@ void MainComponent::paint (juce::Graphics& g)
 
 void MainComponent::resized()
 {
-    // keep decks within resonable bounds on resize
-    deckGUI1.setBounds(0, 0, getWidth() / 2, getHeight() * 0.6);
-    deckGUI2.setBounds(getWidth() / 2, 0, getWidth() / 2, getHeight() * 0.6);
-    // keep playlist component within resonable bounds on resize
-    playlistComponent.setBounds(0, getHeight() * 0.6, getWidth(), getHeight() * 0.4);
+    // lay decks out in a grid - side by side for two, two by two for up to four, four across beyond that
+    int numDecks = static_cast<int>(deckGUIs.size());
+    int columns = numDecks <= 2 ? juce::jmax(1, numDecks) : (numDecks <= 4 ? 2 : 4);
+    int rows = (numDecks + columns - 1) / juce::jmax(1, columns);
+    int deckW = getWidth() / columns;
+    int deckH = static_cast<int>(getHeight() * 0.6) / juce::jmax(1, rows);
+    for (int i = 0; i < numDecks; ++i)
+    {
+        // keep decks within resonable bounds on resize
+        deckGUIs[static_cast<size_t>(i)]->setBounds((i % columns) * deckW, (i / columns) * deckH, deckW, deckH);
+    }
+    // keep deck count selector, crossfader and playlist component within resonable bounds on resize
+    deckCountBox.setBounds(0, getHeight() * 0.6, getWidth() / 4, 30);
+    crossfaderSlider.setBounds(getWidth() * 3 / 8, getHeight() * 0.6, getWidth() / 4, 30);
+    masterTempoSlider.setBounds(getWidth() * 3 / 4, getHeight() * 0.6, getWidth() / 4, 30);
+    playlistComponent.setBounds(0, getHeight() * 0.6 + 30, getWidth(), getHeight() * 0.4 - 30);
+}
+
+void MainComponent::comboBoxChanged(juce::ComboBox* comboBoxThatHasChanged)
+{
+    if (comboBoxThatHasChanged == &deckCountBox)
+    {
+        // if deck count is changed, grow or shrink the set of decks accordingly
+        setNumDecks(deckCountBox.getSelectedId());
+    }
+}
+
+void MainComponent::sliderValueChanged(juce::Slider* slider)
+{
+    if (slider == &crossfaderSlider)
+    {
+        // if crossfader is moved, pass the new position to the deck engine's mixer
+        deckEngine.setCrossfader(static_cast<float>(slider->getValue()));
+    }
+    if (slider == &masterTempoSlider)
+    {
+        // if master tempo is moved, set the clock every synced deck follows
+        deckEngine.getMasterClock().setTempo(slider->getValue());
+    }
+}
+
+void MainComponent::setNumDecks(int numDecks)
+{
+    deckEngine.setNumDecks(numDecks);
+    numDecks = deckEngine.getNumDecks();
+    // drop GUIs for decks that have gone, and build them for decks that have arrived
+    while (static_cast<int>(deckGUIs.size()) > numDecks)
+    {
+        deckGUIs.pop_back();
+    }
+    while (static_cast<int>(deckGUIs.size()) < numDecks)
+    {
+        auto deck = static_cast<int>(deckGUIs.size());
+        deckGUIs.push_back(std::make_unique<DeckGUI>(deckEngine.getDeck(deck), formatManager, thumbCache));
+        // store hot cues set on the deck with the track in the library
+        deckGUIs.back()->onHotCueChanged = [this](juce::URL url, int cue, double seconds)
+        {
+            playlistComponent.setHotCue(url, cue, seconds);
+        };
+        addAndMakeVisible(*deckGUIs.back());
+    }
+    resized();
 }
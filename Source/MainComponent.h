@@ -1,7 +1,7 @@
 #pragma once
 
 #include <JuceHeader.h>
-#include "DJAudioPlayer.h"
+#include "DeckEngine.h"
 #include "DeckGUI.h"
 #include "PlaylistComponent.h"
 
@@ -10,7 +10,9 @@
     This component lives inside our window, and this is where you should put all
     your controls and content.
 */
-class MainComponent  : public juce::AudioAppComponent
+class MainComponent  : public juce::AudioAppComponent,
+                       public juce::ComboBox::Listener,
+                       public juce::Slider::Listener
 {
 public:
     //==============================================================================
@@ -44,22 +46,36 @@ public:
      from https://docs.juce.com/master/classComponent.html#ad896183a68d71daf5816982d1fefd960
      "Called when this component's size has been changed." */
     void resized() override;
+    /** inputs: pointer to the combo box that changed (juce::ComboBox*)
+     from https://docs.juce.com/master/classComboBox_1_1Listener.html
+     "Called when a ComboBox has its selected item changed." */
+    void comboBoxChanged(juce::ComboBox* comboBoxThatHasChanged) override;
+    /** inputs: pointer to the slider registering the change (juce::Slider*)
+     from https://docs.juce.com/master/classSlider_1_1Listener.html#a127bfe68835dc3e584cf3c2a427a27e5
+     "Called when the slider's value is changed." */
+    void sliderValueChanged(juce::Slider* slider) override;
 
 private:
+    /** inputs: number of decks, from DeckEngine::minDecks to DeckEngine::maxDecks (int) | sets the engine's deck count and builds or removes deck GUIs to match */
+    void setNumDecks(int numDecks);
+
     //==============================================================================
     // Your private member variables go here...
     
     juce::AudioFormatManager formatManager;
     juce::AudioThumbnailCache thumbCache{100};
+    // decoded audio shared by all decks, 1GB before the least recently used tracks are dropped
+    DecodedTrackCache trackCache{static_cast<juce::int64>(1) << 30};
 
-    DJAudioPlayer player1{formatManager};
-    DeckGUI deckGUI1{&player1, formatManager, thumbCache};
-    DJAudioPlayer player2{formatManager};
-    DeckGUI deckGUI2{&player2, formatManager, thumbCache};
+    DeckEngine deckEngine{formatManager, trackCache};
+    std::vector<std::unique_ptr<DeckGUI>> deckGUIs;
     
-    juce::MixerAudioSource mixerSource;
+    juce::ComboBox deckCountBox;
+    juce::Slider crossfaderSlider;
+    /** tempo of the master clock synced decks follow */
+    juce::Slider masterTempoSlider;
     
-    PlaylistComponent playlistComponent{&player1, &player2, &deckGUI1.waveformDisplay, &deckGUI2.waveformDisplay, formatManager};
+    PlaylistComponent playlistComponent{deckEngine, formatManager};
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MainComponent)
     
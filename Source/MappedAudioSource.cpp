@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+
+    MappedAudioSource.cpp
+    Created: 19 Oct 2026 6:21:47pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#include "MappedAudioSource.h"
+
+namespace
+{
+    /** size of a virtual memory page - 4k on every platform we run on, larger pages are still covered by touching every 4k */
+    constexpr int pageSize = 4096;
+}
+
+MappedAudioSource::MappedAudioSource(std::unique_ptr<juce::MemoryMappedAudioFormatReader> _reader,
+                                     juce::TimeSliceThread& _backgroundThread,
+                                     int _numberOfSamplesToPrefault)
+    : reader(std::move(_reader)),
+    backgroundThread(_backgroundThread),
+    numberOfSamplesToPrefault(juce::jmax(1024, _numberOfSamplesToPrefault))
+{
+    jassert(reader != nullptr);
+    auto bytesPerFrame = juce::jmax(1, static_cast<int>(reader->numChannels * reader->bitsPerSample / 8));
+    samplesPerPage = juce::jmax(1, pageSize / bytesPerFrame);
+}
+
+MappedAudioSource::~MappedAudioSource()
+{
+    // make sure the background thread is finished with us before going away
+    releaseResources();
+}
+
+void MappedAudioSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    // hand over to the background thread and ask it to fault in around the playhead straight away
+    backgroundThread.addTimeSliceClient(this);
+    backgroundThread.moveToFrontOfQueue(this);
+}
+
+void MappedAudioSource::releaseResources()
+{
+    // wait for the background thread to let go of us
+    backgroundThread.removeTimeSliceClient(this);
+}
+
+void MappedAudioSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    auto pos = nextPlayPos.load();
+    // work out how much of the block lies within the file
+    auto numAvailable = static_cast<int>(juce::jlimit(static_cast<juce::int64>(0),
+                                                      static_cast<juce::int64>(bufferToFill.numSamples),
+                                                      getTotalLength() - pos));
+    if (pos < 0 || numAvailable == 0)
+    {
+        bufferToFill.clearActiveBufferRegion();
+    }
+    else {
+        // convert straight from the mapped file into the output - mono files feed both channels
+        reader->read(bufferToFill.buffer, bufferToFill.startSample, numAvailable, pos, true, true);
+        // silence whatever runs past the end of the file
+        if (numAvailable < bufferToFill.numSamples)
+        {
+            bufferToFill.buffer->clear(bufferToFill.startSample + numAvailable,
+                                       bufferToFill.numSamples - numAvailable);
+        }
+    }
+    // advance the playhead, only if nobody moved it while we were reading
+    nextPlayPos.compare_exchange_strong(pos, pos + bufferToFill.numSamples);
+}
+
+void MappedAudioSource::setNextReadPosition(juce::int64 newPosition)
+{
+    // move the playhead and wake the background thread so the new spot is faulted in as soon as possible
+    nextPlayPos = newPosition;
+    backgroundThread.notify();
+}
+
+juce::int64 MappedAudioSource::getNextReadPosition() const
+{
+    return nextPlayPos.load();
+}
+
+juce::int64 MappedAudioSource::getTotalLength() const
+{
+    return reader->lengthInSamples;
+}
+
+bool MappedAudioSource::isLooping() const
+{
+    return false;
+}
+
+std::unique_ptr<juce::MemoryMappedAudioFormatReader> MappedAudioSource::createMappedReader(juce::URL audioURL, juce::AudioFormatManager& formatManager)
+{
+    if (!audioURL.isLocalFile())
+    {
+        return nullptr;
+    }
+    auto file = audioURL.getLocalFile();
+    // only formats that store plain samples can be mapped - the rest give back nullptr here
+    auto* format = formatManager.findFormatForFileExtension(file.getFileExtension());
+    if (format == nullptr)
+    {
+        return nullptr;
+    }
+    std::unique_ptr<juce::MemoryMappedAudioFormatReader> mappedReader(format->createMemoryMappedReader(file));
+    if (mappedReader == nullptr || !mappedReader->mapEntireFile())
+    {
+        return nullptr;
+    }
+    return mappedReader;
+}
+
+int MappedAudioSource::useTimeSlice()
+{
+    // a little behind the playhead too, for nudges and short jumps back
+    auto pos = nextPlayPos.load();
+    auto start = juce::jmax(static_cast<juce::int64>(0), pos - numberOfSamplesToPrefault / 4);
+    auto end = juce::jmin(getTotalLength(), pos + numberOfSamplesToPrefault);
+    // reading one byte per page is enough to have the OS bring it in - pages already resident cost next to nothing
+    for (auto sample = start; sample < end; sample += samplesPerPage)
+    {
+        reader->touchSample(sample);
+    }
+    return 50;
+}
@@ -0,0 +1,69 @@
+/*
+  ==============================================================================
+
+    MappedAudioSource.h
+    Created: 19 Oct 2026 6:21:47pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+/** plays an uncompressed file [WAV, AIFF] straight out of a memory map of the whole file.
+ samples are converted from the mapped file directly into the output buffer, with no read calls and no intermediate copy.
+ a background thread touches the pages around the playhead so that the audio thread does not take the page faults itself */
+class MappedAudioSource :   public juce::PositionableAudioSource,
+                            private juce::TimeSliceClient
+{
+public:
+    /** inputs: reader with the whole file mapped (std::unique_ptr<juce::MemoryMappedAudioFormatReader>); reference to the thread that will prefault the file (juce::TimeSliceThread&); number of samples to keep faulted in ahead of the playhead (int)
+     constructor */
+    MappedAudioSource(std::unique_ptr<juce::MemoryMappedAudioFormatReader> reader,
+                      juce::TimeSliceThread& backgroundThread,
+                      int numberOfSamplesToPrefault);
+    /**
+     destructor */
+    ~MappedAudioSource() override;
+    /** inputs: expected number of samples per audio block [buffer] (int); sample rate the output will be used at (double)
+     From https://docs.juce.com/master/classAudioSource.html "Tells the source to prepare for playing."
+     registers with the background thread, which starts faulting in from the playhead */
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    /**
+     From https://docs.juce.com/master/classAudioSource.html "Allows the source to release anything it no longer needs after playback has stopped."
+     unregisters from the background thread */
+    void releaseResources() override;
+    /** inputs: reference to the target channel buffer (juce::AudioSourceChannelInfo&)
+     From https://docs.juce.com/master/classAudioSource.html "Called repeatedly to fetch subsequent blocks of audio data."
+     converts straight out of the mapped file */
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    /** inputs: absolute position to read from next - in samples (juce::int64) | moves the playhead, background thread faults in around it */
+    void setNextReadPosition(juce::int64 newPosition) override;
+    /** outputs: absolute position that will be read from next - in samples (juce::int64) */
+    juce::int64 getNextReadPosition() const override;
+    /** outputs: total length of the file - in samples (juce::int64) */
+    juce::int64 getTotalLength() const override;
+    /** outputs: flag stating whether the source is looping (bool) */
+    bool isLooping() const override;
+
+    /** inputs: URL of the file to map (juce::URL); reference to the format manager to find a format for the file with (juce::AudioFormatManager&) | outputs: reader with the whole file mapped, nullptr if the file is not local, not a format that can be mapped or could not be mapped (std::unique_ptr<juce::MemoryMappedAudioFormatReader>) */
+    static std::unique_ptr<juce::MemoryMappedAudioFormatReader> createMappedReader(juce::URL audioURL, juce::AudioFormatManager& formatManager);
+
+private:
+    /** outputs: milliseconds to wait before being called again (int)
+     From https://docs.juce.com/master/classTimeSliceClient.html "Called back by a TimeSliceThread."
+     touches every page from a little behind the playhead to the prefault distance ahead of it */
+    int useTimeSlice() override;
+
+    std::unique_ptr<juce::MemoryMappedAudioFormatReader> reader;
+    juce::TimeSliceThread& backgroundThread;
+    int numberOfSamplesToPrefault;
+    /** samples covered by one page of the mapped file */
+    int samplesPerPage;
+    std::atomic<juce::int64> nextPlayPos{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MappedAudioSource)
+};
@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    MasterClock.cpp
+    Created: 20 Oct 2026 4:12:09pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#include "MasterClock.h"
+
+MasterClock::MasterClock()
+{
+}
+
+MasterClock::~MasterClock()
+{
+}
+
+void MasterClock::prepare(double newSampleRate)
+{
+    // carry on from the beat the clock was on, at the new rate
+    auto now = sampleTime.load();
+    beatsAtOrigin = sampleRate > 0.0 ? getBeatPosition(now) : 0.0;
+    origin = now;
+    sampleRate = newSampleRate;
+    appliedTempo = tempo.load();
+    samplesPerBeat.store(sampleRate * 60.0 / appliedTempo);
+}
+
+void MasterClock::advance(int numSamples)
+{
+    auto now = sampleTime.load() + numSamples;
+    sampleTime.store(now);
+    auto target = tempo.load();
+    if (target != appliedTempo && sampleRate > 0.0)
+    {
+        // rebuild the grid from here at the new tempo, starting from the beat we are on
+        beatsAtOrigin = getBeatPosition(now);
+        origin = now;
+        appliedTempo = target;
+        samplesPerBeat.store(sampleRate * 60.0 / appliedTempo);
+    }
+}
+
+juce::int64 MasterClock::getSampleTime() const
+{
+    return sampleTime.load();
+}
+
+void MasterClock::setTempo(double bpm)
+{
+    // setter for tempo
+    if (bpm < 20.0 || bpm > 400.0)
+    {
+        DBG("MasterClock::setTempo bpm should be between 20 and 400");
+    }
+    else {
+        tempo.store(bpm);
+    }
+}
+
+double MasterClock::getTempo() const
+{
+    return tempo.load();
+}
+
+double MasterClock::getSamplesPerBeat() const
+{
+    return samplesPerBeat.load();
+}
+
+double MasterClock::getBeatPosition(juce::int64 time) const
+{
+    return getPosition().getBeatPosition(time);
+}
+
+juce::int64 MasterClock::getNextQuantizedTime(Quantize quantize) const
+{
+    return getPosition().getNextQuantizedTime(quantize);
+}
+
+MasterClock::Position MasterClock::getPosition() const
+{
+    Position position;
+    position.sampleTime = sampleTime.load();
+    position.samplesPerBeat = samplesPerBeat.load();
+    position.beatsAtOrigin = beatsAtOrigin;
+    position.origin = origin;
+    return position;
+}
+
+double MasterClock::Position::getBeatPosition(juce::int64 time) const
+{
+    if (samplesPerBeat <= 0.0)
+    {
+        return 0.0;
+    }
+    return beatsAtOrigin + static_cast<double>(time - origin) / samplesPerBeat;
+}
+
+juce::int64 MasterClock::Position::getNextQuantizedTime(Quantize quantize) const
+{
+    if (quantize == Quantize::none || samplesPerBeat <= 0.0)
+    {
+        return sampleTime;
+    }
+    // round up to the next whole beat or bar, then back to samples
+    auto step = quantize == Quantize::bar ? static_cast<double>(beatsPerBar) : 1.0;
+    auto beat = std::ceil(getBeatPosition(sampleTime) / step - 1.0e-9) * step;
+    return origin + static_cast<juce::int64>(std::llround((beat - beatsAtOrigin) * samplesPerBeat));
+}
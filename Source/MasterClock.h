@@ -0,0 +1,89 @@
+/*
+  ==============================================================================
+
+    MasterClock.h
+    Created: 20 Oct 2026 4:12:09pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+/** the engine's timeline - counts output samples since the device started and lays a grid of beats and bars over them.
+ every deck sees the same clock, so commands stamped with a sample time, or quantised to the next beat or bar, land on the same sample across decks.
+ the clock only moves on the audio thread, between blocks. tempo changes asked for by other threads are picked up there too,
+ keeping the beat the clock is on, so the grid never jumps */
+class MasterClock
+{
+public:
+    /** how a transport command is lined up with the grid */
+    enum class Quantize
+    {
+        none,
+        beat,
+        bar
+    };
+
+    /** where the clock stands for one block - a copy, so a deck rendered on another thread reads it while the clock itself moves on */
+    struct Position
+    {
+        /** output samples played since the device started, at the start of the block */
+        juce::int64 sampleTime = 0;
+        /** length of a beat, 0 until the clock is prepared - in output samples */
+        double samplesPerBeat = 0.0;
+        /** beats since the grid began at origin */
+        double beatsAtOrigin = 0.0;
+        juce::int64 origin = 0;
+
+        /** inputs: time - in output samples (juce::int64) | outputs: beats since the grid began, fractional part being the phase within the beat (double) */
+        double getBeatPosition(juce::int64 time) const;
+        /** inputs: how to line up (Quantize) | outputs: the first grid line at or after the start of the block, or the start of the block if not quantised - in output samples (juce::int64) */
+        juce::int64 getNextQuantizedTime(Quantize quantize) const;
+    };
+
+    /**
+     constructor */
+    MasterClock();
+    /**
+     destructor */
+    ~MasterClock();
+    /** inputs: sample rate of the output (double) | sets the rate the clock counts at, keeping the beat it is on */
+    void prepare(double sampleRate);
+    /** inputs: number of samples just played (int) | moves the clock on past a block - audio thread only */
+    void advance(int numSamples);
+    /** outputs: output samples played since the device started, the time of the block about to be rendered while rendering (juce::int64) */
+    juce::int64 getSampleTime() const;
+    /** inputs: tempo - in beats per minute (double) | sets the tempo of the grid from the next block on */
+    void setTempo(double bpm);
+    /** outputs: tempo - in beats per minute (double) */
+    double getTempo() const;
+    /** outputs: length of a beat - in output samples (double) */
+    double getSamplesPerBeat() const;
+    /** inputs: time - in output samples (juce::int64) | outputs: beats since the grid began, fractional part being the phase within the beat (double) - audio thread only */
+    double getBeatPosition(juce::int64 sampleTime) const;
+    /** inputs: how to line up (Quantize) | outputs: the first grid line at or after the start of the next block, or the start of the next block if not quantised - in output samples (juce::int64)
+     audio thread only */
+    juce::int64 getNextQuantizedTime(Quantize quantize) const;
+    /** outputs: where the clock stands for the block about to be rendered (Position) - audio thread only */
+    Position getPosition() const;
+
+    /** beats in a bar */
+    static constexpr int beatsPerBar = 4;
+
+private:
+    std::atomic<juce::int64> sampleTime{0};
+    std::atomic<double> tempo{120.0};
+    std::atomic<double> samplesPerBeat{0.0};
+    /** tempo the grid is laid out at - audio thread only */
+    double appliedTempo = 120.0;
+    double sampleRate = 0.0;
+    /** beats since the grid began at sampleTime, kept as the grid is rebuilt for a new tempo - audio thread only */
+    double beatsAtOrigin = 0.0;
+    juce::int64 origin = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MasterClock)
+};
@@ -0,0 +1,202 @@
+/*
+  ==============================================================================
+
+    PitchShifter.cpp
+    Created: 19 Oct 2026 9:34:08am
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#include "PitchShifter.h"
+#include "DSPKernels.h"
+#include <limits>
+
+PitchShifter::PitchShifter()
+{
+}
+
+PitchShifter::~PitchShifter()
+{
+}
+
+void PitchShifter::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    // allocate everything up front, nothing is allocated once audio is running
+    delayLine.setSize(static_cast<int>(spec.numChannels), delayLineSize);
+    midLine.allocate(delayLineSize * 2, true);
+    window.allocate(windowLength, true);
+    // periodic Hann window - the two heads are half a grain apart so their gains always sum to one
+    for (int i = 0; i < windowLength; ++i)
+    {
+        window[i] = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * i / windowLength);
+    }
+    // fade the shifted signal in and out over 10ms when the shift is engaged or released
+    wetLevel.reset(spec.sampleRate, 0.01);
+    reset();
+}
+
+void PitchShifter::reset()
+{
+    delayLine.clear();
+    juce::FloatVectorOperations::clear(midLine.get(), delayLineSize * 2);
+    for (auto& head : heads)
+    {
+        head = ReadHead();
+    }
+    numWritten = 0;
+    samplesUntilNextGrain = 0;
+}
+
+void PitchShifter::setShift(float semitones)
+{
+    // setter for key shift
+    auto shift = juce::jlimit(-12.0f, 12.0f, semitones);
+    pitchRatio = std::pow(2.0, shift / 12.0);
+    wetLevel.setTargetValue(shift == 0.0f ? 0.0f : 1.0f);
+}
+
+void PitchShifter::process(const juce::dsp::ProcessContextReplacing<float>& context)
+{
+    auto& block = context.getOutputBlock();
+    auto numChannels = juce::jmin(static_cast<int>(block.getNumChannels()), delayLine.getNumChannels());
+    auto numSamples = static_cast<int>(block.getNumSamples());
+    // with no shift the block passes through untouched, but the delay line is kept current so engaging is seamless
+    auto bypassed = !wetLevel.isSmoothing() && wetLevel.getTargetValue() == 0.0f;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        // write the incoming sample, and its mono mix for the alignment search
+        auto writeIndex = static_cast<int>(numWritten & delayLineMask);
+        auto mid = 0.0f;
+        for (int chan = 0; chan < numChannels; ++chan)
+        {
+            auto sample = block.getSample(chan, i);
+            delayLine.getWritePointer(chan)[writeIndex] = sample;
+            mid += sample;
+        }
+        midLine[writeIndex] = mid;
+        midLine[writeIndex + delayLineSize] = mid;
+        ++numWritten;
+
+        if (bypassed)
+        {
+            continue;
+        }
+        if (samplesUntilNextGrain == 0)
+        {
+            startGrain();
+            samplesUntilNextGrain = hopSize;
+        }
+        --samplesUntilNextGrain;
+
+        auto wet = wetLevel.getNextValue();
+        for (int chan = 0; chan < numChannels; ++chan)
+        {
+            auto* line = delayLine.getReadPointer(chan);
+            auto shifted = 0.0f;
+            for (auto& head : heads)
+            {
+                if (head.age < windowLength)
+                {
+                    shifted += window[head.age] * readDelay(line, head.position);
+                }
+            }
+            auto dry = block.getSample(chan, i);
+            block.setSample(chan, i, dry + (shifted - dry) * wet);
+        }
+        // the heads move through the input at the pitch ratio while the output moves on one sample
+        for (auto& head : heads)
+        {
+            if (head.age < windowLength)
+            {
+                head.position += head.rate;
+                ++head.age;
+            }
+        }
+    }
+
+    if (bypassed)
+    {
+        // start afresh whenever the shift is engaged again
+        for (auto& head : heads)
+        {
+            head.age = windowLength;
+        }
+        samplesUntilNextGrain = 0;
+    }
+}
+
+double PitchShifter::getLatencySamples() const
+{
+    auto wet = static_cast<double>(wetLevel.getCurrentValue());
+    if (wet <= 0.0)
+    {
+        return 0.0;
+    }
+    // what is heard is the two heads mixed by their windows, then mixed with the undelayed input by the wet level
+    auto delay = 0.0;
+    auto weight = 0.0;
+    for (const auto& head : heads)
+    {
+        if (head.age < windowLength)
+        {
+            delay += window[head.age] * (static_cast<double>(numWritten) - head.position);
+            weight += window[head.age];
+        }
+    }
+    return weight > 0.0 ? wet * delay / weight : 0.0;
+}
+
+void PitchShifter::startGrain()
+{
+    auto newest = numWritten - 1;
+    // a head reading faster than the input is written must start far enough back not to overtake it before the grain ends
+    auto overtake = juce::jmax(0.0, pitchRatio - 1.0) * windowLength;
+    auto latestStart = newest - 1 - static_cast<juce::int64>(std::ceil(overtake));
+
+    // the head that has finished its grain takes the next one
+    auto& next = heads[0].age >= heads[1].age ? heads[0] : heads[1];
+    auto& playing = &next == &heads[0] ? heads[1] : heads[0];
+    auto start = latestStart;
+    if (playing.age < windowLength)
+    {
+        start = findBestStart(newest, latestStart, playing.position);
+    }
+    next.position = static_cast<double>(start);
+    next.rate = pitchRatio;
+    next.age = 0;
+}
+
+juce::int64 PitchShifter::findBestStart(juce::int64 newest, juce::int64 latestStart, double otherPosition) const
+{
+    // compare what led up to each candidate with what led up to the playing head, so the fade joins two waveforms in step
+    auto referenceEnd = juce::jmin(newest, static_cast<juce::int64>(std::floor(otherPosition)));
+    const float* reference = midLine.get() + ((referenceEnd - correlationLength + 1) & delayLineMask);
+    auto best = latestStart;
+    auto bestScore = -std::numeric_limits<float>::max();
+
+    for (auto candidate = latestStart; candidate >= latestStart - searchRange; candidate -= searchStep)
+    {
+        // normalised cross-correlation, so loud passages don't win just for being loud
+        const float* samples = midLine.get() + ((candidate - correlationLength + 1) & delayLineMask);
+        auto correlation = DSPKernels::dotProduct(samples, reference, correlationLength);
+        auto energy = DSPKernels::dotProduct(samples, samples, correlationLength);
+        auto score = correlation / std::sqrt(energy + 1.0e-9f);
+        if (score > bestScore)
+        {
+            bestScore = score;
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+float PitchShifter::readDelay(const float* line, double position) const
+{
+    auto index = static_cast<juce::int64>(std::floor(position));
+    auto frac = static_cast<float>(position - static_cast<double>(index));
+    auto a = line[index & delayLineMask];
+    auto b = line[(index + 1) & delayLineMask];
+    return a + (b - a) * frac;
+}
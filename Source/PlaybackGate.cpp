@@ -0,0 +1,89 @@
+/*
+  ==============================================================================
+
+    PlaybackGate.cpp
+    Created: 21 Oct 2026 2:37:51pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#include "PlaybackGate.h"
+
+PlaybackGate::PlaybackGate(juce::AudioTransportSource& _transport)
+    : transport(_transport)
+{
+}
+
+PlaybackGate::~PlaybackGate()
+{
+}
+
+void PlaybackGate::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    transport.prepareToPlay(samplesPerBlockExpected, sampleRate);
+}
+
+void PlaybackGate::releaseResources()
+{
+    transport.releaseResources();
+}
+
+void PlaybackGate::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    if (open.load() && !transport.isPlaying())
+    {
+        // the transport stops itself once it reads past the end of the track
+        open.store(false);
+        fadeRemaining = 0;
+    }
+    if (open.load())
+    {
+        transport.getNextAudioBlock(bufferToFill);
+        return;
+    }
+    if (fadeRemaining > 0)
+    {
+        // read only as far as the fade goes, so the playhead stops where the sound did
+        auto numToFade = juce::jmin(fadeRemaining, bufferToFill.numSamples);
+        transport.getNextAudioBlock(juce::AudioSourceChannelInfo(bufferToFill.buffer, bufferToFill.startSample, numToFade));
+        auto startGain = static_cast<float>(fadeRemaining) / fadeSamples;
+        fadeRemaining -= numToFade;
+        auto endGain = static_cast<float>(fadeRemaining) / fadeSamples;
+        for (int chan = 0; chan < bufferToFill.buffer->getNumChannels(); ++chan)
+        {
+            bufferToFill.buffer->applyGainRamp(chan, bufferToFill.startSample, numToFade, startGain, endGain);
+        }
+        if (numToFade < bufferToFill.numSamples)
+        {
+            bufferToFill.buffer->clear(bufferToFill.startSample + numToFade, bufferToFill.numSamples - numToFade);
+        }
+        return;
+    }
+    bufferToFill.clearActiveBufferRegion();
+    readEmptyBlock(*bufferToFill.buffer);
+}
+
+void PlaybackGate::setOpen(bool shouldBeOpen)
+{
+    if (shouldBeOpen)
+    {
+        // a start part way through a fade picks up where it is, at full level
+        fadeRemaining = 0;
+        open.store(true);
+    }
+    else if (open.load()) {
+        fadeRemaining = fadeSamples;
+        open.store(false);
+    }
+}
+
+bool PlaybackGate::isOpen() const
+{
+    return open.load();
+}
+
+void PlaybackGate::readEmptyBlock(juce::AudioBuffer<float>& buffer)
+{
+    transport.getNextAudioBlock(juce::AudioSourceChannelInfo(&buffer, 0, 0));
+}
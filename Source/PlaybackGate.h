@@ -0,0 +1,58 @@
+/*
+  ==============================================================================
+
+    PlaybackGate.h
+    Created: 21 Oct 2026 2:37:51pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+/** starts and stops a deck on the audio thread, sitting between the transport and the rest of the chain.
+ juce::AudioTransportSource::stop waits for the audio thread to see the stop, so the audio thread can't call it without stalling itself,
+ and both start and stop broadcast a change message. the transport is left running whenever a track is loaded, and this decides whether it is read:
+ opening takes effect on the next sample, closing fades out over fadeSamples and then feeds the chain silence without moving the playhead */
+class PlaybackGate : public juce::AudioSource
+{
+public:
+    /** inputs: reference to the transport to gate, not owned - must outlive this (juce::AudioTransportSource&)
+     constructor */
+    PlaybackGate(juce::AudioTransportSource& _transport);
+    /**
+     destructor */
+    ~PlaybackGate() override;
+    /** inputs: expected number of samples per audio block [buffer] (int); sample rate the output will be used at (double)
+     From https://docs.juce.com/master/classAudioSource.html "Tells the source to prepare for playing." */
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    /**
+     From https://docs.juce.com/master/classAudioSource.html "Allows the source to release anything it no longer needs after playback has stopped." */
+    void releaseResources() override;
+    /** inputs: reference to the target channel buffer (juce::AudioSourceChannelInfo&)
+     From https://docs.juce.com/master/classAudioSource.html "Called repeatedly to fetch subsequent blocks of audio data."
+     reads the transport while open or fading out, silence otherwise */
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    /** inputs: flag stating whether the deck should play (bool) | opens the gate from the next sample read, or starts the fade out - audio thread only */
+    void setOpen(bool shouldBeOpen);
+    /** outputs: flag stating whether the deck is playing (bool) | safe from any thread */
+    bool isOpen() const;
+    /** inputs: any buffer, left untouched (juce::AudioBuffer<float>&)
+     reads an empty block through the transport, so the loop engine behind it takes its queued loop and cue actions at the stopped playhead
+     without the playhead moving on - audio thread only */
+    void readEmptyBlock(juce::AudioBuffer<float>& buffer);
+
+    /** length of the fade when the gate closes, the same as the transport's own - in samples */
+    static constexpr int fadeSamples = 256;
+
+private:
+    juce::AudioTransportSource& transport;
+    std::atomic<bool> open{false};
+    /** samples of the fade out still to play - audio thread only */
+    int fadeRemaining = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PlaybackGate)
+};
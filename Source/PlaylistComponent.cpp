@@ -11,23 +11,189 @@
 #include <JuceHeader.h>
 #include "PlaylistComponent.h"
 #include "Track.h"
+#include "SeekIndexedReader.h"
 #include <string>
 #include <iomanip>
 #include <iostream>
 #include <fstream>
 #include <stdlib.h>
 
+// the library stores as many cues as a deck can play
+static_assert(Track::numHotCues == DJAudioPlayer::numHotCues, "tracks and decks must agree on the number of hot cues");
+
+namespace
+{
+    /** inputs: file to open (const juce::File&); reference to the audio format manager (juce::AudioFormatManager&); seek index of the file, may be nullptr (const std::shared_ptr<const SeekIndex>&) | outputs: reader for the file, nullptr if it can't be read (std::unique_ptr<juce::AudioFormatReader>)
+     for analyses that read only parts of a track - with an index each part is reached without decoding everything before it */
+    std::unique_ptr<juce::AudioFormatReader> createSeekingReader(const juce::File& file,
+                                                                 juce::AudioFormatManager& formatManager,
+                                                                 const std::shared_ptr<const SeekIndex>& index)
+    {
+        if (index != nullptr)
+        {
+            if (auto* format = formatManager.findFormatForFileExtension(file.getFileExtension()))
+            {
+                if (auto reader = SeekIndexedReader::create(file, *format, index))
+                {
+                    return reader;
+                }
+            }
+        }
+        return std::unique_ptr<juce::AudioFormatReader>(formatManager.createReaderFor(file));
+    }
+
+    /** samples decoded at a time when a whole track is read - in samples */
+    constexpr int decodeBlockSize = 1 << 16;
+}
+
+//==============================================================================
+class PlaylistComponent::TrackAnalysisJob : public JobScheduler::Job
+{
+public:
+    /** inputs: pointer to the playlist to hand the results back to (PlaylistComponent*); URL of the track to analyse (juce::URL); reference to the audio format manager to decode it with (juce::AudioFormatManager&); analyses to run, AnalysisFlags combined (int); seek index of the file, may be nullptr (std::shared_ptr<const SeekIndex>)
+     constructor - must be called on the message thread */
+    TrackAnalysisJob(PlaylistComponent* _playlist, juce::URL _url, juce::AudioFormatManager& _formatManager, int _analyses, std::shared_ptr<const SeekIndex> _seekIndex)
+        : JobScheduler::Job("Track analysis", _analyses != 0),
+        playlist(_playlist),
+        url(_url),
+        formatManager(_formatManager),
+        analyses(_analyses),
+        seekIndex(_seekIndex)
+    {
+    }
+
+    /** outputs: whether the job is done (JobScheduler::Job::JobStatus)
+     indexes the track if it has no seek index yet, runs every analysis asked for, then posts the results back to the message thread in one go */
+    JobStatus runJob() override
+    {
+        auto file = url.getLocalFile();
+        // the one place a track's index is built - it is shared by the analyses below and handed to every deck the track is loaded into.
+        // building one only reads frame headers
+        auto index = seekIndex;
+        if (index == nullptr && SeekIndex::canIndex(file))
+        {
+            index = SeekIndex::build(file, [this] { return shouldExit(); });
+        }
+        juce::String key;
+        SilenceAnalyser::Result silence;
+        // analyses that ran to the end, found something or not - one stopped part way, or that couldn't read the file, is tried again next launch
+        int completed = 0;
+        if ((analyses & (keyAnalysis | silenceAnalysis)) != 0)
+        {
+            // only excerpts and the ends are decoded, so read through the seek index
+            if (auto reader = createSeekingReader(file, formatManager, index))
+            {
+                if ((analyses & silenceAnalysis) != 0)
+                {
+                    silence = SilenceAnalyser::analyse(*reader, [this] { return shouldExit(); });
+                }
+                if ((analyses & keyAnalysis) != 0)
+                {
+                    key = KeyAnalyser::toCamelot(KeyAnalyser::analyse(*reader, [this] { return shouldExit(); }));
+                }
+                if (!shouldExit())
+                {
+                    completed |= analyses & (keyAnalysis | silenceAnalysis);
+                }
+            }
+        }
+        TempoAnalyser::Result tempo;
+        LoudnessAnalyser::Result loudness;
+        if ((analyses & (tempoAnalysis | loudnessAnalysis)) != 0 && decodeWholeTrack(file, tempo, loudness))
+        {
+            completed |= analyses & (tempoAnalysis | loudnessAnalysis);
+        }
+
+        juce::Component::SafePointer<PlaylistComponent> target = playlist;
+        auto trackURL = url;
+        auto newIndex = index != seekIndex ? index : nullptr;
+        juce::MessageManager::callAsync([target, trackURL, silence, key, tempo, loudness, newIndex, completed]
+        {
+            if (target != nullptr)
+            {
+                target->analysesInProgress.removeFirstMatchingValue(trackURL);
+                target->markAnalysed(trackURL, completed);
+                if (silence.valid)
+                {
+                    target->setCuePoints(trackURL, silence.cueIn, silence.cueOut);
+                }
+                if (key.isNotEmpty())
+                {
+                    target->setKey(trackURL, key);
+                }
+                if (tempo.valid)
+                {
+                    target->setBeatGrid(trackURL, tempo.bpm, tempo.firstBeat);
+                }
+                if (loudness.valid)
+                {
+                    target->setLoudness(trackURL, loudness.loudness, loudness.truePeak);
+                }
+                if (newIndex != nullptr)
+                {
+                    target->setSeekIndex(trackURL, newIndex);
+                }
+            }
+        });
+        return jobHasFinished;
+    }
+
+private:
+    /** inputs: file to decode (const juce::File&); tempo found (TempoAnalyser::Result&); loudness measured (LoudnessAnalyser::Result&) - each left invalid if not asked for, if the file can't be read or if the job is stopped | outputs: false if the file couldn't be read or the job was stopped (bool)
+     decodes the whole track once, handing every block to each analysis that needs all of it */
+    bool decodeWholeTrack(const juce::File& file, TempoAnalyser::Result& tempo, LoudnessAnalyser::Result& loudness)
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+        if (reader == nullptr || reader->sampleRate <= 0.0)
+        {
+            return false;
+        }
+        auto findTempo = (analyses & tempoAnalysis) != 0;
+        auto measureLoudness = (analyses & loudnessAnalysis) != 0;
+        TempoAnalyser tempoAnalyser(reader->sampleRate, findTempo ? reader->lengthInSamples : 0);
+        LoudnessAnalyser loudnessAnalyser(reader->sampleRate, measureLoudness ? reader->lengthInSamples : 0);
+        // a mono track comes out of both sides of a deck, so it is read into both channels and measured as it is heard
+        juce::AudioBuffer<float> block(juce::jmax(2, static_cast<int>(reader->numChannels)), decodeBlockSize);
+        for (juce::int64 position = 0; position < reader->lengthInSamples; position += decodeBlockSize)
+        {
+            if (shouldExit())
+            {
+                return false;
+            }
+            auto numToRead = static_cast<int>(juce::jmin(static_cast<juce::int64>(decodeBlockSize), reader->lengthInSamples - position));
+            reader->read(&block, 0, numToRead, position, true, true);
+            if (findTempo)
+            {
+                tempoAnalyser.process(block, numToRead);
+            }
+            if (measureLoudness)
+            {
+                loudnessAnalyser.process(block, numToRead);
+            }
+        }
+        if (findTempo)
+        {
+            tempo = tempoAnalyser.getResult();
+        }
+        if (measureLoudness)
+        {
+            loudness = loudnessAnalyser.getResult();
+        }
+        return true;
+    }
+
+    juce::Component::SafePointer<PlaylistComponent> playlist;
+    juce::URL url;
+    juce::AudioFormatManager& formatManager;
+    int analyses;
+    std::shared_ptr<const SeekIndex> seekIndex;
+};
+
 //==============================================================================
-PlaylistComponent::PlaylistComponent(DJAudioPlayer* _player1,
-                                     DJAudioPlayer* _player2,
-                                     WaveformDisplay* _waveFormDisplay1,
-                                     WaveformDisplay* _waveFormDisplay2,
+PlaylistComponent::PlaylistComponent(DeckEngine& _deckEngine,
                                      juce::AudioFormatManager& _formatManager
                                      )
-    : player1(_player1),
-    player2(_player2),
-    waveformDisplay1(_waveFormDisplay1),
-    waveformDisplay2(_waveFormDisplay2),
+    : deckEngine(_deckEngine),
     formatManager(_formatManager)
 {
     // In your constructor, you should add any child components, and
@@ -35,15 +201,15 @@ PlaylistComponent::PlaylistComponent(DJAudioPlayer* _player1,
     
     // setup playlist column headers
     tableComponent.getHeader().addColumn("Track title",
-                                         1, 490);
+                                         1, 580);
     tableComponent.getHeader().addColumn("Length",
                                          2, 100);
+    tableComponent.getHeader().addColumn("Key",
+                                         5, 50);
     tableComponent.getHeader().addColumn("",
                                          3, 90);
     tableComponent.getHeader().addColumn("",
-                                         4, 90);
-    tableComponent.getHeader().addColumn("",
-                                         5, 30);
+                                         4, 30);
     // setup architecture and basic styles for playlist
     tableComponent.setModel(this);
     tableComponent.setColour(juce::TableListBox::backgroundColourId, juce::Colours::black);
@@ -51,6 +217,8 @@ PlaylistComponent::PlaylistComponent(DJAudioPlayer* _player1,
     tableComponent.getHeader().setColour(juce::TableHeaderComponent::textColourId, juce::Colours::whitesmoke);
     
     addAndMakeVisible(tableComponent);
+    // jobs for the tracks on screen go ahead of the rest of the library
+    tableComponent.getVerticalScrollBar().addListener(this);
     
     // setup architecture and basic styles for playlist meta controls (load and search)
     addAndMakeVisible(loadButton);
@@ -71,6 +239,9 @@ PlaylistComponent::~PlaylistComponent()
     // save playlist to file in home dir before finishing so that app
     // can reload tracks on next startup.
     saveToFile();
+    tableComponent.getVerticalScrollBar().removeListener(this);
+    // abandon any indexing and analysis still going
+    deckEngine.getJobScheduler().removeJobs(this, true, 2000);
 }
 
 void PlaylistComponent::paint (juce::Graphics& g)
@@ -119,6 +290,7 @@ void PlaylistComponent::resized()
         // UI instructions for filling playlist, unerneath
         tableComponent.setBounds(0, rowH * 1, getWidth(), 0);
     }
+    updateAnalysisPriorities();
 }
 
 int PlaylistComponent::getNumRows()
@@ -178,6 +350,18 @@ void PlaylistComponent::paintCell(juce::Graphics& g,
                    false
                    );
     }
+    if (columnId == 5)
+    {
+        // draw track key, blank until it has been analysed
+        g.drawText(searchResults[rowNumber]->getKey(),
+                   2,
+                   0,
+                   width - 4,
+                   height,
+                   juce::Justification::centredLeft,
+                   false
+                   );
+    }
 }
 
 juce::Component* PlaylistComponent::refreshComponentForCell(int rowNumber,
@@ -191,30 +375,20 @@ juce::Component* PlaylistComponent::refreshComponentForCell(int rowNumber,
     {
         if (columnId == 3)
         {
-            // setup 'load to left-hand deck' button,
+            // setup 'load to deck' button, which offers a menu of decks,
             // attach listener and ID, and return to be refreshed
-            juce::TextButton* btn = new juce::TextButton{"load left"};
-            juce::String id{std::to_string(rowNumber * 3 + 0)};
+            juce::TextButton* btn = new juce::TextButton{"load to..."};
+            juce::String id{std::to_string(rowNumber * 2 + 0)};
             btn->setComponentID(id);
             btn->addListener(this);
             existingComponentToUpdate = btn;
         }
         if (columnId == 4)
-        {
-            // setup 'load to right-hand deck' button,
-            // attach listener and ID, and return to be refreshed
-            juce::TextButton* btn = new juce::TextButton{"load right"};
-            juce::String id{std::to_string(rowNumber * 3 + 1)};
-            btn->setComponentID(id);
-            btn->addListener(this);
-            existingComponentToUpdate = btn;
-        }
-        if (columnId == 5)
         {
             // setup 'delete track' button,
             // attach listener and ID, and return to be refreshed
             juce::TextButton* btn = new juce::TextButton{"x"};
-            juce::String id{std::to_string(rowNumber * 3 + 2)};
+            juce::String id{std::to_string(rowNumber * 2 + 1)};
             btn->setComponentID(id);
             btn->addListener(this);
             existingComponentToUpdate = btn;
@@ -241,31 +415,193 @@ void PlaylistComponent::buttonClicked(juce::Button* button)
     }
     // if not load button, get button ID
     int id = std::stoi(button->getComponentID().toStdString());
-    if (id % 3 == 0)
+    int trackNum = static_cast<int>(id / 2);
+    if (id % 2 == 0)
     {
-        // if button is 'load to left-hand deck' button, do so
-        juce::URL url = searchResults[static_cast<int>(id / 3)]->getURL();
-        juce::String title = searchResults[static_cast<int>(id / 3)]->getName();
-        player1->loadURL(url);
-        waveformDisplay1->loadURL(url);
-        waveformDisplay1->setCurrentTrackTitle(title);
+        // if button is 'load to deck' button, let the user pick a deck from those running
+        juce::PopupMenu menu;
+        for (int deck = 0; deck < deckEngine.getNumDecks(); ++deck)
+        {
+            menu.addItem(deck + 1, "Deck " + juce::String(deck + 1));
+        }
+        juce::Component::SafePointer<PlaylistComponent> safeThis(this);
+        menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(button),
+                           [safeThis, trackNum](int result)
+        {
+            // result is 0 if the menu was dismissed
+            if (safeThis != nullptr && result > 0)
+            {
+                safeThis->loadToDeck(trackNum, result - 1);
+            }
+        });
     }
-    if (id % 3 == 1)
+    if (id % 2 == 1)
     {
-        // if button is 'load to right-hand deck' button, do so
-        juce::URL url = searchResults[static_cast<int>(id / 3)]->getURL();
-        juce::String title = searchResults[static_cast<int>(id / 3)]->getName();
-        player2->loadURL(url);
-        waveformDisplay2->loadURL(url);
-        waveformDisplay2->setCurrentTrackTitle(title);
+        // if button is 'delete track' button, do so
+        removeTrack(trackNum);
     }
-    if (id % 3 == 2)
+}
+
+void PlaylistComponent::loadToDeck(int trackNum, int deck)
+{
+    if (trackNum < 0 || trackNum >= static_cast<int>(searchResults.size()))
     {
-        // if button is 'delete track' button, do so
-        removeTrack(static_cast<int>(id / 3));
+        DBG("PlaylistComponent::loadToDeck there is no track " << trackNum);
+        return;
+    }
+    juce::URL url = searchResults[trackNum]->getURL();
+    juce::String title = searchResults[trackNum]->getName();
+    auto seekIndex = searchResults[trackNum]->getSeekIndex();
+    DJAudioPlayer::TrackSettings settings;
+    settings.hotCues = searchResults[trackNum]->getHotCues();
+    settings.bpm = searchResults[trackNum]->getBPM();
+    settings.firstBeat = searchResults[trackNum]->getFirstBeat();
+    settings.loudness = searchResults[trackNum]->getLoudness();
+    settings.truePeak = searchResults[trackNum]->getTruePeak();
+    settings.cueIn = searchResults[trackNum]->getCueIn();
+    bool sent = deckEngine.loadToDeck(deck, url, [title](bool loaded)
+    {
+        if (!loaded)
+        {
+            DBG("PlaylistComponent::loadToDeck could not load " << title);
+        }
+    }, seekIndex, settings);
+    if (sent && seekIndex == nullptr)
+    {
+        // first time this track has been played - index it so every load from now on seeks quickly, unless its analysis is already doing so
+        analyseTrack(url, 0, nullptr);
+    }
+    if (sent && onTrackLoaded)
+    {
+        // let the deck's display know what is coming
+        onTrackLoaded(deck, url, title);
+    }
+}
+
+void PlaylistComponent::scrollBarMoved(juce::ScrollBar* scrollBarThatHasMoved, double newRangeStart)
+{
+    updateAnalysisPriorities();
+}
+
+void PlaylistComponent::addAnalysisJob(JobScheduler::Job* job, juce::URL url)
+{
+    auto tag = url.toString(false);
+    auto priority = getVisibleTracks().contains(tag) ? JobScheduler::Priority::visible : JobScheduler::Priority::bulk;
+    deckEngine.getJobScheduler().addJob(job, priority, this, tag);
+}
+
+juce::StringArray PlaylistComponent::getVisibleTracks()
+{
+    juce::StringArray visible;
+    auto rowHeight = tableComponent.getRowHeight();
+    auto* viewport = tableComponent.getViewport();
+    if (viewport == nullptr || rowHeight <= 0 || tableComponent.getHeight() <= 0)
+    {
+        return visible;
+    }
+    // the rows scrolled into view, as the table would paint them
+    auto first = viewport->getViewPositionY() / rowHeight;
+    auto last = (viewport->getViewPositionY() + viewport->getViewHeight()) / rowHeight;
+    for (int row = juce::jmax(0, first); row <= last && row < static_cast<int>(searchResults.size()); ++row)
+    {
+        visible.add(searchResults[static_cast<size_t>(row)]->getURL().toString(false));
+    }
+    return visible;
+}
+
+void PlaylistComponent::updateAnalysisPriorities()
+{
+    deckEngine.getJobScheduler().setVisibleJobs(this, getVisibleTracks());
+}
+
+void PlaylistComponent::setSeekIndex(juce::URL url, std::shared_ptr<const SeekIndex> index)
+{
+    updateTrack(url, [&](Track& track) { track.setSeekIndex(index); });
+}
+
+void PlaylistComponent::analyseTrack(juce::URL url, int analyses, std::shared_ptr<const SeekIndex> seekIndex)
+{
+    if (!url.isLocalFile() || analysesInProgress.contains(url))
+    {
+        return;
+    }
+    if (analyses == 0 && (seekIndex != nullptr || !SeekIndex::canIndex(url.getLocalFile())))
+    {
+        // nothing to find out, and no index to build
+        return;
+    }
+    analysesInProgress.add(url);
+    addAnalysisJob(new TrackAnalysisJob(this, url, formatManager, analyses, seekIndex), url);
+}
+
+void PlaylistComponent::updateTrack(juce::URL url, const std::function<void(Track&)>& change)
+{
+    for (auto& track : tracks)
+    {
+        if (track->getURL() == url)
+        {
+            change(*track);
+        }
+    }
+    for (auto& track : searchResults)
+    {
+        if (track->getURL() == url)
+        {
+            change(*track);
+        }
+    }
+}
+
+void PlaylistComponent::setBeatGrid(juce::URL url, double bpm, double firstBeat)
+{
+    updateTrack(url, [&](Track& track) { track.setBeatGrid(bpm, firstBeat); });
+    // a deck may have been given the track before it was analysed
+    for (int deck = 0; deck < deckEngine.getNumDecks(); ++deck)
+    {
+        auto* player = deckEngine.getDeck(deck);
+        if (player != nullptr && player->getLoadedURL() == url)
+        {
+            player->setBPM(bpm);
+            player->setFirstBeat(firstBeat);
+        }
+    }
+}
+
+void PlaylistComponent::setLoudness(juce::URL url, double loudness, double truePeak)
+{
+    updateTrack(url, [&](Track& track) { track.setLoudness(loudness, truePeak); });
+    // a deck may have been given the track before it was measured
+    for (int deck = 0; deck < deckEngine.getNumDecks(); ++deck)
+    {
+        auto* player = deckEngine.getDeck(deck);
+        if (player != nullptr && player->getLoadedURL() == url)
+        {
+            player->setLoudness(loudness, truePeak);
+        }
     }
 }
 
+void PlaylistComponent::setCuePoints(juce::URL url, double cueIn, double cueOut)
+{
+    updateTrack(url, [&](Track& track) { track.setCuePoints(cueIn, cueOut); });
+}
+
+void PlaylistComponent::setKey(juce::URL url, juce::String camelotKey)
+{
+    updateTrack(url, [&](Track& track) { track.setKey(camelotKey); });
+    tableComponent.repaint();
+}
+
+void PlaylistComponent::markAnalysed(juce::URL url, int analyses)
+{
+    updateTrack(url, [&](Track& track) { track.markAnalysed(analyses); });
+}
+
+void PlaylistComponent::setHotCue(juce::URL url, int index, double seconds)
+{
+    updateTrack(url, [&](Track& track) { track.setHotCue(index, seconds); });
+}
+
 bool PlaylistComponent::isInterestedInFileDrag(const juce::StringArray &files)
 {
     // accepts all files
@@ -325,6 +661,8 @@ void PlaylistComponent::addTrack(juce::File result, juce::String length)
         
         std::unique_ptr<Track> displayedTrack(new Track(result.getFileNameWithoutExtension(), getLengthInMinutesAndSeconds(url), url));
         searchResults.push_back(std::move(displayedTrack));
+        // find where its sound starts and ends, its key, tempo and loudness while it waits to be played
+        analyseTrack(url, silenceAnalysis | keyAnalysis | tempoAnalysis | loudnessAnalysis, nullptr);
     }
     else {
         // if length is passed in it means it is a track coming from
@@ -380,7 +718,7 @@ void PlaylistComponent::textEditorTextChanged(juce::TextEditor & textEditor)
                 {
                     if (tracks[r]->isResultOfSearch())
                     {
-                        std::unique_ptr<Track> track(new Track(tracks[r]->getName(), tracks[r]->getLength(), tracks[r]->getURL()));
+                        std::unique_ptr<Track> track(new Track(*tracks[r]));
                         searchResults.push_back(std::move(track));
                     }
                 }
@@ -415,6 +753,7 @@ void PlaylistComponent::textEditorTextChanged(juce::TextEditor & textEditor)
         repaint();
         tableComponent.repaint();
     }
+    updateAnalysisPriorities();
 }
 
 void PlaylistComponent::loadFromFile()
@@ -448,6 +787,58 @@ void PlaylistComponent::loadFromFile()
             auto lengthStr = element["length"].get<std::string>();
             juce::String length = lengthStr;
             addTrack(loadTrack, length);
+            // bring back the seek index, if one was built in an earlier session
+            if (element.contains("seekIndex"))
+            {
+                juce::String savedIndex = element["seekIndex"].get<std::string>();
+                if (auto index = SeekIndex::fromString(savedIndex))
+                {
+                    setSeekIndex(juce::URL{loadTrack}, index);
+                }
+            }
+            // and the hot cues
+            if (element.contains("hotCues"))
+            {
+                auto savedCues = element["hotCues"];
+                for (int cue = 0; cue < static_cast<int>(savedCues.size()) && cue < Track::numHotCues; ++cue)
+                {
+                    setHotCue(juce::URL{loadTrack}, cue, savedCues[static_cast<size_t>(cue)].get<double>());
+                }
+            }
+            // and the cue points, key, beat grid and loudness - whatever the track was never analysed for is found in one job
+            int missing = 0;
+            if (element.contains("cueOut"))
+            {
+                setCuePoints(juce::URL{loadTrack}, element.value("cueIn", 0.0), element["cueOut"].get<double>());
+            }
+            else {
+                missing |= silenceAnalysis;
+            }
+            if (element.contains("key"))
+            {
+                setKey(juce::URL{loadTrack}, juce::String(element["key"].get<std::string>()));
+            }
+            else {
+                missing |= keyAnalysis;
+            }
+            if (element.contains("bpm") && element["bpm"].get<double>() > 0.0)
+            {
+                setBeatGrid(juce::URL{loadTrack}, element["bpm"].get<double>(), element.value("firstBeat", 0.0));
+            }
+            else {
+                missing |= tempoAnalysis;
+            }
+            if (element.contains("loudness"))
+            {
+                setLoudness(juce::URL{loadTrack}, element["loudness"].get<double>(), element.value("truePeak", 0.0));
+            }
+            else {
+                missing |= loudnessAnalysis;
+            }
+            // an analysis that ran in an earlier session and found nothing is not run again
+            missing &= ~element.value("analysed", 0);
+            markAnalysed(juce::URL{loadTrack}, allAnalyses & ~missing);
+            analyseTrack(juce::URL{loadTrack}, missing, tracks.back()->getSeekIndex());
         }
     }
     // END adapted code
@@ -464,6 +855,33 @@ void PlaylistComponent::saveToFile()
         // storing to state save file
         j[t]["name"] = tracks[t]->getName().toStdString();
         j[t]["length"] = tracks[t]->getLength().toStdString();
+        if (auto index = tracks[t]->getSeekIndex())
+        {
+            j[t]["seekIndex"] = index->toString().toStdString();
+        }
+        auto hotCues = tracks[t]->getHotCues();
+        j[t]["hotCues"] = std::vector<double>(hotCues.begin(), hotCues.end());
+        if (tracks[t]->getCueOut() > 0.0)
+        {
+            j[t]["cueIn"] = tracks[t]->getCueIn();
+            j[t]["cueOut"] = tracks[t]->getCueOut();
+        }
+        if (tracks[t]->getKey().isNotEmpty())
+        {
+            j[t]["key"] = tracks[t]->getKey().toStdString();
+        }
+        if (tracks[t]->getBPM() > 0.0)
+        {
+            j[t]["bpm"] = tracks[t]->getBPM();
+            j[t]["firstBeat"] = tracks[t]->getFirstBeat();
+        }
+        if (tracks[t]->getLoudness() < 0.0)
+        {
+            j[t]["loudness"] = tracks[t]->getLoudness();
+            j[t]["truePeak"] = tracks[t]->getTruePeak();
+        }
+        // which analyses have run, so those that found nothing aren't run again - AnalysisFlags combined
+        j[t]["analysed"] = tracks[t]->getAnalysed();
         std::string url = tracks[t]->getURL().toString(false).toStdString();
         // code adapted from https://stackoverflow.com/a/20412841
         // convert url style paths to system style paths
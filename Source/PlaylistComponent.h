@@ -13,9 +13,12 @@
 #include <JuceHeader.h>
 #include <vector>
 #include <string>
-#include "DJAudioPlayer.h"
-#include "WaveformDisplay.h"
+#include "DeckEngine.h"
 #include "Track.h"
+#include "TempoAnalyser.h"
+#include "KeyAnalyser.h"
+#include "LoudnessAnalyser.h"
+#include "SilenceAnalyser.h"
 #include <iostream>
 #include <fstream>
 #include "json.hpp"
@@ -29,15 +32,13 @@ class PlaylistComponent  :  public juce::Component,
                             public juce::TableListBoxModel,
                             public juce::Button::Listener,
                             public juce::FileDragAndDropTarget,
-                            public juce::TextEditor::Listener
+                            public juce::TextEditor::Listener,
+                            public juce::ScrollBar::Listener
 {
 public:
-    /** inputs: pointer to left hand audio player (DJAudioPlayer*); pointer to right hand audio player (DJAudioPlayer*); pointer to left hand wave form display (WaveFormDisplay*); pointer to right hand wave form display (WaveFormDisplay*); reference to audio format manager (juce::AudioFormatManager&)
+    /** inputs: reference to the deck engine tracks are loaded into (DeckEngine&); reference to audio format manager (juce::AudioFormatManager&)
      constructor */
-    PlaylistComponent(DJAudioPlayer* player1,
-                      DJAudioPlayer* player2,
-                      WaveformDisplay* waveFormDisplay1,
-                      WaveformDisplay* waveFormDisplay2,
+    PlaylistComponent(DeckEngine& deckEngine,
                       juce::AudioFormatManager& formatManager
                       );
     /**
@@ -103,10 +104,22 @@ public:
     /** inputs: number of track to be removed (int)
      remove a track from the playlist when given the track's number in the playlist */
     void removeTrack(int trackNum);
+    /** inputs: number of the track in the displayed playlist (int); index of the deck to load it into, from 0 (int)
+     load a track from the playlist into any deck */
+    void loadToDeck(int trackNum, int deck);
+    /** inputs: URL of the track (juce::URL); index of the cue, from 0 (int); position of the cue, -1 to clear it - in seconds (double)
+     stores a hot cue set on a deck with every copy of the track, in the library and in the search results */
+    void setHotCue(juce::URL url, int index, double seconds);
+    /** called on the message thread whenever a track is sent to a deck, with the deck index, the track's URL and its title */
+    std::function<void(int, juce::URL, juce::String)> onTrackLoaded;
     /** inputs: reference to text editor component registering change (juce::TextEditor&)
      from https://docs.juce.com/master/classTextEditor_1_1Listener.html#a17ec33c8bc4e83799f0edbfc559c761c
      "Called when the user changes the text in some way." */
     void textEditorTextChanged(juce::TextEditor & textEditor) override;
+    /** inputs: pointer to the scroll bar that moved (juce::ScrollBar*); new position of the scroll bar (double)
+     from https://docs.juce.com/master/classScrollBar_1_1Listener.html
+     "Called when a ScrollBar is moved." */
+    void scrollBarMoved(juce::ScrollBar* scrollBarThatHasMoved, double newRangeStart) override;
     /**
      load tracks that were in playlist on last quit, if any */
     void loadFromFile();
@@ -115,15 +128,57 @@ public:
     void saveToFile();
     
 private:
+    /** worker job that builds a track's seek index and runs every analysis it needs, decoding it once */
+    class TrackAnalysisJob;
+
+    /** analyses a TrackAnalysisJob can run, combined as flags */
+    enum AnalysisFlags
+    {
+        tempoAnalysis = 1,
+        keyAnalysis = 2,
+        loudnessAnalysis = 4,
+        silenceAnalysis = 8,
+        allAnalyses = tempoAnalysis | keyAnalysis | loudnessAnalysis | silenceAnalysis
+    };
+
+    /** inputs: job to run (JobScheduler::Job*); URL of the track the job works on (juce::URL)
+     queues an indexing or analysis job, ahead of the rest of the library if the track is on screen */
+    void addAnalysisJob(JobScheduler::Job* job, juce::URL url);
+    /** outputs: URLs of the tracks in the rows scrolled into view (juce::StringArray) */
+    juce::StringArray getVisibleTracks();
+    /**
+     moves the jobs for the tracks now on screen ahead of the rest, after scrolling, searching or resizing */
+    void updateAnalysisPriorities();
+    /** inputs: URL of the track (juce::URL); seek index of the track's file (std::shared_ptr<const SeekIndex>)
+     gives the index to every copy of the track, in the library and in the search results */
+    void setSeekIndex(juce::URL url, std::shared_ptr<const SeekIndex> index);
+    /** inputs: URL of the track to analyse (juce::URL); analyses to run, AnalysisFlags combined (int); seek index of the file, may be nullptr (std::shared_ptr<const SeekIndex>)
+     runs the analyses in one background job, building the track's seek index first if it has none, unless the track is already being analysed */
+    void analyseTrack(juce::URL url, int analyses, std::shared_ptr<const SeekIndex> seekIndex);
+    /** inputs: URL of the track (juce::URL); change to make (const std::function<void(Track&)>&)
+     makes the change to every copy of the track, in the library and in the search results */
+    void updateTrack(juce::URL url, const std::function<void(Track&)>& change);
+    /** inputs: URL of the track (juce::URL); tempo - in beats per minute (double); first downbeat - in seconds (double)
+     gives the beat grid to every copy of the track, in the library and in the search results, and to any deck playing it */
+    void setBeatGrid(juce::URL url, double bpm, double firstBeat);
+    /** inputs: URL of the track (juce::URL); first audible moment - in seconds (double); end of the last audible moment - in seconds (double)
+     gives the cue points to every copy of the track, in the library and in the search results */
+    void setCuePoints(juce::URL url, double cueIn, double cueOut);
+    /** inputs: URL of the track (juce::URL); musical key in Camelot notation (juce::String)
+     gives the key to every copy of the track, in the library and in the search results, and shows it */
+    void setKey(juce::URL url, juce::String camelotKey);
+    /** inputs: URL of the track (juce::URL); integrated loudness - in LUFS (double); true peak - in dBTP (double)
+     gives the loudness to every copy of the track, in the library and in the search results, and to any deck playing it so it is trimmed */
+    void setLoudness(juce::URL url, double loudness, double truePeak);
+    /** inputs: URL of the track (juce::URL); analyses that ran to the end, AnalysisFlags combined (int)
+     marks them done on every copy of the track, in the library and in the search results, whatever they found */
+    void markAnalysed(juce::URL url, int analyses);
     
     juce::TableListBox tableComponent;
     std::vector<std::unique_ptr<Track>> tracks;
     std::vector<std::unique_ptr<Track>> searchResults;
     
-    DJAudioPlayer* player1;
-    DJAudioPlayer* player2;
-    WaveformDisplay* waveformDisplay1;
-    WaveformDisplay* waveformDisplay2;
+    DeckEngine& deckEngine;
     
     juce::TextButton loadButton{"LOAD"};
     juce::TextEditor searchField{"Search"};
@@ -136,5 +191,7 @@ private:
     
     juce::File loadFile;
     
+    juce::Array<juce::URL> analysesInProgress;
+    
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PlaylistComponent)
 };
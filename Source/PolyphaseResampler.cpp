@@ -0,0 +1,320 @@
+/*
+  ==============================================================================
+
+    PolyphaseResampler.cpp
+    Created: 18 Oct 2026 4:05:12pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#include "PolyphaseResampler.h"
+#include "DSPKernels.h"
+#include <vector>
+
+namespace
+{
+    /** fractional positions the sinc is tabulated at between two input samples */
+    constexpr int numPhases = 256;
+    /** cutoff bands - band b is for ratios up to 2^(b/4), so band 16 covers up to 16x */
+    constexpr int numBands = 17;
+    /** half the length of the longest filter, kept as history behind the kernel so tiers can be switched mid-stream */
+    constexpr int maxHalfTaps = 32;
+
+    /** inputs: value (double) | outputs: zeroth order modified Bessel function of the first kind (double) - used for the Kaiser window */
+    double besselI0(double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+        for (int k = 1; k < 50 && term > sum * 1.0e-12; ++k)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    }
+}
+
+//==============================================================================
+struct PolyphaseResampler::FilterBank
+{
+    int numTaps;
+    /** one table per cutoff band, each numPhases + 1 rows of numTaps coefficients */
+    std::vector<std::vector<float>> bands;
+
+    /** inputs: number of input samples consumed per output sample (double) | outputs: the band whose cutoff keeps that ratio free of aliasing (int) */
+    static int getBandForRatio(double ratio)
+    {
+        if (ratio <= 1.0)
+        {
+            return 0;
+        }
+        return juce::jmin(numBands - 1, static_cast<int>(std::ceil(4.0 * std::log2(ratio))));
+    }
+
+    /** inputs: quality tier (Quality)
+     constructor - tabulates a Kaiser-windowed sinc for every band and phase */
+    FilterBank(Quality quality)
+        : numTaps(getNumTaps(quality))
+    {
+        // passband width and window shape for each tier, wider and steeper as the filter gets longer
+        double rolloff = 0.80, beta = 5.0;
+        switch (quality)
+        {
+            case Quality::low:      rolloff = 0.80; beta = 5.0;  break;
+            case Quality::medium:   rolloff = 0.88; beta = 6.5;  break;
+            case Quality::high:     rolloff = 0.92; beta = 8.0;  break;
+            case Quality::best:     rolloff = 0.95; beta = 10.0; break;
+        }
+        const int half = numTaps / 2;
+        const double windowNorm = besselI0(beta);
+
+        bands.resize(numBands);
+        for (int band = 0; band < numBands; ++band)
+        {
+            // cutoff in cycles per input sample, lowered as the ratio rises so nothing folds back
+            double bandRatio = std::pow(2.0, band / 4.0);
+            double cutoff = 0.5 * rolloff / bandRatio;
+            auto& table = bands[static_cast<size_t>(band)];
+            table.resize(static_cast<size_t>((numPhases + 1) * numTaps));
+
+            for (int phase = 0; phase <= numPhases; ++phase)
+            {
+                double frac = static_cast<double>(phase) / numPhases;
+                float* row = table.data() + phase * numTaps;
+                double sum = 0.0;
+                for (int tap = 0; tap < numTaps; ++tap)
+                {
+                    // distance of this tap from the output position, in input samples
+                    double t = (tap - (half - 1)) - frac;
+                    double x = 2.0 * cutoff * t;
+                    double sinc = std::abs(x) < 1.0e-9 ? 1.0 : std::sin(juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+                    double u = t / half;
+                    double window = std::abs(u) >= 1.0 ? 0.0 : besselI0(beta * std::sqrt(1.0 - u * u)) / windowNorm;
+                    double value = 2.0 * cutoff * sinc * window;
+                    row[tap] = static_cast<float>(value);
+                    sum += value;
+                }
+                // unity gain at DC for every phase, so there is no ripple as the position moves
+                for (int tap = 0; tap < numTaps; ++tap)
+                {
+                    row[tap] = static_cast<float>(row[tap] / sum);
+                }
+            }
+        }
+    }
+};
+
+//==============================================================================
+PolyphaseResampler::PolyphaseResampler(juce::AudioSource* inputSource,
+                                       bool deleteInputWhenDeleted,
+                                       int _numChannels)
+    : input(inputSource, deleteInputWhenDeleted),
+    numChannels(_numChannels)
+{
+    jassert(input != nullptr);
+    // build the default tier's tables now, never on the audio thread
+    filterBank = &getFilterBank(quality.load());
+}
+
+PolyphaseResampler::~PolyphaseResampler()
+{
+}
+
+void PolyphaseResampler::setResamplingRatio(double samplesInPerOutputSample)
+{
+    // setter for resampling ratio
+    jassert(samplesInPerOutputSample >= 0.0);
+    ratio = juce::jlimit(0.0, maxRatio, samplesInPerOutputSample);
+}
+
+double PolyphaseResampler::getResamplingRatio() const
+{
+    return ratio.load();
+}
+
+void PolyphaseResampler::setQuality(Quality newQuality)
+{
+    // history always holds enough samples for the longest filter, so switching is seamless
+    filterBank = &getFilterBank(newQuality);
+    quality = newQuality;
+}
+
+PolyphaseResampler::Quality PolyphaseResampler::getQuality() const
+{
+    return quality.load();
+}
+
+void PolyphaseResampler::flushBuffers()
+{
+    // picked up by the audio thread at the start of the next block
+    flushRequested = true;
+}
+
+void PolyphaseResampler::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    maxBlockSize = juce::jmax(1, samplesPerBlockExpected);
+    // room for the longest filter either side of the largest block at the highest ratio
+    auto historySize = maxHalfTaps * 2 + static_cast<int>(std::ceil(maxBlockSize * maxRatio)) + 8;
+    history.setSize(numChannels, historySize);
+    kernel.allocate(static_cast<size_t>(maxHalfTaps * 2), true);
+    history.clear();
+    numValid = maxHalfTaps;
+    position = maxHalfTaps;
+    flushRequested = false;
+    lastRatio = ratio.load();
+    input->prepareToPlay(samplesPerBlockExpected, sampleRate);
+}
+
+void PolyphaseResampler::releaseResources()
+{
+    input->releaseResources();
+    history.setSize(numChannels, 0);
+}
+
+void PolyphaseResampler::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    if (history.getNumSamples() == 0)
+    {
+        // not prepared yet
+        bufferToFill.clearActiveBufferRegion();
+        return;
+    }
+    auto startTicks = juce::Time::getHighResolutionTicks();
+
+    if (flushRequested.exchange(false))
+    {
+        // start again from silence, as if just prepared
+        history.clear();
+        numValid = maxHalfTaps;
+        position = maxHalfTaps;
+    }
+
+    const auto& bank = *filterBank.load();
+    const int numTaps = bank.numTaps;
+    const int half = numTaps / 2;
+    const int channelsToFill = juce::jmin(numChannels, bufferToFill.buffer->getNumChannels());
+    // ramp from the last ratio to the new one across this block so speed changes are smooth
+    auto targetRatio = ratio.load();
+    auto ratioStep = (targetRatio - lastRatio) / bufferToFill.numSamples;
+    auto currentRatio = lastRatio;
+
+    int done = 0;
+    while (done < bufferToFill.numSamples)
+    {
+        // work in chunks no bigger than the history was sized for
+        int numThisTime = juce::jmin(bufferToFill.numSamples - done, maxBlockSize);
+        auto fastestRatio = juce::jmax(currentRatio, currentRatio + ratioStep * numThisTime);
+
+        // pull in enough input for the kernel to reach the end of the chunk
+        auto lastIndexNeeded = static_cast<int>(position + fastestRatio * numThisTime) + half + 1;
+        if (lastIndexNeeded >= numValid)
+        {
+            auto numToRead = juce::jmin(lastIndexNeeded + 1 - numValid, history.getNumSamples() - numValid);
+            juce::AudioSourceChannelInfo readInfo(&history, numValid, numToRead);
+            input->getNextAudioBlock(readInfo);
+            numValid += numToRead;
+        }
+
+        // pick the cutoff band for the fastest speed in this chunk
+        const float* coefficients = bank.bands[static_cast<size_t>(FilterBank::getBandForRatio(fastestRatio))].data();
+        for (int i = 0; i < numThisTime; ++i)
+        {
+            // find the two tabulated phases either side of the position and blend between them
+            auto index = static_cast<int>(position);
+            auto phase = (position - index) * numPhases;
+            auto phaseIndex = static_cast<int>(phase);
+            const float* row = coefficients + phaseIndex * numTaps;
+            DSPKernels::interpolate(kernel.get(), row, row + numTaps, static_cast<float>(phase - phaseIndex), numTaps);
+
+            // run every channel through the same kernel
+            auto firstTap = index - half + 1;
+            for (int chan = 0; chan < channelsToFill; ++chan)
+            {
+                bufferToFill.buffer->getWritePointer(chan)[bufferToFill.startSample + done + i]
+                    = DSPKernels::dotProduct(history.getReadPointer(chan, firstTap), kernel.get(), numTaps);
+            }
+            currentRatio += ratioStep;
+            position += currentRatio;
+        }
+        compactHistory();
+        done += numThisTime;
+    }
+
+    // silence any output channels we don't have input for
+    for (int chan = channelsToFill; chan < bufferToFill.buffer->getNumChannels(); ++chan)
+    {
+        bufferToFill.buffer->clear(chan, bufferToFill.startSample, bufferToFill.numSamples);
+    }
+    lastRatio = targetRatio;
+
+    // keep a smoothed measure of what each output sample costs
+    auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    auto thisBlock = elapsed * 1.0e9 / bufferToFill.numSamples;
+    nanosPerSample = nanosPerSample.load() * 0.95 + thisBlock * 0.05;
+}
+
+int PolyphaseResampler::getNumTaps(Quality quality)
+{
+    switch (quality)
+    {
+        case Quality::low:      return 8;
+        case Quality::medium:   return 16;
+        case Quality::high:     return 32;
+        case Quality::best:     return 64;
+    }
+    return 16;
+}
+
+int PolyphaseResampler::getMultiplyAddsPerSample(Quality quality, int numChannels)
+{
+    // one pass to blend the two nearest phases, then one dot product per channel
+    return getNumTaps(quality) * (1 + numChannels);
+}
+
+double PolyphaseResampler::getMeasuredNanosPerSample() const
+{
+    return nanosPerSample.load();
+}
+
+double PolyphaseResampler::getBufferedInputSamples() const
+{
+    return numValid - position;
+}
+
+double PolyphaseResampler::getLatencySamples() const
+{
+    // the kernel is centred on the position, so the input buffered past it is the whole delay
+    return getBufferedInputSamples() / juce::jmax(1.0e-6, lastRatio);
+}
+
+const PolyphaseResampler::FilterBank& PolyphaseResampler::getFilterBank(Quality quality)
+{
+    // tables are shared by every deck and built once per tier
+    static juce::CriticalSection lock;
+    static std::unique_ptr<FilterBank> banks[4];
+    const juce::ScopedLock sl(lock);
+    auto& bank = banks[static_cast<int>(quality)];
+    if (bank == nullptr)
+    {
+        bank.reset(new FilterBank(quality));
+    }
+    return *bank;
+}
+
+void PolyphaseResampler::compactHistory()
+{
+    // keep only what the longest filter could still reach behind the current position
+    auto keepFrom = juce::jmin(static_cast<int>(position) - maxHalfTaps + 1, numValid);
+    if (keepFrom <= 0)
+    {
+        return;
+    }
+    for (int chan = 0; chan < history.getNumChannels(); ++chan)
+    {
+        auto* samples = history.getWritePointer(chan);
+        std::memmove(samples, samples + keepFrom, sizeof(float) * static_cast<size_t>(numValid - keepFrom));
+    }
+    numValid -= keepFrom;
+    position -= keepFrom;
+}
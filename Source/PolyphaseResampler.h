@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+
+    PolyphaseResampler.h
+    Created: 18 Oct 2026 4:05:12pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+/** windowed-sinc varispeed resampler, a drop-in replacement for juce::ResamplingAudioSource.
+ the sinc is precomputed as a table of 256 fractional phases (interpolated between) for a ladder of cutoff bands,
+ so speeding up never aliases and nothing is calculated per sample but the filter itself.
+
+ cost of each quality tier, in multiply-adds per output sample for a stereo deck
+ (kernel interpolation plus one dot product per channel, see getMultiplyAddsPerSample):
+     low     8 taps    24
+     medium  16 taps   48
+     high    32 taps   96
+     best    64 taps   192
+ the measured cost on the machine running the app is available from getMeasuredNanosPerSample */
+class PolyphaseResampler : public juce::AudioSource
+{
+public:
+    /** trade-off between stop-band rejection and CPU */
+    enum class Quality
+    {
+        low,
+        medium,
+        high,
+        best
+    };
+
+    /** inputs: pointer to the source to be resampled (juce::AudioSource*); flag stating if the source should be deleted along with this object (bool); number of channels to process (int)
+     constructor */
+    PolyphaseResampler(juce::AudioSource* inputSource,
+                       bool deleteInputWhenDeleted,
+                       int numChannels = 2);
+    /**
+     destructor */
+    ~PolyphaseResampler() override;
+    /** inputs: number of input samples consumed per output sample, with 1.0 being no change (double)
+     safe to call from any thread, the change is ramped over the next block */
+    void setResamplingRatio(double samplesInPerOutputSample);
+    /** outputs: number of input samples consumed per output sample (double) */
+    double getResamplingRatio() const;
+    /** inputs: quality tier to use (Quality) | builds the tier's tables if this is the first time it is used, so call from the message thread */
+    void setQuality(Quality newQuality);
+    /** outputs: quality tier in use (Quality) */
+    Quality getQuality() const;
+    /** clears out the filter history, so the next block starts fresh */
+    void flushBuffers();
+    /** inputs: expected number of samples per audio block [buffer] (int); sample rate the output will be used at (double)
+     From https://docs.juce.com/master/classAudioSource.html "Tells the source to prepare for playing." */
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    /**
+     From https://docs.juce.com/master/classAudioSource.html "Allows the source to release anything it no longer needs after playback has stopped." */
+    void releaseResources() override;
+    /** inputs: reference to the target channel buffer (juce::AudioSourceChannelInfo&)
+     From https://docs.juce.com/master/classAudioSource.html "Called repeatedly to fetch subsequent blocks of audio data." */
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    /** inputs: quality tier (Quality) | outputs: length of the filter in input samples (int) */
+    static int getNumTaps(Quality quality);
+    /** inputs: quality tier (Quality); number of channels (int) | outputs: multiply-adds needed per output sample (int) */
+    static int getMultiplyAddsPerSample(Quality quality, int numChannels);
+    /** outputs: average time spent per output sample over recent blocks - in nanoseconds (double) */
+    double getMeasuredNanosPerSample() const;
+    /** outputs: input pulled from the source but not yet played, to the fraction of a sample - in input samples (double)
+     the source's read position less this is the input position of the next output sample - audio thread only */
+    double getBufferedInputSamples() const;
+    /** outputs: delay from a sample going in to it coming out - the half of the filter ahead of its centre plus whatever else is buffered - in output samples (double)
+     audio thread only */
+    double getLatencySamples() const;
+
+    /** largest ratio supported, enough for 4x scratching of a 192kHz file on a 44.1kHz device */
+    static constexpr double maxRatio = 18.0;
+
+private:
+    struct FilterBank;
+    /** inputs: quality tier (Quality) | outputs: the tier's tables, built on first use (const FilterBank&) */
+    static const FilterBank& getFilterBank(Quality quality);
+    /** drops history the kernel has moved past, keeping enough behind it for the longest filter */
+    void compactHistory();
+
+    juce::OptionalScopedPointer<juce::AudioSource> input;
+    int numChannels;
+    std::atomic<const FilterBank*> filterBank{nullptr};
+    std::atomic<Quality> quality{Quality::medium};
+    std::atomic<double> ratio{1.0};
+    std::atomic<bool> flushRequested{false};
+    std::atomic<double> nanosPerSample{0.0};
+    double lastRatio = 1.0;
+
+    juce::AudioBuffer<float> history;
+    int numValid = 0;
+    double position = 0.0;
+    int maxBlockSize = 0;
+    juce::HeapBlock<float> kernel;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PolyphaseResampler)
+};
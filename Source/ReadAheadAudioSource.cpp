@@ -0,0 +1,250 @@
+/*
+  ==============================================================================
+
+    ReadAheadAudioSource.cpp
+    Created: 18 Oct 2026 9:02:14am
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#include "ReadAheadAudioSource.h"
+
+ReadAheadAudioSource::ReadAheadAudioSource(juce::PositionableAudioSource* _source,
+                                           bool deleteSourceWhenDeleted,
+                                           juce::TimeSliceThread& _backgroundThread,
+                                           int _numberOfSamplesToBuffer,
+                                           int _numberOfChannels)
+    : source(_source, deleteSourceWhenDeleted),
+    backgroundThread(_backgroundThread),
+    numberOfSamplesToBuffer(juce::jmax(1024, _numberOfSamplesToBuffer)),
+    numberOfChannels(_numberOfChannels)
+{
+    jassert(source != nullptr);
+}
+
+ReadAheadAudioSource::~ReadAheadAudioSource()
+{
+    // make sure the background thread is finished with us before going away
+    releaseResources();
+}
+
+void ReadAheadAudioSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    // buffer must always hold at least a couple of blocks
+    auto bufferSizeNeeded = juce::jmax(samplesPerBlockExpected * 2, numberOfSamplesToBuffer);
+    // stop the background thread from reading while the buffer is resized
+    backgroundThread.removeTimeSliceClient(this);
+    buffer.setSize(numberOfChannels, bufferSizeNeeded);
+    buffer.clear();
+    // prepare the underlying source and mark the buffer as empty
+    source->prepareToPlay(samplesPerBlockExpected, sampleRate);
+    bufferValidStart = 0;
+    bufferValidEnd = 0;
+    isPrepared = true;
+    // hand over to the background thread and ask it to start filling straight away
+    backgroundThread.addTimeSliceClient(this);
+    backgroundThread.moveToFrontOfQueue(this);
+}
+
+void ReadAheadAudioSource::releaseResources()
+{
+    // wait for the background thread to let go of us before freeing anything
+    backgroundThread.removeTimeSliceClient(this);
+    if (isPrepared)
+    {
+        buffer.setSize(numberOfChannels, 0);
+        source->releaseResources();
+        isPrepared = false;
+    }
+}
+
+void ReadAheadAudioSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    juce::int64 start, end;
+    {
+        // take a consistent snapshot of the buffered range
+        const juce::SpinLock::ScopedLockType sl(bufferRangeLock);
+        start = bufferValidStart.load();
+        end = bufferValidEnd.load();
+    }
+    auto pos = nextPlayPos.load();
+    // work out which part of the requested block is already sitting in the buffer
+    auto validStart = static_cast<int>(juce::jlimit(start, end, pos) - pos);
+    auto validEnd = static_cast<int>(juce::jlimit(start, end, pos + bufferToFill.numSamples) - pos);
+
+    // the last block of a track is only partly inside it, so count only the samples the track still has
+    auto samplesExpected = juce::jmin(static_cast<juce::int64>(bufferToFill.numSamples), getTotalLength() - pos);
+    if (samplesExpected > 0 && validEnd - validStart < samplesExpected)
+    {
+        // background thread has fallen behind the playhead - record the dropout
+        ++numUnderruns;
+    }
+
+    if (validStart == validEnd)
+    {
+        // nothing usable is buffered, output silence rather than block on the disk
+        bufferToFill.clearActiveBufferRegion();
+    }
+    else {
+        // silence any part of the block that is not buffered
+        if (validStart > 0)
+        {
+            bufferToFill.buffer->clear(bufferToFill.startSample, validStart);
+        }
+        if (validEnd < bufferToFill.numSamples)
+        {
+            bufferToFill.buffer->clear(bufferToFill.startSample + validEnd,
+                                       bufferToFill.numSamples - validEnd);
+        }
+        // copy the buffered section across, wrapping around the end of the circular buffer
+        for (int chan = juce::jmin(numberOfChannels, bufferToFill.buffer->getNumChannels()); --chan >= 0;)
+        {
+            auto startBufferIndex = static_cast<int>((validStart + pos) % buffer.getNumSamples());
+            auto endBufferIndex = static_cast<int>((validEnd + pos) % buffer.getNumSamples());
+
+            if (startBufferIndex < endBufferIndex)
+            {
+                bufferToFill.buffer->copyFrom(chan, bufferToFill.startSample + validStart,
+                                              buffer, chan, startBufferIndex,
+                                              validEnd - validStart);
+            }
+            else {
+                auto initialSize = buffer.getNumSamples() - startBufferIndex;
+                bufferToFill.buffer->copyFrom(chan, bufferToFill.startSample + validStart,
+                                              buffer, chan, startBufferIndex,
+                                              initialSize);
+                bufferToFill.buffer->copyFrom(chan, bufferToFill.startSample + validStart + initialSize,
+                                              buffer, chan, 0,
+                                              (validEnd - validStart) - initialSize);
+            }
+        }
+    }
+    // advance the playhead, only if nobody moved it while we were copying
+    nextPlayPos.compare_exchange_strong(pos, pos + bufferToFill.numSamples);
+}
+
+void ReadAheadAudioSource::setNextReadPosition(juce::int64 newPosition)
+{
+    // move the playhead and wake the background thread in case it now needs to refill
+    nextPlayPos = newPosition;
+    backgroundThread.notify();
+}
+
+juce::int64 ReadAheadAudioSource::getNextReadPosition() const
+{
+    return nextPlayPos.load();
+}
+
+juce::int64 ReadAheadAudioSource::getTotalLength() const
+{
+    return source->getTotalLength();
+}
+
+bool ReadAheadAudioSource::isLooping() const
+{
+    return source->isLooping();
+}
+
+int ReadAheadAudioSource::getNumUnderruns() const
+{
+    return numUnderruns.load();
+}
+
+float ReadAheadAudioSource::getFillLevel() const
+{
+    // measure how much is buffered from the playhead onwards
+    if (buffer.getNumSamples() == 0)
+    {
+        return 0.0f;
+    }
+    auto pos = nextPlayPos.load();
+    auto end = bufferValidEnd.load();
+    if (pos < bufferValidStart.load() || pos >= end)
+    {
+        return 0.0f;
+    }
+    return juce::jlimit(0.0f, 1.0f, static_cast<float>(end - pos) / buffer.getNumSamples());
+}
+
+int ReadAheadAudioSource::useTimeSlice()
+{
+    // come straight back while there is still reading to do, otherwise rest a while
+    return readNextBufferChunk() ? 1 : 100;
+}
+
+bool ReadAheadAudioSource::readNextBufferChunk()
+{
+    // largest amount read in one go, so a seek never waits behind a full buffer refill
+    const int maxChunkSize = 2048;
+    juce::int64 newBVS, newBVE, sectionToReadStart, sectionToReadEnd;
+    {
+        const juce::SpinLock::ScopedLockType sl(bufferRangeLock);
+        // aim to hold everything from the playhead to a full buffer ahead of it
+        newBVS = juce::jmax(static_cast<juce::int64>(0), nextPlayPos.load());
+        newBVE = juce::jmin(newBVS + buffer.getNumSamples() - 4, getTotalLength());
+        sectionToReadStart = 0;
+        sectionToReadEnd = 0;
+
+        if (newBVS < bufferValidStart || newBVS >= bufferValidEnd)
+        {
+            // playhead has jumped outside the buffer - start again from the playhead
+            newBVE = juce::jmin(newBVE, newBVS + maxChunkSize);
+            sectionToReadStart = newBVS;
+            sectionToReadEnd = newBVE;
+            bufferValidStart = 0;
+            bufferValidEnd = 0;
+        }
+        else if (newBVS - bufferValidStart > 512 || newBVE - bufferValidEnd > 512)
+        {
+            // playhead has moved on - append the next chunk after what is already buffered
+            newBVE = juce::jmin(newBVE, bufferValidEnd + maxChunkSize);
+            sectionToReadStart = bufferValidEnd;
+            sectionToReadEnd = newBVE;
+            bufferValidStart = newBVS;
+            bufferValidEnd = juce::jmin(bufferValidEnd.load(), newBVE);
+        }
+    }
+
+    if (sectionToReadStart >= sectionToReadEnd)
+    {
+        return false;
+    }
+
+    // read the section into the circular buffer, splitting it if it wraps around
+    auto bufferIndexStart = static_cast<int>(sectionToReadStart % buffer.getNumSamples());
+    auto bufferIndexEnd = static_cast<int>(sectionToReadEnd % buffer.getNumSamples());
+
+    if (bufferIndexStart < bufferIndexEnd)
+    {
+        readBufferSection(sectionToReadStart,
+                          static_cast<int>(sectionToReadEnd - sectionToReadStart),
+                          bufferIndexStart);
+    }
+    else {
+        auto initialSize = buffer.getNumSamples() - bufferIndexStart;
+        readBufferSection(sectionToReadStart, initialSize, bufferIndexStart);
+        readBufferSection(sectionToReadStart + initialSize,
+                          static_cast<int>(sectionToReadEnd - sectionToReadStart) - initialSize,
+                          0);
+    }
+
+    {
+        // publish the newly read section to the audio thread
+        const juce::SpinLock::ScopedLockType sl(bufferRangeLock);
+        bufferValidStart = newBVS;
+        bufferValidEnd = newBVE;
+    }
+    return true;
+}
+
+void ReadAheadAudioSource::readBufferSection(juce::int64 start, int length, int bufferOffset)
+{
+    // only seek the source when it is not already where we need it
+    if (source->getNextReadPosition() != start)
+    {
+        source->setNextReadPosition(start);
+    }
+    juce::AudioSourceChannelInfo info(&buffer, bufferOffset, length);
+    source->getNextAudioBlock(info);
+}
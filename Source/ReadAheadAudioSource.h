@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    ReadAheadAudioSource.h
+    Created: 18 Oct 2026 9:02:14am
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+/** keeps a few seconds of a track read ahead of the playhead on a background thread, so the audio thread only ever copies from RAM.
+ modelled on juce::BufferingAudioSource, which would do the reading just as well, but its getNextAudioBlock waits on the same lock
+ the reading thread holds while it works out what to read next, and it cannot say when or how often it ran dry.
+ here the audio thread takes a snapshot of the buffered range under a spin lock held for a couple of loads, and every underrun is counted */
+class ReadAheadAudioSource :    public juce::PositionableAudioSource,
+                                private juce::TimeSliceClient
+{
+public:
+    /** inputs: pointer to the source to be read ahead of (juce::PositionableAudioSource*); flag stating if the source should be deleted along with this object (bool); reference to the thread that will do the reading (juce::TimeSliceThread&); number of samples to keep buffered ahead of the playhead (int); number of channels to buffer (int)
+     constructor */
+    ReadAheadAudioSource(juce::PositionableAudioSource* source,
+                         bool deleteSourceWhenDeleted,
+                         juce::TimeSliceThread& backgroundThread,
+                         int numberOfSamplesToBuffer,
+                         int numberOfChannels = 2);
+    /**
+     destructor */
+    ~ReadAheadAudioSource() override;
+    /** inputs: expected number of samples per audio block [buffer] (int); sample rate the output will be used at (double)
+     From https://docs.juce.com/master/classAudioSource.html "Tells the source to prepare for playing."
+     allocates the read-ahead buffer and registers with the background thread */
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    /**
+     From https://docs.juce.com/master/classAudioSource.html "Allows the source to release anything it no longer needs after playback has stopped."
+     unregisters from the background thread and frees the read-ahead buffer */
+    void releaseResources() override;
+    /** inputs: reference to the target channel buffer (juce::AudioSourceChannelInfo&)
+     From https://docs.juce.com/master/classAudioSource.html "Called repeatedly to fetch subsequent blocks of audio data."
+     copies already-buffered audio into the target buffer without touching the disk */
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    /** inputs: absolute position to read from next - in samples (juce::int64) | moves the playhead, background thread refills from there if it is not already buffered */
+    void setNextReadPosition(juce::int64 newPosition) override;
+    /** outputs: absolute position that will be read from next - in samples (juce::int64) */
+    juce::int64 getNextReadPosition() const override;
+    /** outputs: total length of the source - in samples (juce::int64) */
+    juce::int64 getTotalLength() const override;
+    /** outputs: flag stating whether the source is looping (bool) */
+    bool isLooping() const override;
+    /** outputs: number of blocks that could not be filled from the buffer since loading (int)
+     each one is an audible dropout */
+    int getNumUnderruns() const;
+    /** outputs: how far ahead of the playhead the buffer is filled - with 0 being empty and 1 being full (float) */
+    float getFillLevel() const;
+
+private:
+    /** outputs: milliseconds to wait before being called again (int)
+     From https://docs.juce.com/master/classTimeSliceClient.html "Called back by a TimeSliceThread."
+     tops up the buffer ahead of the playhead */
+    int useTimeSlice() override;
+    /** outputs: flag stating if anything was read (bool) | reads the next chunk from the source into the buffer */
+    bool readNextBufferChunk();
+    /** inputs: position in the source to read from (juce::int64); number of samples to read (int); position in the buffer to write to (int) | reads one contiguous section from the source into the buffer */
+    void readBufferSection(juce::int64 start, int length, int bufferOffset);
+
+    juce::OptionalScopedPointer<juce::PositionableAudioSource> source;
+    juce::TimeSliceThread& backgroundThread;
+    int numberOfSamplesToBuffer;
+    int numberOfChannels;
+    juce::AudioBuffer<float> buffer;
+    juce::SpinLock bufferRangeLock;
+    std::atomic<juce::int64> bufferValidStart{0};
+    std::atomic<juce::int64> bufferValidEnd{0};
+    std::atomic<juce::int64> nextPlayPos{0};
+    std::atomic<int> numUnderruns{0};
+    bool isPrepared = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ReadAheadAudioSource)
+};
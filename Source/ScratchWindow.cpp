@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+
+    ScratchWindow.cpp
+    Created: 20 Oct 2026 2:37:51pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#include "ScratchWindow.h"
+
+ScratchWindow::ScratchWindow(double sampleRate)
+    : windowLength(static_cast<juce::int64>(windowSeconds * sampleRate)),
+    margin(windowLength / 4)
+{
+    for (auto& window : windows)
+    {
+        window.buffer.setSize(2, static_cast<int>(windowLength));
+    }
+}
+
+ScratchWindow::~ScratchWindow()
+{
+}
+
+bool ScratchWindow::read(juce::AudioBuffer<float>& dest, int destStart, juce::int64 position, int numSamples, bool backwards)
+{
+    // claim the published window - if it changes while claiming, claim the new one instead
+    auto index = published.load();
+    for (;;)
+    {
+        inUse.store(index);
+        auto latest = published.load();
+        if (latest == index)
+        {
+            break;
+        }
+        index = latest;
+    }
+    if (index < 0)
+    {
+        inUse.store(-1);
+        return false;
+    }
+
+    const auto& window = windows[static_cast<size_t>(index)];
+    auto first = backwards ? position - numSamples : position;
+    if (first < window.start || first + numSamples > window.start + window.length)
+    {
+        // not in the window - yet
+        inUse.store(-1);
+        return false;
+    }
+    auto offset = static_cast<int>(first - window.start);
+    for (int chan = 0; chan < dest.getNumChannels(); ++chan)
+    {
+        auto sourceChannel = juce::jmin(chan, window.buffer.getNumChannels() - 1);
+        if (backwards)
+        {
+            // nearest the playhead first
+            const auto* source = window.buffer.getReadPointer(sourceChannel, offset);
+            auto* target = dest.getWritePointer(chan, destStart);
+            for (int i = 0; i < numSamples; ++i)
+            {
+                target[i] = source[numSamples - 1 - i];
+            }
+        }
+        else {
+            dest.copyFrom(chan, destStart, window.buffer, sourceChannel, offset, numSamples);
+        }
+    }
+    inUse.store(-1);
+    return true;
+}
+
+void ScratchWindow::setPlayhead(juce::int64 position)
+{
+    playhead.store(position);
+}
+
+void ScratchWindow::setActive(bool shouldBeActive)
+{
+    active.store(shouldBeActive);
+}
+
+bool ScratchWindow::update(juce::PositionableAudioSource& source)
+{
+    if (!active.load())
+    {
+        return false;
+    }
+    auto position = playhead.load();
+    auto current = published.load();
+    if (current >= 0)
+    {
+        const auto& window = windows[static_cast<size_t>(current)];
+        auto end = window.start + window.length;
+        // still well inside, or up against an end of the track the window can't move past
+        auto roomBehind = position - window.start >= margin || window.start == 0;
+        auto roomAhead = end - position >= margin || end >= source.getTotalLength();
+        if (roomBehind && roomAhead)
+        {
+            return false;
+        }
+    }
+    auto spare = current == 0 ? 1 : 0;
+    if (inUse.load() == spare)
+    {
+        // the audio thread is still reading the window we are about to rebuild - try again next time
+        return false;
+    }
+
+    auto& window = windows[static_cast<size_t>(spare)];
+    auto newStart = juce::jmax(static_cast<juce::int64>(0), position - windowLength / 2);
+    auto newLength = juce::jmin(windowLength, source.getTotalLength() - newStart);
+    if (newLength <= 0)
+    {
+        return false;
+    }
+    auto newEnd = newStart + newLength;
+
+    // keep whatever the current window already holds, and decode only the rest
+    auto overlapStart = newStart;
+    auto overlapEnd = newStart;
+    if (current >= 0)
+    {
+        const auto& old = windows[static_cast<size_t>(current)];
+        overlapStart = juce::jlimit(newStart, newEnd, old.start);
+        overlapEnd = juce::jlimit(overlapStart, newEnd, old.start + old.length);
+        for (int chan = 0; chan < window.buffer.getNumChannels(); ++chan)
+        {
+            window.buffer.copyFrom(chan, static_cast<int>(overlapStart - newStart),
+                                   old.buffer, chan, static_cast<int>(overlapStart - old.start),
+                                   static_cast<int>(overlapEnd - overlapStart));
+        }
+    }
+    if (overlapStart > newStart)
+    {
+        source.setNextReadPosition(newStart);
+        source.getNextAudioBlock(juce::AudioSourceChannelInfo(&window.buffer, 0, static_cast<int>(overlapStart - newStart)));
+    }
+    if (newEnd > overlapEnd)
+    {
+        source.setNextReadPosition(overlapEnd);
+        source.getNextAudioBlock(juce::AudioSourceChannelInfo(&window.buffer, static_cast<int>(overlapEnd - newStart),
+                                                              static_cast<int>(newEnd - overlapEnd)));
+    }
+    window.start = newStart;
+    window.length = newLength;
+    // hand it over - the audio thread picks it up on its next read
+    published.store(spare);
+    return true;
+}
@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    ScratchWindow.h
+    Created: 20 Oct 2026 2:37:51pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+/** a few seconds of decoded audio either side of the playhead, readable in either direction.
+ while a deck plays backwards or scratches, everything it plays comes from here, so however often the direction changes the decoder never has to seek.
+ there are two windows - the audio thread reads the published one while the background thread builds the other around the playhead,
+ reusing whatever overlaps and decoding only the rest, then publishes it in one step */
+class ScratchWindow
+{
+public:
+    /** inputs: sample rate of the track (double)
+     constructor - allocates both windows */
+    ScratchWindow(double sampleRate);
+    /**
+     destructor */
+    ~ScratchWindow();
+    /** inputs: buffer to fill (juce::AudioBuffer<float>&); first sample to fill (int); playhead - in samples of the track (juce::int64); number of samples to fill (int); flag stating whether to read backwards from the playhead (bool) | outputs: false if the window does not hold those samples, in which case the buffer is left alone (bool)
+     forwards fills with the samples from the playhead on, backwards with the samples before the playhead, nearest first - audio thread only */
+    bool read(juce::AudioBuffer<float>& dest, int destStart, juce::int64 position, int numSamples, bool backwards);
+    /** inputs: playhead - in samples of the track (juce::int64) | tells the background thread where to keep the window - audio thread only */
+    void setPlayhead(juce::int64 position);
+    /** inputs: flag stating whether the window should be kept around the playhead (bool) | the window is only built while it is needed */
+    void setActive(bool shouldBeActive);
+    /** inputs: a source for the track, only ever read here (juce::PositionableAudioSource&) | outputs: flag stating whether any work was done (bool)
+     builds a new window around the playhead if it has strayed near the edge of the current one - background thread only */
+    bool update(juce::PositionableAudioSource& source);
+
+    /** length of each window - in seconds */
+    static constexpr double windowSeconds = 8.0;
+
+private:
+    struct Window
+    {
+        juce::AudioBuffer<float> buffer;
+        juce::int64 start = 0;
+        juce::int64 length = 0;
+    };
+
+    std::array<Window, 2> windows;
+    juce::int64 windowLength;
+    /** a new window is built once the playhead gets this close to either edge of the current one */
+    juce::int64 margin;
+    /** window the audio thread reads, -1 until the first is built */
+    std::atomic<int> published{-1};
+    /** window the audio thread is reading right now, -1 when it is not reading, so the background thread never overwrites it */
+    std::atomic<int> inUse{-1};
+    std::atomic<juce::int64> playhead{0};
+    std::atomic<bool> active{false};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ScratchWindow)
+};
@@ -0,0 +1,216 @@
+/*
+  ==============================================================================
+
+    SeekIndex.cpp
+    Created: 19 Oct 2026 7:40:05pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#include "SeekIndex.h"
+#include <cstring>
+
+namespace
+{
+    /** bumped whenever the saved layout changes, so old indexes are rebuilt rather than misread */
+    constexpr int formatVersion = 1;
+    /** MPEG-1 layer III bitrates - in kbit/s, by header index */
+    constexpr int bitrates[16] = { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0 };
+    /** MPEG-1 sample rates - in hz, by header index */
+    constexpr int sampleRates[4] = { 44100, 48000, 32000, 0 };
+
+    /** inputs: pointer to a possible frame header (const juce::uint8*); bytes left in the file from there (size_t); sample rate index every frame must share, -1 for any (int) | outputs: length of the frame in bytes, 0 if there is no valid MPEG-1 layer III header there (int) */
+    int getFrameLength(const juce::uint8* data, size_t bytesLeft, int sampleRateIndex)
+    {
+        if (bytesLeft < 4 || data[0] != 0xff || (data[1] & 0xe0) != 0xe0)
+        {
+            return 0;
+        }
+        auto version = (data[1] >> 3) & 3;
+        auto layer = (data[1] >> 1) & 3;
+        auto bitrateIndex = data[2] >> 4;
+        auto rateIndex = (data[2] >> 2) & 3;
+        auto padding = (data[2] >> 1) & 1;
+        // MPEG-1, layer III, not free format, and the same sample rate as the rest of the file
+        if (version != 3 || layer != 1 || bitrates[bitrateIndex] == 0 || sampleRates[rateIndex] == 0
+            || (sampleRateIndex >= 0 && rateIndex != sampleRateIndex))
+        {
+            return 0;
+        }
+        return 144000 * bitrates[bitrateIndex] / sampleRates[rateIndex] + padding;
+    }
+
+    /** inputs: pointer to a frame (const juce::uint8*); length of the frame in bytes (int) | outputs: flag stating whether the frame is a Xing, Info or VBRI header rather than audio (bool) */
+    bool isVbrHeaderFrame(const juce::uint8* frame, int length)
+    {
+        // the tag sits straight after the side information, which is shorter for mono
+        auto xingOffset = 4 + ((frame[3] >> 6) == 3 ? 17 : 32);
+        auto hasTag = [frame, length](int offset, const char* tag)
+        {
+            return offset + 4 <= length && std::memcmp(frame + offset, tag, 4) == 0;
+        };
+        return hasTag(xingOffset, "Xing") || hasTag(xingOffset, "Info") || hasTag(36, "VBRI");
+    }
+}
+
+std::shared_ptr<const SeekIndex> SeekIndex::build(const juce::File& file, std::function<bool()> shouldExit)
+{
+    // map the file rather than read it - only the headers get touched
+    juce::MemoryMappedFile map(file, juce::MemoryMappedFile::readOnly);
+    auto* data = static_cast<const juce::uint8*>(map.getData());
+    auto size = map.getSize();
+    if (data == nullptr || size < 10)
+    {
+        return nullptr;
+    }
+
+    auto index = std::make_shared<SeekIndex>();
+    index->fileSize = file.getSize();
+    size_t pos = 0;
+    // skip an ID3v2 tag - its size is stored 7 bits to a byte, plus a footer if flagged
+    if (data[0] == 'I' && data[1] == 'D' && data[2] == '3')
+    {
+        pos = 10 + ((static_cast<size_t>(data[6] & 0x7f) << 21) | (static_cast<size_t>(data[7] & 0x7f) << 14)
+                    | (static_cast<size_t>(data[8] & 0x7f) << 7) | static_cast<size_t>(data[9] & 0x7f));
+        if (data[5] & 0x10)
+        {
+            pos += 10;
+        }
+    }
+
+    int sampleRateIndex = -1;
+    bool inSync = false;
+    bool isFirstFrame = true;
+    while (pos + 4 <= size)
+    {
+        if (shouldExit && (index->numFrames & 1023) == 0 && shouldExit())
+        {
+            return nullptr;
+        }
+        auto length = getFrameLength(data + pos, size - pos, sampleRateIndex);
+        if (length == 0 || pos + static_cast<size_t>(length) > size)
+        {
+            if (index->numFrames > 0 && (std::memcmp(data + pos, "TAG", 3) == 0 || size - pos < 4096))
+            {
+                // reached the trailing tags
+                break;
+            }
+            // junk between frames - step forward a byte at a time until in sync again
+            inSync = false;
+            ++pos;
+            continue;
+        }
+        if (!inSync)
+        {
+            // only trust a header found by searching if another one follows it
+            auto rateIndex = (data[pos + 2] >> 2) & 3;
+            auto next = pos + static_cast<size_t>(length);
+            if (next + 4 <= size && getFrameLength(data + next, size - next, rateIndex) == 0)
+            {
+                ++pos;
+                continue;
+            }
+            sampleRateIndex = rateIndex;
+            inSync = true;
+        }
+        if (isFirstFrame)
+        {
+            isFirstFrame = false;
+            if (isVbrHeaderFrame(data + pos, length))
+            {
+                // the decoder skips the VBR header frame, so it must not count as audio
+                pos += static_cast<size_t>(length);
+                continue;
+            }
+        }
+        if (index->numFrames % framesPerEntry == 0)
+        {
+            index->offsets.push_back(static_cast<juce::int64>(pos));
+        }
+        ++index->numFrames;
+        pos += static_cast<size_t>(length);
+    }
+
+    if (index->offsets.empty())
+    {
+        return nullptr;
+    }
+    // entries are saved as 16 bit steps - junk long enough to break that means the file is too damaged to trust
+    for (size_t i = 1; i < index->offsets.size(); ++i)
+    {
+        if (index->offsets[i] - index->offsets[i - 1] > 0xffff)
+        {
+            return nullptr;
+        }
+    }
+    return index;
+}
+
+std::shared_ptr<const SeekIndex> SeekIndex::fromString(const juce::String& saved)
+{
+    juce::MemoryBlock block;
+    if (saved.isEmpty() || !block.fromBase64Encoding(saved))
+    {
+        return nullptr;
+    }
+    juce::MemoryInputStream input(block, false);
+    if (input.readInt() != formatVersion)
+    {
+        return nullptr;
+    }
+    auto index = std::make_shared<SeekIndex>();
+    index->fileSize = input.readInt64();
+    index->numFrames = input.readInt64();
+    auto numEntries = input.readInt();
+    // every entry after the first is stored as the step from the one before it
+    if (numEntries <= 0 || input.getNumBytesRemaining() != 8 + 2 * static_cast<juce::int64>(numEntries - 1))
+    {
+        return nullptr;
+    }
+    index->offsets.reserve(static_cast<size_t>(numEntries));
+    index->offsets.push_back(input.readInt64());
+    for (int i = 1; i < numEntries; ++i)
+    {
+        index->offsets.push_back(index->offsets.back() + static_cast<juce::uint16>(input.readShort()));
+    }
+    return index;
+}
+
+bool SeekIndex::canIndex(const juce::File& file)
+{
+    return file.hasFileExtension("mp3");
+}
+
+juce::String SeekIndex::toString() const
+{
+    juce::MemoryOutputStream output;
+    output.writeInt(formatVersion);
+    output.writeInt64(fileSize);
+    output.writeInt64(numFrames);
+    output.writeInt(static_cast<int>(offsets.size()));
+    output.writeInt64(offsets.front());
+    for (size_t i = 1; i < offsets.size(); ++i)
+    {
+        output.writeShort(static_cast<short>(static_cast<juce::uint16>(offsets[i] - offsets[i - 1])));
+    }
+    return output.getMemoryBlock().toBase64Encoding();
+}
+
+bool SeekIndex::matches(const juce::File& file) const
+{
+    return file.getSize() == fileSize;
+}
+
+SeekIndex::Entry SeekIndex::getEntryBefore(juce::int64 sample) const
+{
+    auto entry = juce::jlimit(static_cast<juce::int64>(0),
+                              static_cast<juce::int64>(offsets.size()) - 1,
+                              sample / (samplesPerFrame * framesPerEntry));
+    return { entry * samplesPerFrame * framesPerEntry, offsets[static_cast<size_t>(entry)] };
+}
+
+juce::int64 SeekIndex::getLengthInSamples() const
+{
+    return numFrames * samplesPerFrame;
+}
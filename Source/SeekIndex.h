@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+
+    SeekIndex.h
+    Created: 19 Oct 2026 7:40:05pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/** where every few frames of an MP3 start in the file, so a seek can go straight to a frame near the target instead of scanning for it.
+ built by reading frame headers only - nothing is decoded - and small enough to be kept in the library alongside the track */
+class SeekIndex
+{
+public:
+    /** samples in every MPEG-1 layer III frame */
+    static constexpr int samplesPerFrame = 1152;
+    /** frames between index entries - a seek decodes at most this many frames plus the preroll */
+    static constexpr int framesPerEntry = 8;
+
+    /** a frame that decoding can start from */
+    struct Entry
+    {
+        /** first sample of the frame */
+        juce::int64 sample = 0;
+        /** position of the frame's header in the file - in bytes */
+        juce::int64 byteOffset = 0;
+    };
+
+    /** inputs: file to index (juce::File&); optional function returning true if building should give up (std::function<bool()>) | outputs: the index, nullptr if the file is not an MPEG-1 layer III file or building was stopped (std::shared_ptr<const SeekIndex>)
+     slow - call from a background thread */
+    static std::shared_ptr<const SeekIndex> build(const juce::File& file, std::function<bool()> shouldExit = nullptr);
+    /** inputs: an index saved with toString (juce::String&) | outputs: the index, nullptr if the string is not a valid index (std::shared_ptr<const SeekIndex>) */
+    static std::shared_ptr<const SeekIndex> fromString(const juce::String& saved);
+    /** inputs: file that might be indexed (juce::File&) | outputs: flag stating whether it is worth building an index for the file (bool) */
+    static bool canIndex(const juce::File& file);
+
+    /** outputs: the index in a compact form for saving with the library (juce::String) */
+    juce::String toString() const;
+    /** inputs: file the index is about to be used with (juce::File&) | outputs: flag stating whether the index still describes it - false if the file has changed size since (bool) */
+    bool matches(const juce::File& file) const;
+    /** inputs: sample to seek to (juce::int64) | outputs: the last entry at or before the sample (Entry) */
+    Entry getEntryBefore(juce::int64 sample) const;
+    /** outputs: exact length of the track, counted from its frames - in samples (juce::int64) */
+    juce::int64 getLengthInSamples() const;
+
+private:
+    juce::int64 fileSize = 0;
+    juce::int64 numFrames = 0;
+    /** byte offset of every framesPerEntry-th frame */
+    std::vector<juce::int64> offsets;
+};
@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+
+    SeekIndexedReader.cpp
+    Created: 19 Oct 2026 8:02:51pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#include "SeekIndexedReader.h"
+
+std::unique_ptr<SeekIndexedReader> SeekIndexedReader::create(const juce::File& file, juce::AudioFormat& format, std::shared_ptr<const SeekIndex> index)
+{
+    if (index == nullptr || !index->matches(file))
+    {
+        // the file has changed since it was indexed
+        return nullptr;
+    }
+    std::unique_ptr<SeekIndexedReader> reader(new SeekIndexedReader(file, format, index));
+    if (reader->decoder == nullptr)
+    {
+        return nullptr;
+    }
+    return reader;
+}
+
+SeekIndexedReader::SeekIndexedReader(const juce::File& _file, juce::AudioFormat& _format, std::shared_ptr<const SeekIndex> _index)
+    : juce::AudioFormatReader(nullptr, _format.getFormatName()),
+    file(_file),
+    format(_format),
+    index(_index)
+{
+    // start at the first frame and take the track's details from the decoder
+    decoder.reset(createDecoderAt(index->getEntryBefore(0).byteOffset));
+    if (decoder != nullptr)
+    {
+        sampleRate = decoder->sampleRate;
+        bitsPerSample = decoder->bitsPerSample;
+        usesFloatingPointData = decoder->usesFloatingPointData;
+        numChannels = decoder->numChannels;
+        metadataValues = decoder->metadataValues;
+        // counted from the frames, rather than estimated from the file size as a decoder does
+        lengthInSamples = index->getLengthInSamples();
+        skipBuffer.setSize(static_cast<int>(numChannels), 4096);
+    }
+}
+
+SeekIndexedReader::~SeekIndexedReader()
+{
+}
+
+bool SeekIndexedReader::readSamples(int** destChannels, int numDestChannels, int startOffsetInDestBuffer,
+                                    juce::int64 startSampleInFile, int numSamples)
+{
+    clearSamplesBeyondAvailableLength(destChannels, numDestChannels, startOffsetInDestBuffer,
+                                      startSampleInFile, numSamples, lengthInSamples);
+    if (numSamples <= 0)
+    {
+        return true;
+    }
+    if (startSampleInFile != nextSample && !seekTo(startSampleInFile))
+    {
+        return false;
+    }
+    // the decoder counts from the frame it was started at
+    auto read = decoder->readSamples(destChannels, numDestChannels, startOffsetInDestBuffer,
+                                     startSampleInFile - decoderStart, numSamples);
+    nextSample = startSampleInFile + numSamples;
+    return read;
+}
+
+juce::AudioFormatReader* SeekIndexedReader::createDecoderAt(juce::int64 byteOffset)
+{
+    auto* stream = new juce::FileInputStream(file);
+    if (stream->failedToOpen())
+    {
+        delete stream;
+        return nullptr;
+    }
+    // the decoder sees a file that starts at the frame, and owns the stream
+    return format.createReaderFor(new juce::SubregionStream(stream, byteOffset, -1, true), true);
+}
+
+bool SeekIndexedReader::seekTo(juce::int64 sample)
+{
+    auto entry = index->getEntryBefore(juce::jmax(static_cast<juce::int64>(0),
+                                                  sample - prerollFrames * SeekIndex::samplesPerFrame));
+    decoder.reset(createDecoderAt(entry.byteOffset));
+    if (decoder == nullptr)
+    {
+        nextSample = -1;
+        return false;
+    }
+    decoderStart = entry.sample;
+    // decode up to the target and throw it away - at most an entry's worth of frames plus the preroll
+    auto** skipChannels = reinterpret_cast<int**>(skipBuffer.getArrayOfWritePointers());
+    for (auto position = decoderStart; position < sample; )
+    {
+        auto numToSkip = static_cast<int>(juce::jmin(static_cast<juce::int64>(skipBuffer.getNumSamples()), sample - position));
+        decoder->readSamples(skipChannels, skipBuffer.getNumChannels(), 0, position - decoderStart, numToSkip);
+        position += numToSkip;
+    }
+    nextSample = sample;
+    return true;
+}
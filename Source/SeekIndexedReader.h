@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    SeekIndexedReader.h
+    Created: 19 Oct 2026 8:02:51pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "SeekIndex.h"
+#include <memory>
+
+/** reads a compressed file, using a seek index to jump to any position.
+ on a seek a fresh decoder is started at the indexed frame just before the target, a couple of frames early so the decoder has settled,
+ and decodes forward to the target - so every seek costs the same few frames wherever it lands. reading straight on costs nothing extra */
+class SeekIndexedReader :   public juce::AudioFormatReader
+{
+public:
+    /** inputs: file to read (juce::File&); format to decode it with (juce::AudioFormat&); index of the file (std::shared_ptr<const SeekIndex>) | outputs: the reader, nullptr if the index does not match the file or the file could not be opened (std::unique_ptr<SeekIndexedReader>) */
+    static std::unique_ptr<SeekIndexedReader> create(const juce::File& file, juce::AudioFormat& format, std::shared_ptr<const SeekIndex> index);
+
+    /**
+     destructor */
+    ~SeekIndexedReader() override;
+    /** inputs: channels to write to (int**); number of channels (int); position in the channels to start writing at (int); position in the file to read from - in samples (juce::int64); number of samples to read (int) | outputs: false if the file could not be read (bool)
+     From https://docs.juce.com/master/classAudioFormatReader.html "Subclasses must implement this method to perform the low-level read operation."
+     carries straight on if the read follows the last one, otherwise seeks through the index first */
+    bool readSamples(int** destChannels, int numDestChannels, int startOffsetInDestBuffer,
+                     juce::int64 startSampleInFile, int numSamples) override;
+
+private:
+    /** inputs: file to read (juce::File&); format to decode it with (juce::AudioFormat&); index of the file (std::shared_ptr<const SeekIndex>)
+     constructor - use create */
+    SeekIndexedReader(const juce::File& file, juce::AudioFormat& format, std::shared_ptr<const SeekIndex> index);
+    /** inputs: first byte of the frame to start decoding from (juce::int64) | outputs: decoder reading the file from that frame, nullptr if it could not be made (juce::AudioFormatReader*) */
+    juce::AudioFormatReader* createDecoderAt(juce::int64 byteOffset);
+    /** inputs: sample to seek to (juce::int64) | outputs: false if the decoder could not be restarted (bool)
+     restarts the decoder at the nearest indexed frame and decodes up to the sample */
+    bool seekTo(juce::int64 sample);
+
+    /** frames decoded and thrown away ahead of the target, so the first frames out of a fresh decoder - missing their bit reservoir - are never heard */
+    static constexpr int prerollFrames = 2;
+
+    juce::File file;
+    juce::AudioFormat& format;
+    std::shared_ptr<const SeekIndex> index;
+    std::unique_ptr<juce::AudioFormatReader> decoder;
+    /** file position of the decoder's first sample */
+    juce::int64 decoderStart = 0;
+    /** file position the decoder will read next */
+    juce::int64 nextSample = 0;
+    /** somewhere to decode the preroll into */
+    juce::AudioBuffer<float> skipBuffer;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SeekIndexedReader)
+};
@@ -0,0 +1,124 @@
+/*
+  ==============================================================================
+
+    SilenceAnalyser.cpp
+    Created: 20 Oct 2026 8:47:52pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#include "SilenceAnalyser.h"
+#include "DSPKernels.h"
+
+SilenceAnalyser::Result SilenceAnalyser::analyse(juce::AudioFormatReader& reader, std::function<bool()> shouldExit)
+{
+    Result result;
+    if (reader.sampleRate <= 0.0 || reader.lengthInSamples <= 0)
+    {
+        return result;
+    }
+    auto windowLength = juce::jmax(1, juce::roundToInt(windowSeconds * reader.sampleRate));
+    // two channels whatever the file has, as a mono track is read into both
+    juce::AudioBuffer<float> chunk(2, windowLength * windowsPerChunk);
+    auto first = findFirstAudible(reader, chunk, windowLength, shouldExit);
+    if (first < 0)
+    {
+        return result;
+    }
+    auto last = findLastAudible(reader, chunk, windowLength, first, shouldExit);
+    if (last < first)
+    {
+        return result;
+    }
+    result.cueIn = first / reader.sampleRate;
+    result.cueOut = (last + 1) / reader.sampleRate;
+    result.valid = true;
+    return result;
+}
+
+juce::int64 SilenceAnalyser::findFirstAudible(juce::AudioFormatReader& reader, juce::AudioBuffer<float>& chunk, int windowLength, const std::function<bool()>& shouldExit)
+{
+    auto threshold = juce::Decibels::decibelsToGain(thresholdDecibels);
+    for (juce::int64 chunkStart = 0; chunkStart < reader.lengthInSamples; chunkStart += chunk.getNumSamples())
+    {
+        if (shouldExit && shouldExit())
+        {
+            return -1;
+        }
+        auto numRead = static_cast<int>(juce::jmin(static_cast<juce::int64>(chunk.getNumSamples()), reader.lengthInSamples - chunkStart));
+        reader.read(&chunk, 0, numRead, chunkStart, true, true);
+        for (int window = 0; window < numRead; window += windowLength)
+        {
+            auto num = juce::jmin(windowLength, numRead - window);
+            if (getPower(chunk, window, num) > threshold * threshold)
+            {
+                // loud enough to hear - start on the first sample in it over the threshold
+                for (int sample = window; sample < window + num; ++sample)
+                {
+                    if (getMagnitude(chunk, sample) > threshold)
+                    {
+                        return chunkStart + sample;
+                    }
+                }
+                return chunkStart + window;
+            }
+        }
+    }
+    return -1;
+}
+
+juce::int64 SilenceAnalyser::findLastAudible(juce::AudioFormatReader& reader, juce::AudioBuffer<float>& chunk, int windowLength, juce::int64 firstAudible, const std::function<bool()>& shouldExit)
+{
+    auto threshold = juce::Decibels::decibelsToGain(thresholdDecibels);
+    for (auto chunkEnd = reader.lengthInSamples; chunkEnd > firstAudible; chunkEnd -= chunk.getNumSamples())
+    {
+        if (shouldExit && shouldExit())
+        {
+            return -1;
+        }
+        auto chunkStart = juce::jmax(firstAudible, chunkEnd - chunk.getNumSamples());
+        auto numRead = static_cast<int>(chunkEnd - chunkStart);
+        reader.read(&chunk, 0, numRead, chunkStart, true, true);
+        // windows counted back from the end of the chunk
+        for (int windowEnd = numRead; windowEnd > 0; windowEnd -= windowLength)
+        {
+            auto window = juce::jmax(0, windowEnd - windowLength);
+            if (getPower(chunk, window, windowEnd - window) > threshold * threshold)
+            {
+                // end on the last sample in it over the threshold
+                for (int sample = windowEnd - 1; sample >= window; --sample)
+                {
+                    if (getMagnitude(chunk, sample) > threshold)
+                    {
+                        return chunkStart + sample;
+                    }
+                }
+                return chunkStart + windowEnd - 1;
+            }
+        }
+    }
+    // nothing louder after the first audible window than the window itself
+    return firstAudible;
+}
+
+float SilenceAnalyser::getPower(const juce::AudioBuffer<float>& chunk, int start, int num)
+{
+    auto total = 0.0f;
+    for (int chan = 0; chan < chunk.getNumChannels(); ++chan)
+    {
+        auto* samples = chunk.getReadPointer(chan, start);
+        total += DSPKernels::dotProduct(samples, samples, num);
+    }
+    return total / static_cast<float>(num * chunk.getNumChannels());
+}
+
+float SilenceAnalyser::getMagnitude(const juce::AudioBuffer<float>& chunk, int sample)
+{
+    auto magnitude = 0.0f;
+    for (int chan = 0; chan < chunk.getNumChannels(); ++chan)
+    {
+        magnitude = juce::jmax(magnitude, std::abs(chunk.getSample(chan, sample)));
+    }
+    return magnitude;
+}
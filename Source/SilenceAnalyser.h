@@ -0,0 +1,53 @@
+/*
+  ==============================================================================
+
+    SilenceAnalyser.h
+    Created: 20 Oct 2026 8:47:52pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+
+/** finds where a track's sound starts and ends, leaving out the silence before and after it.
+ the track is read a second at a time, forwards from the start and backwards from the end, and each chunk is summarised as the power of every 10 ms window in it.
+ both scans stop at the first window loud enough to hear, so only the silence and a second or so either side is ever decoded */
+class SilenceAnalyser
+{
+public:
+    /** what the analysis found */
+    struct Result
+    {
+        /** false if the file could not be read, was silent all the way through or analysis was stopped */
+        bool valid = false;
+        /** first audible sample - in seconds */
+        double cueIn = 0.0;
+        /** just after the last audible sample - in seconds */
+        double cueOut = 0.0;
+    };
+
+    /** inputs: reader for the track, ideally one that seeks quickly (juce::AudioFormatReader&); optional function returning true if analysis should give up (std::function<bool()>) | outputs: the first and last audible moments (Result)
+     reads only the ends of the track - call from a background thread */
+    static Result analyse(juce::AudioFormatReader& reader, std::function<bool()> shouldExit = nullptr);
+
+    /** length of each window summarised - in seconds */
+    static constexpr double windowSeconds = 0.01;
+    /** windows read at a time */
+    static constexpr int windowsPerChunk = 100;
+    /** a window is audible once its RMS level is above this, low enough to keep a quiet fade in but above the noise floor of a vinyl rip - in dBFS */
+    static constexpr float thresholdDecibels = -54.0f;
+
+private:
+    /** inputs: reader for the track (juce::AudioFormatReader&); buffer to read into, a chunk long (juce::AudioBuffer<float>&); window length - in samples (int); function returning true if analysis should give up (const std::function<bool()>&) | outputs: first audible sample, -1 if there is none or analysis was stopped (juce::int64) */
+    static juce::int64 findFirstAudible(juce::AudioFormatReader& reader, juce::AudioBuffer<float>& chunk, int windowLength, const std::function<bool()>& shouldExit);
+    /** inputs: reader for the track (juce::AudioFormatReader&); buffer to read into, a chunk long (juce::AudioBuffer<float>&); window length - in samples (int); first audible sample, where the scan stops (juce::int64); function returning true if analysis should give up (const std::function<bool()>&) | outputs: last audible sample, -1 if analysis was stopped (juce::int64) */
+    static juce::int64 findLastAudible(juce::AudioFormatReader& reader, juce::AudioBuffer<float>& chunk, int windowLength, juce::int64 firstAudible, const std::function<bool()>& shouldExit);
+    /** inputs: chunk read (const juce::AudioBuffer<float>&); first sample of the window (int); length of the window (int) | outputs: mean power of the window over every channel (float) */
+    static float getPower(const juce::AudioBuffer<float>& chunk, int start, int num);
+    /** inputs: chunk read (const juce::AudioBuffer<float>&); sample (int) | outputs: highest magnitude of the sample on any channel (float) */
+    static float getMagnitude(const juce::AudioBuffer<float>& chunk, int sample);
+};
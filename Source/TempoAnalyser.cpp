@@ -0,0 +1,235 @@
+/*
+  ==============================================================================
+
+    TempoAnalyser.cpp
+    Created: 20 Oct 2026 5:03:27pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#include "TempoAnalyser.h"
+
+TempoAnalyser::TempoAnalyser(double _sampleRate, juce::int64 lengthInSamples)
+    : sampleRate(_sampleRate),
+    fft(fftOrder),
+    window(static_cast<size_t>(fftSize), juce::dsp::WindowingFunction<float>::hann, false),
+    fftData(static_cast<size_t>(fftSize * 2)),
+    previous(static_cast<size_t>(fftSize / 2 + 1), 0.0f)
+{
+    flux.reserve(static_cast<size_t>(juce::jmax(static_cast<juce::int64>(0), lengthInSamples) / hopSize + 1));
+}
+
+void TempoAnalyser::process(const juce::AudioBuffer<float>& block, int numSamples)
+{
+    constexpr int numBins = fftSize / 2 + 1;
+    if (numSamples <= 0 || block.getNumChannels() == 0)
+    {
+        return;
+    }
+    // mix down to mono - a beat is a beat in either channel
+    auto gain = 1.0f / block.getNumChannels();
+    auto offset = mono.size();
+    mono.resize(offset + static_cast<size_t>(numSamples));
+    juce::FloatVectorOperations::copyWithMultiply(mono.data() + offset, block.getReadPointer(0), gain, numSamples);
+    for (int chan = 1; chan < block.getNumChannels(); ++chan)
+    {
+        juce::FloatVectorOperations::addWithMultiply(mono.data() + offset, block.getReadPointer(chan), gain, numSamples);
+    }
+
+    size_t consumed = 0;
+    for (; consumed + fftSize <= mono.size(); consumed += hopSize)
+    {
+        std::copy(mono.begin() + static_cast<std::ptrdiff_t>(consumed),
+                  mono.begin() + static_cast<std::ptrdiff_t>(consumed + fftSize),
+                  fftData.begin());
+        window.multiplyWithWindowingTable(fftData.data(), static_cast<size_t>(fftSize));
+        fft.performFrequencyOnlyForwardTransform(fftData.data());
+        // log magnitudes, so quiet hi-hats count as well as loud kicks, then sum how much each bin rose
+        float rise = 0.0f;
+        for (size_t bin = 0; bin < static_cast<size_t>(numBins); ++bin)
+        {
+            auto magnitude = std::log1p(fftData[bin]);
+            rise += juce::jmax(0.0f, magnitude - previous[bin]);
+            previous[bin] = magnitude;
+        }
+        flux.push_back(rise);
+    }
+    // the rest waits for the next block to make up a frame
+    mono.erase(mono.begin(), mono.begin() + static_cast<std::ptrdiff_t>(consumed));
+}
+
+TempoAnalyser::Result TempoAnalyser::getResult() const
+{
+    Result result;
+    if (sampleRate <= 0.0)
+    {
+        return result;
+    }
+    auto envelope = getOnsetEnvelope();
+    auto framesPerSecond = sampleRate / hopSize;
+    // need a few bars at the slowest tempo to measure anything
+    if (envelope.size() < static_cast<size_t>(framesPerSecond * 60.0 / minBPM * 8.0))
+    {
+        return result;
+    }
+    auto period = estimatePeriod(envelope, framesPerSecond);
+    if (period <= 0.0)
+    {
+        return result;
+    }
+    // a strong kick on one and three can make a track look like half its tempo - if the beats in between are there too, take them
+    auto halfPeriod = period * 0.5;
+    if (60.0 * framesPerSecond / halfPeriod <= maxDoubledBPM
+        && getCombScore(envelope, findPhase(envelope, halfPeriod, 1.0), halfPeriod)
+           >= doubleTimeRatio * getCombScore(envelope, findPhase(envelope, period, 1.0), period))
+    {
+        period = halfPeriod;
+    }
+    period = refinePeriod(envelope, period);
+    auto phase = findPhase(envelope, period, 0.25);
+
+    // the downbeat is the beat of the bar whose every fourth beat hits hardest
+    int bestBeat = 0;
+    double bestScore = -1.0;
+    for (int beat = 0; beat < 4; ++beat)
+    {
+        auto score = getCombScore(envelope, phase + beat * period, period * 4.0);
+        if (score > bestScore)
+        {
+            bestScore = score;
+            bestBeat = beat;
+        }
+    }
+    // each frame's flux belongs to the middle of its window
+    auto firstBeatFrame = phase + bestBeat * period;
+    result.firstBeat = (firstBeatFrame * hopSize + fftSize / 2) / sampleRate;
+    result.bpm = 60.0 * framesPerSecond / period;
+    result.valid = true;
+    return result;
+}
+
+std::vector<float> TempoAnalyser::getOnsetEnvelope() const
+{
+    if (flux.empty())
+    {
+        return flux;
+    }
+
+    // take away the local average, about an eighth of a second either side, so only the peaks are left
+    constexpr size_t halfWidth = 12;
+    std::vector<double> runningTotal(flux.size() + 1, 0.0);
+    for (size_t i = 0; i < flux.size(); ++i)
+    {
+        runningTotal[i + 1] = runningTotal[i] + flux[i];
+    }
+    std::vector<float> envelope(flux.size());
+    for (size_t i = 0; i < flux.size(); ++i)
+    {
+        auto from = i > halfWidth ? i - halfWidth : 0;
+        auto to = juce::jmin(flux.size(), i + halfWidth + 1);
+        auto average = (runningTotal[to] - runningTotal[from]) / static_cast<double>(to - from);
+        envelope[i] = juce::jmax(0.0f, flux[i] - static_cast<float>(average));
+    }
+    return envelope;
+}
+
+double TempoAnalyser::estimatePeriod(const std::vector<float>& envelope, double framesPerSecond)
+{
+    auto minLag = static_cast<int>(std::floor(framesPerSecond * 60.0 / maxBPM));
+    auto maxLag = static_cast<int>(std::ceil(framesPerSecond * 60.0 / minBPM));
+    auto size = static_cast<int>(envelope.size());
+    if (minLag < 2 || maxLag + 1 >= size)
+    {
+        return 0.0;
+    }
+
+    std::vector<double> correlation(static_cast<size_t>(maxLag + 2), 0.0);
+    for (int lag = minLag - 1; lag <= maxLag + 1; ++lag)
+    {
+        auto numProducts = size - lag;
+        auto total = 0.0;
+        for (int i = 0; i < numProducts; ++i)
+        {
+            total += envelope[static_cast<size_t>(i)] * envelope[static_cast<size_t>(i + lag)];
+        }
+        correlation[static_cast<size_t>(lag)] = total / numProducts;
+    }
+
+    // favour tempos near 120, an octave away counting for about half, so double and half time lose to the tempo people dance to
+    int bestLag = 0;
+    double bestScore = 0.0;
+    for (int lag = minLag; lag <= maxLag; ++lag)
+    {
+        auto octavesFrom120 = std::log2(60.0 * framesPerSecond / lag / 120.0);
+        auto score = correlation[static_cast<size_t>(lag)] * std::exp(-0.5 * octavesFrom120 * octavesFrom120 / (0.9 * 0.9));
+        if (score > bestScore)
+        {
+            bestScore = score;
+            bestLag = lag;
+        }
+    }
+    if (bestLag == 0)
+    {
+        // silence
+        return 0.0;
+    }
+    // fit a parabola through the peak and its neighbours to place it between frames
+    auto before = correlation[static_cast<size_t>(bestLag - 1)];
+    auto peak = correlation[static_cast<size_t>(bestLag)];
+    auto after = correlation[static_cast<size_t>(bestLag + 1)];
+    auto curvature = before - 2.0 * peak + after;
+    auto shift = curvature < 0.0 ? juce::jlimit(-0.5, 0.5, 0.5 * (before - after) / curvature) : 0.0;
+    return bestLag + shift;
+}
+
+double TempoAnalyser::refinePeriod(const std::vector<float>& envelope, double period)
+{
+    // over a whole track even a small error in the period adds up to beats landing between the onsets, so try every period close by
+    constexpr int numSteps = 40;
+    constexpr double range = 0.01;
+    auto bestPeriod = period;
+    auto bestScore = -1.0;
+    for (int step = -numSteps; step <= numSteps; ++step)
+    {
+        auto candidate = period * (1.0 + range * step / numSteps);
+        auto score = getCombScore(envelope, findPhase(envelope, candidate, 1.0), candidate);
+        if (score > bestScore)
+        {
+            bestScore = score;
+            bestPeriod = candidate;
+        }
+    }
+    return bestPeriod;
+}
+
+double TempoAnalyser::findPhase(const std::vector<float>& envelope, double period, double step)
+{
+    auto bestPhase = 0.0;
+    auto bestScore = -1.0;
+    for (double phase = 0.0; phase < period; phase += step)
+    {
+        auto score = getCombScore(envelope, phase, period);
+        if (score > bestScore)
+        {
+            bestScore = score;
+            bestPhase = phase;
+        }
+    }
+    return bestPhase;
+}
+
+double TempoAnalyser::getCombScore(const std::vector<float>& envelope, double first, double step)
+{
+    auto last = static_cast<double>(envelope.size() - 1);
+    auto total = 0.0;
+    int count = 0;
+    for (auto position = first; position < last; position += step, ++count)
+    {
+        // between frames, blend the two either side
+        auto index = static_cast<size_t>(position);
+        auto fraction = static_cast<float>(position - index);
+        total += envelope[index] + fraction * (envelope[index + 1] - envelope[index]);
+    }
+    return count > 0 ? total / count : 0.0;
+}
@@ -0,0 +1,82 @@
+/*
+  ==============================================================================
+
+    TempoAnalyser.h
+    Created: 20 Oct 2026 5:03:27pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+/** finds a track's tempo and beat grid from its audio.
+ the track is fed in block by block, from the one pass that decodes it for every analysis that needs all of it, and turned into an onset envelope -
+ the spectral flux, how much louder each frequency got from one short frame to the next.
+ the envelope's autocorrelation, weighted towards the tempos dance music sits at, gives the beat period to within a frame,
+ which is then refined against the whole track so a grid laid from the first beat still lands on the beats minutes later.
+ the first downbeat is the beat, of the first four, whose every fourth beat after it hits hardest */
+class TempoAnalyser
+{
+public:
+    /** what the analysis found */
+    struct Result
+    {
+        /** false if the file could not be read, was too short or analysis was stopped */
+        bool valid = false;
+        /** tempo - in beats per minute */
+        double bpm = 0.0;
+        /** first downbeat - in seconds from the start of the track */
+        double firstBeat = 0.0;
+    };
+
+    /** inputs: sample rate of the track (double); length of the track, to size the envelope up front - in samples (juce::int64)
+     constructor */
+    TempoAnalyser(double _sampleRate, juce::int64 lengthInSamples);
+    /** inputs: the next block of the track, in order from the start - every channel is mixed down (const juce::AudioBuffer<float>&); number of samples in the block (int)
+     adds the block to the onset envelope */
+    void process(const juce::AudioBuffer<float>& block, int numSamples);
+    /** outputs: tempo and first downbeat (Result)
+     call once the whole track has been processed */
+    Result getResult() const;
+
+    /** slowest and fastest tempos reported */
+    static constexpr double minBPM = 60.0;
+    static constexpr double maxBPM = 200.0;
+    /** a tempo found at half speed is doubled, up to this tempo, if the beats in between hit at least this hard, relative to the beats found */
+    static constexpr double maxDoubledBPM = 185.0;
+    static constexpr double doubleTimeRatio = 0.6;
+    /** frames the onset envelope is measured over - in samples */
+    static constexpr int fftOrder = 10;
+    static constexpr int fftSize = 1 << fftOrder;
+    /** samples between frames */
+    static constexpr int hopSize = fftSize / 2;
+
+private:
+    /** outputs: spectral flux of each frame processed, local average removed (std::vector<float>) */
+    std::vector<float> getOnsetEnvelope() const;
+    /** inputs: onset envelope (const std::vector<float>&); frames per second (double) | outputs: beat period to a fraction of a frame, 0 if none was found - in frames (double) */
+    static double estimatePeriod(const std::vector<float>& envelope, double framesPerSecond);
+    /** inputs: onset envelope (const std::vector<float>&); beat period from estimatePeriod - in frames (double) | outputs: the period within 1% of it that lines up best over the whole track - in frames (double) */
+    static double refinePeriod(const std::vector<float>& envelope, double period);
+    /** inputs: onset envelope (const std::vector<float>&); beat period - in frames (double); step between phases tried - in frames (double) | outputs: offset of the first beat within the first period - in frames (double) */
+    static double findPhase(const std::vector<float>& envelope, double period, double step);
+    /** inputs: onset envelope (const std::vector<float>&); first beat - in frames (double); step between beats summed - in frames (double) | outputs: average onset strength on those beats (double) */
+    static double getCombScore(const std::vector<float>& envelope, double first, double step);
+
+    double sampleRate;
+    juce::dsp::FFT fft;
+    juce::dsp::WindowingFunction<float> window;
+    /** mixed down samples not yet taken up by a whole frame */
+    std::vector<float> mono;
+    std::vector<float> fftData;
+    /** log magnitudes of the last frame */
+    std::vector<float> previous;
+    /** spectral flux of each frame so far */
+    std::vector<float> flux;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TempoAnalyser)
+};
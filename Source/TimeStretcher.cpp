@@ -0,0 +1,250 @@
+/*
+  ==============================================================================
+
+    TimeStretcher.cpp
+    Created: 18 Oct 2026 6:12:45pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#include "TimeStretcher.h"
+#include "DSPKernels.h"
+#include <limits>
+
+namespace
+{
+    /** enough input for a grain, the search range either side of it and the fastest tempo's hop, with room to spare */
+    constexpr int inputCapacity = TimeStretcher::frameSize * 8;
+}
+
+TimeStretcher::TimeStretcher(juce::AudioSource* inputSource, bool deleteInputWhenDeleted)
+    : input(inputSource, deleteInputWhenDeleted)
+{
+    jassert(input != nullptr);
+}
+
+TimeStretcher::~TimeStretcher()
+{
+}
+
+void TimeStretcher::setTempoRatio(double inputSamplesPerOutputSample)
+{
+    // setter for tempo
+    tempoRatio = juce::jlimit(minTempoRatio, maxTempoRatio, inputSamplesPerOutputSample);
+}
+
+void TimeStretcher::setEnabled(bool shouldBeEnabled)
+{
+    // setter for stretching on or off
+    enabled = shouldBeEnabled;
+}
+
+bool TimeStretcher::isEnabled() const
+{
+    return enabled;
+}
+
+double TimeStretcher::getBufferedInputSamples() const
+{
+    if (!enabled || needsReset || isFirstFrame)
+    {
+        return 0.0;
+    }
+    // the next output sample is part way through the last grain, which nominally began one hop of input before the next
+    auto playing = nominalPosition - tempoRatio * (hopSize - readyOffset);
+    return static_cast<double>(inputStart + inputValid) - playing;
+}
+
+double TimeStretcher::getLatencySamples() const
+{
+    return getBufferedInputSamples() / getTempoRatio();
+}
+
+double TimeStretcher::getTempoRatio() const
+{
+    return enabled ? tempoRatio : 1.0;
+}
+
+void TimeStretcher::flushBuffers()
+{
+    needsReset = true;
+}
+
+void TimeStretcher::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    // allocate everything up front, nothing is allocated once audio is running
+    inputBuffer.setSize(2, inputCapacity);
+    inputMid.allocate(inputCapacity, true);
+    accumulator.setSize(2, frameSize);
+    window.allocate(frameSize, true);
+    // periodic Hann window, sums to exactly one when overlapped by half
+    for (int i = 0; i < frameSize; ++i)
+    {
+        window[i] = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * i / frameSize);
+    }
+    reset();
+    input->prepareToPlay(samplesPerBlockExpected, sampleRate);
+}
+
+void TimeStretcher::releaseResources()
+{
+    input->releaseResources();
+}
+
+void TimeStretcher::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    if (!enabled)
+    {
+        // pass straight through, and start afresh whenever stretching is turned back on
+        input->getNextAudioBlock(bufferToFill);
+        needsReset = true;
+        return;
+    }
+    if (needsReset)
+    {
+        reset();
+    }
+
+    int done = 0;
+    while (done < bufferToFill.numSamples)
+    {
+        if (readyAvailable == 0)
+        {
+            synthesiseFrame();
+        }
+        // hand over as much finished output as fits in the block
+        auto numToCopy = juce::jmin(readyAvailable, bufferToFill.numSamples - done);
+        for (int chan = 0; chan < bufferToFill.buffer->getNumChannels(); ++chan)
+        {
+            bufferToFill.buffer->copyFrom(chan, bufferToFill.startSample + done,
+                                          accumulator, juce::jmin(chan, 1), readyOffset,
+                                          numToCopy);
+        }
+        readyOffset += numToCopy;
+        readyAvailable -= numToCopy;
+        done += numToCopy;
+    }
+}
+
+void TimeStretcher::reset()
+{
+    accumulator.clear();
+    inputStart = 0;
+    inputValid = 0;
+    readyOffset = 0;
+    readyAvailable = 0;
+    nominalPosition = 0.0;
+    previousFrameStart = 0;
+    isFirstFrame = true;
+    needsReset = false;
+}
+
+void TimeStretcher::synthesiseFrame()
+{
+    auto nominal = static_cast<juce::int64>(std::llround(nominalPosition));
+    juce::int64 frameStart;
+
+    if (isFirstFrame)
+    {
+        // nothing to line up with yet, take the grain from where it belongs
+        ensureInput(nominal, nominal + frameSize);
+        frameStart = nominal;
+        isFirstFrame = false;
+    }
+    else {
+        // slide the finished half out of the accumulator to make room for the next grain
+        for (int chan = 0; chan < 2; ++chan)
+        {
+            auto* acc = accumulator.getWritePointer(chan);
+            std::memmove(acc, acc + hopSize, sizeof(float) * (frameSize - hopSize));
+        }
+        accumulator.clear(frameSize - hopSize, hopSize);
+        // keep what the search can reach and the waveform the last grain would have carried on into
+        auto naturalContinuation = previousFrameStart + hopSize;
+        ensureInput(juce::jmin(naturalContinuation, nominal - searchRadius),
+                    juce::jmax(nominal + searchRadius + frameSize, naturalContinuation + correlationLength));
+        frameStart = findBestMatch(naturalContinuation, nominal);
+    }
+
+    // overlap-add the windowed grain
+    for (int chan = 0; chan < 2; ++chan)
+    {
+        juce::FloatVectorOperations::addWithMultiply(accumulator.getWritePointer(chan),
+                                                     inputBuffer.getReadPointer(chan, static_cast<int>(frameStart - inputStart)),
+                                                     window.get(),
+                                                     frameSize);
+    }
+    previousFrameStart = frameStart;
+    // the input moves on at the tempo ratio while the output always moves on one hop
+    nominalPosition += tempoRatio * hopSize;
+    readyOffset = 0;
+    readyAvailable = hopSize;
+}
+
+void TimeStretcher::ensureInput(juce::int64 keepFrom, juce::int64 needUpTo)
+{
+    // drop input nothing can reach any more
+    auto numToDrop = static_cast<int>(juce::jlimit(static_cast<juce::int64>(0),
+                                                   static_cast<juce::int64>(inputValid),
+                                                   keepFrom - inputStart));
+    if (numToDrop > 0)
+    {
+        for (int chan = 0; chan < 2; ++chan)
+        {
+            auto* samples = inputBuffer.getWritePointer(chan);
+            std::memmove(samples, samples + numToDrop, sizeof(float) * static_cast<size_t>(inputValid - numToDrop));
+        }
+        std::memmove(inputMid.get(), inputMid.get() + numToDrop, sizeof(float) * static_cast<size_t>(inputValid - numToDrop));
+        inputStart += numToDrop;
+        inputValid -= numToDrop;
+    }
+
+    // pull in whatever is still missing
+    auto numToRead = static_cast<int>(juce::jmin(needUpTo - (inputStart + inputValid),
+                                                 static_cast<juce::int64>(inputCapacity - inputValid)));
+    if (numToRead > 0)
+    {
+        juce::AudioSourceChannelInfo info(&inputBuffer, inputValid, numToRead);
+        input->getNextAudioBlock(info);
+        // the search compares a mono mix, so stereo material lines up on both sides at once
+        auto* mid = inputMid.get() + inputValid;
+        juce::FloatVectorOperations::copy(mid, inputBuffer.getReadPointer(0, inputValid), numToRead);
+        juce::FloatVectorOperations::add(mid, inputBuffer.getReadPointer(1, inputValid), numToRead);
+        inputValid += numToRead;
+    }
+
+    // the grain may have jumped past everything that was buffered, drop that too
+    if (keepFrom > inputStart)
+    {
+        ensureInput(keepFrom, needUpTo);
+    }
+}
+
+juce::int64 TimeStretcher::findBestMatch(juce::int64 naturalContinuation, juce::int64 nominal)
+{
+    const float* reference = inputMid.get() + (naturalContinuation - inputStart);
+    auto best = juce::jmax(nominal, inputStart);
+    auto bestScore = -std::numeric_limits<float>::max();
+
+    for (int i = 0; i < searchPositions; ++i)
+    {
+        // every other sample from one end of the search range to the other
+        auto candidate = nominal - searchRadius + 2 * i;
+        if (candidate < inputStart)
+        {
+            continue;
+        }
+        // normalised cross-correlation, so loud passages don't win just for being loud
+        const float* samples = inputMid.get() + (candidate - inputStart);
+        auto correlation = DSPKernels::dotProduct(samples, reference, correlationLength);
+        auto energy = DSPKernels::dotProduct(samples, samples, correlationLength);
+        auto score = correlation / std::sqrt(energy + 1.0e-9f);
+        if (score > bestScore)
+        {
+            bestScore = score;
+            best = candidate;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+
+    TimeStretcher.h
+    Created: 18 Oct 2026 6:12:45pm
+    Author:  Zac Bolton
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+/** real-time WSOLA (waveform similarity overlap-add) time-stretcher used for key-lock.
+ changes tempo without changing pitch by overlap-adding 50% overlapped Hann-windowed grains, each one taken
+ from wherever in a small search range around its nominal input position best lines up with the last grain.
+
+ everything is allocated in prepareToPlay. the work per output sample is fixed and does not depend on the tempo:
+ two channels of windowed overlap-add plus the similarity search, which scores searchPositions candidates with two
+ dot products of correlationLength samples once every hopSize outputs - around 200 multiply-adds per output sample */
+class TimeStretcher : public juce::AudioSource
+{
+public:
+    /** inputs: pointer to the source to be stretched (juce::AudioSource*); flag stating if the source should be deleted along with this object (bool)
+     constructor */
+    TimeStretcher(juce::AudioSource* inputSource, bool deleteInputWhenDeleted);
+    /**
+     destructor */
+    ~TimeStretcher() override;
+    /** inputs: number of input samples consumed per output sample, with 1.0 being no change (double)
+     held between minTempoRatio and maxTempoRatio - audio thread only */
+    void setTempoRatio(double inputSamplesPerOutputSample);
+    /** inputs: flag stating if stretching should be applied (bool)
+     when disabled audio passes straight through at no cost - audio thread only */
+    void setEnabled(bool shouldBeEnabled);
+    /** outputs: flag stating if stretching is applied (bool) */
+    bool isEnabled() const;
+    /** outputs: input pulled from the source but not yet played, roughly, as grains are taken from wherever lines up best - in input samples (double)
+     audio thread only */
+    double getBufferedInputSamples() const;
+    /** outputs: delay from a sample going in to it coming out, 0 when disabled - in output samples (double)
+     audio thread only */
+    double getLatencySamples() const;
+    /** outputs: input samples consumed per output sample, 1 when disabled (double) */
+    double getTempoRatio() const;
+    /** drops the input and grains held, so the next block starts fresh from wherever the source reads next - audio thread only */
+    void flushBuffers();
+    /** inputs: expected number of samples per audio block [buffer] (int); sample rate the output will be used at (double)
+     From https://docs.juce.com/master/classAudioSource.html "Tells the source to prepare for playing." */
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    /**
+     From https://docs.juce.com/master/classAudioSource.html "Allows the source to release anything it no longer needs after playback has stopped." */
+    void releaseResources() override;
+    /** inputs: reference to the target channel buffer (juce::AudioSourceChannelInfo&)
+     From https://docs.juce.com/master/classAudioSource.html "Called repeatedly to fetch subsequent blocks of audio data." */
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+
+    /** length of each grain - in samples */
+    static constexpr int frameSize = 1024;
+    /** output samples between grains, half a grain so Hann windows sum to one */
+    static constexpr int hopSize = frameSize / 2;
+    /** how far either side of the nominal position a grain may be taken from - in samples */
+    static constexpr int searchRadius = 192;
+    /** candidate positions scored per grain, every other sample across the search range */
+    static constexpr int searchPositions = searchRadius + 1;
+    /** number of samples compared for each candidate */
+    static constexpr int correlationLength = 256;
+    /** slowest tempo supported - any slower and a grain would take longer to play than the window it overlaps */
+    static constexpr double minTempoRatio = 0.05;
+    /** fastest tempo supported */
+    static constexpr double maxTempoRatio = 4.0;
+
+private:
+    /** clears all state, so the next grain starts at the current input position */
+    void reset();
+    /** overlap-adds one more grain and makes hopSize more samples ready for output */
+    void synthesiseFrame();
+    /** inputs: absolute index of the first input sample that must be kept (juce::int64); absolute index one past the last input sample needed (juce::int64)
+     pulls input up to the given index and drops input before the other */
+    void ensureInput(juce::int64 keepFrom, juce::int64 needUpTo);
+    /** inputs: absolute index of the grain the next one must follow on from (juce::int64); absolute index of where the next grain should nominally start (juce::int64) | outputs: absolute index the next grain should actually start at (juce::int64)
+     finds the candidate within the search range whose waveform best continues the last grain */
+    juce::int64 findBestMatch(juce::int64 naturalContinuation, juce::int64 nominal);
+
+    juce::OptionalScopedPointer<juce::AudioSource> input;
+    bool enabled = false;
+    bool needsReset = true;
+    double tempoRatio = 1.0;
+
+    juce::AudioBuffer<float> inputBuffer;
+    juce::HeapBlock<float> inputMid;
+    juce::int64 inputStart = 0;
+    int inputValid = 0;
+
+    juce::HeapBlock<float> window;
+    juce::AudioBuffer<float> accumulator;
+    int readyOffset = 0;
+    int readyAvailable = 0;
+
+    double nominalPosition = 0.0;
+    juce::int64 previousFrameStart = 0;
+    bool isFirstFrame = true;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TimeStretcher)
+};
@@ -17,6 +17,8 @@ Track::Track(juce::String _name,
     length(_length),
     url(_url)
 {
+    // no cues until some are set
+    hotCues.insertMultiple(0, -1.0, numHotCues);
 }
 
 Track::~Track()
@@ -47,3 +49,94 @@ bool Track::isResultOfSearch()
 {
     return searchResult;
 }
+
+void Track::setSeekIndex(std::shared_ptr<const SeekIndex> index)
+{
+    seekIndex = index;
+}
+
+std::shared_ptr<const SeekIndex> Track::getSeekIndex()
+{
+    return seekIndex;
+}
+
+void Track::setHotCue(int index, double seconds)
+{
+    if (index >= 0 && index < numHotCues)
+    {
+        hotCues.set(index, seconds >= 0.0 ? seconds : -1.0);
+    }
+}
+
+juce::Array<double> Track::getHotCues()
+{
+    return hotCues;
+}
+
+void Track::setBeatGrid(double _bpm, double _firstBeat)
+{
+    bpm = _bpm;
+    firstBeat = _firstBeat;
+}
+
+double Track::getBPM()
+{
+    return bpm;
+}
+
+double Track::getFirstBeat()
+{
+    return firstBeat;
+}
+
+void Track::setKey(juce::String camelotKey)
+{
+    key = camelotKey;
+}
+
+juce::String Track::getKey()
+{
+    return key;
+}
+
+void Track::setLoudness(double _loudness, double _truePeak)
+{
+    loudness = _loudness;
+    truePeak = _truePeak;
+}
+
+double Track::getLoudness()
+{
+    return loudness;
+}
+
+double Track::getTruePeak()
+{
+    return truePeak;
+}
+
+void Track::setCuePoints(double _cueIn, double _cueOut)
+{
+    cueIn = _cueIn;
+    cueOut = _cueOut;
+}
+
+double Track::getCueIn()
+{
+    return cueIn;
+}
+
+double Track::getCueOut()
+{
+    return cueOut;
+}
+
+void Track::markAnalysed(int analyses)
+{
+    analysed |= analyses;
+}
+
+int Track::getAnalysed()
+{
+    return analysed;
+}
@@ -12,6 +12,8 @@
 
 #include <JuceHeader.h>
 #include <vector>
+#include <memory>
+#include "SeekIndex.h"
 
 class Track {
 public:
@@ -38,10 +40,63 @@ public:
      returns whether or not this track is part of a
      current search query */
     bool isResultOfSearch();
+    /** inputs: seek index of the track's file (std::shared_ptr<const SeekIndex>)
+     set once the index has been built, or read back from the library */
+    void setSeekIndex(std::shared_ptr<const SeekIndex> index);
+    /** outputs: seek index of the track's file, nullptr if there is none yet (std::shared_ptr<const SeekIndex>) */
+    std::shared_ptr<const SeekIndex> getSeekIndex();
+    /** inputs: index of the cue, from 0 (int); position of the cue, -1 to clear it - in seconds (double)
+     set from a deck, or read back from the library */
+    void setHotCue(int index, double seconds);
+    /** outputs: every hot cue of the track, -1 for those not set - in seconds (juce::Array<double>) */
+    juce::Array<double> getHotCues();
+    /** inputs: tempo - in beats per minute (double); first downbeat - in seconds (double)
+     set once the track has been analysed, or read back from the library */
+    void setBeatGrid(double bpm, double firstBeat);
+    /** outputs: tempo - in beats per minute, 0 if the track has not been analysed yet (double) */
+    double getBPM();
+    /** outputs: first downbeat - in seconds (double) */
+    double getFirstBeat();
+    /** inputs: musical key in Camelot notation, e.g. "8A" (juce::String)
+     set once the track has been analysed, or read back from the library */
+    void setKey(juce::String camelotKey);
+    /** outputs: musical key in Camelot notation, empty if the track has not been analysed yet (juce::String) */
+    juce::String getKey();
+    /** inputs: integrated loudness - in LUFS (double); true peak - in dBTP (double)
+     set once the track has been analysed, or read back from the library */
+    void setLoudness(double loudness, double truePeak);
+    /** outputs: integrated loudness - in LUFS, 0 if the track has not been analysed yet (double) */
+    double getLoudness();
+    /** outputs: true peak - in dBTP (double) */
+    double getTruePeak();
+    /** inputs: first audible moment - in seconds (double); end of the last audible moment - in seconds (double)
+     set once the track has been analysed, or read back from the library - decks start the track at the cue in */
+    void setCuePoints(double cueIn, double cueOut);
+    /** outputs: first audible moment - in seconds (double) */
+    double getCueIn();
+    /** outputs: end of the last audible moment - in seconds, 0 if the track has not been analysed yet (double) */
+    double getCueOut();
+    /** inputs: analyses that ran to the end, PlaylistComponent::AnalysisFlags combined (int)
+     added to those already run, whether or not they found anything - so a track with no beat, say, is not analysed again every launch */
+    void markAnalysed(int analyses);
+    /** outputs: every analysis that has run to the end on the track, PlaylistComponent::AnalysisFlags combined (int) */
+    int getAnalysed();
+    /** number of hot cues per track */
+    static constexpr int numHotCues = 8;
     
 private:
     juce::String name;
     juce::String length;
     juce::URL url;
     bool searchResult = true;
+    std::shared_ptr<const SeekIndex> seekIndex;
+    juce::Array<double> hotCues;
+    double bpm = 0.0;
+    double firstBeat = 0.0;
+    juce::String key;
+    double loudness = 0.0;
+    double truePeak = 0.0;
+    double cueIn = 0.0;
+    double cueOut = 0.0;
+    int analysed = 0;
 };